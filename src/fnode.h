@@ -66,6 +66,8 @@
 //----------------------------------------------------------------------------------
 #define     MAX_INPUTS                  4                       // Max number of inputs in every node
 #define     MAX_VALUES                  16                      // Max number of values in every output
+#define     MAX_FUNCTION_NODES          32                      // Max number of nodes in a function body (including its inputs)
+#define     MAX_FUNCTION_NAME           16                      // Max function name length
 
 //----------------------------------------------------------------------------------
 // Enums Definition
@@ -125,14 +127,54 @@ typedef enum {
     FNODE_HALFDIRECTION,
     FNODE_SAMPLER2D,
     FNODE_VERTEX,
-    FNODE_FRAGMENT
+    FNODE_FRAGMENT,
+    FNODE_LUT,
+    FNODE_OPTIONAL,
+    FNODE_FUNCTION,
+    FNODE_SAMPLERLOD,
+    FNODE_SAMPLERBIAS,
+    FNODE_SAMPLERGRAD
 } FNodeType;
 
 typedef enum {
     GLSL_330,
-    GLSL_100
+    GLSL_100,
+    GLSL_430,
+    GLSL_300ES
 } ShaderVersion;
 
+typedef enum {
+    COMPILE_AUTHORING,
+    COMPILE_SHIP
+} CompileMode;
+
+typedef enum {
+    PRECISION_AUTO,
+    PRECISION_LOWP,
+    PRECISION_MEDIUMP,
+    PRECISION_HIGHP
+} Precision;
+
+typedef enum {
+    PACKING_NONE,
+    PACKING_ATLAS,
+    PACKING_ARRAY
+} TexturePacking;
+
+typedef enum {
+    STAGE_NONE = -1,
+    STAGE_UNIFORM,
+    STAGE_VERTEX,
+    STAGE_FRAGMENT
+} ShaderStage;
+
+typedef enum {
+    VARIABLE_ATTRIBUTE,
+    VARIABLE_VARYING,
+    VARIABLE_UNIFORM,
+    VARIABLE_SAMPLER
+} VariableKind;
+
 typedef enum {
     BUTTON_DEFAULT,
     BUTTON_HOVER,
@@ -156,6 +198,24 @@ typedef struct Vector4 {
     float w;
 } Vector4;
 
+typedef struct ShaderCost {
+    int alu;                                // Arithmetic instructions count
+    int transcendental;                     // Transcendental instructions count (special function unit)
+    int texture;                            // Texture fetches count
+    int discard;                            // Fragment discards count
+} ShaderCost;
+
+typedef struct ShaderVariable {
+    VariableKind kind;                      // Variable kind (attribute, varying, uniform or sampler)
+    char name[32];                          // Variable name in shader code
+    char type[16];                          // Variable GLSL data type name
+    char block[16];                         // Uniform block name (empty for default block uniforms)
+    int binding;                            // Attribute location, sampler texture unit or uniform block member offset (-1 if assigned when linking)
+    bool vertex;                            // Variable is declared in vertex shader
+    bool fragment;                          // Variable is declared in fragment shader
+    bool flat;                              // Varying is not interpolated
+} ShaderVariable;
+
 typedef struct FNodeValue {
     float value;                            // Output data value
     Rectangle shape;                        // Output data shape
@@ -175,6 +235,9 @@ typedef struct FNodeData {
     unsigned int inputsCount;               // Inputs node ids array length
     unsigned int inputsLimit;               // Inputs node ids length limit
     bool property;                          // Node is property state
+    bool staticProperty;                    // Node is static property state (compiled as shader permutations instead of uniform)
+    bool instanceProperty;                  // Node is per instance property state (compiled as instance attribute when instancing)
+    int function;                           // Library function index called by function nodes (-1 for other nodes)
     FNodeOutput output;                     // Value output (contains the value and its length)
     Rectangle shape;                        // Node rectangle data
     Rectangle inputShape;                   // Node input rectangle data (automatically calculated from shape)
@@ -202,6 +265,18 @@ typedef struct FCommentData {
     Rectangle sizeBrShape;                  // Comment bottom-right size edit rectangle data
 } FCommentData, *FComment;
 
+typedef struct FFunctionData {
+    char name[MAX_FUNCTION_NAME];           // Function name (generated GLSL function is prefixed with fn_)
+    int inputsCount;                        // Function declared inputs count (first nodes of function body)
+    int nodesCount;                         // Function body nodes count (last node is the function output)
+    FNode nodes[MAX_FUNCTION_NODES];        // Function body nodes pool in evaluation order
+    int linesCount;                         // Function body lines count
+    FLine lines[MAX_FUNCTION_NODES*MAX_INPUTS]; // Function body lines pool
+    char *source;                           // Function GLSL code generated once when function is loaded
+    ShaderCost cost;                        // Function body operations cost
+    bool exact;                             // Function body operations are calculated in CPU as in GLSL
+} FFunctionData, *FFunction;
+
 //------------------------------------------------------------------------------------
 // FNode Functions Declaration
 //------------------------------------------------------------------------------------
@@ -217,6 +292,7 @@ FNODEDEF FNode CreateNodeOperator(FNodeType type, const char *name, int inputs);
 FNODEDEF FNode CreateNodeUniform(FNodeType type, const char *name, int dataCount);   // Creates an uniform node with type name and data count as parameters
 FNODEDEF FNode CreateNodeProperty(FNodeType type, const char *name, int dataCount, int inputs);  // Creates a property node with type name and data count as parameters
 FNODEDEF FNode CreateNodeMaterial(FNodeType type, const char *name, int dataCount);  // Creates the main node that contains final fragment color
+FNODEDEF FNode CreateNodeFunction(int function);                                     // Creates a node which calls a library function with its declared inputs
 FNODEDEF FNode InitializeNode(bool isOperator);                                      // Initializes a new node with generic parameters
 FNODEDEF int GetNodeIndex(int id);                                                   // Returns the index of a node searching by its id
 FNODEDEF FLine CreateNodeLine();                                                     // Creates a line between two nodes
@@ -227,6 +303,10 @@ FNODEDEF void UpdateCommentShapes(FComment comment);
 FNODEDEF Vector2 CameraToViewVector2(Vector2 vector, Camera2D camera);               // Converts Vector2 coordinates from world space to Camera2D space based on its offset
 FNODEDEF Rectangle CameraToViewRec(Rectangle rec, Camera2D camera);                  // Converts rectangle coordinates from world space to Camera2D space based on its offset
 FNODEDEF void CalculateValues();                                                     // Calculates nodes output values based on current inputs
+FNODEDEF void CalculateNodeValues(FNode node);                                       // Calculates a specific node output values based on its current inputs
+FNODEDEF void CalculateFunctionValues(FNode node);                                   // Calculates a function node output values evaluating its library function body
+FNODEDEF void BeginFunctionBody(FFunction function);                                 // Replaces graph nodes and lines pools by a function body pools
+FNODEDEF void EndFunctionBody();                                                     // Stores current pools as function body pools and restores graph nodes and lines pools
 FNODEDEF void DrawNode(FNode node);                                                  // Draws a previously created node
 FNODEDEF void DrawNodeLine(FLine line);                                              // Draws a previously created node line
 FNODEDEF void DrawComment(FComment comment);                                         // Draws a previously created comment
@@ -235,6 +315,7 @@ FNODEDEF bool FToggle(Rectangle bounds, bool toggle);
 FNODEDEF void DestroyNode(FNode node);                                               // Destroys a node and its linked lines
 FNODEDEF void DestroyNodeLine(FLine line);                                           // Destroys a node line
 FNODEDEF void DestroyComment(FComment comment);                                      // Destroys a comment
+FNODEDEF void DestroyFunction(FFunction function);                                   // Destroys a library function with its body nodes, lines and source
 FNODEDEF void CloseFNode();                                                          // Unitializes FNode global variables
 FNODEDEF void TraceLogFNode(bool error, const char *text, ...);                      // Outputs a trace log message
 FNODEDEF void SetLineWidth(float width);                                             // Sets GL state machine line width
@@ -262,6 +343,7 @@ FNODEDEF int FSearch(char *filename, char *string);
 #include <string.h>             // Required for: strcat(), strstr()
 #include <math.h>               // Required for: fabs(), sqrt(), sinf(), cosf(), cos(), sin(), tan(), pow(), floor()
 #include <stdarg.h>             // Required for: va_list, va_start(), vfprintf(), va_end()
+#include <ctype.h>              // Required for: isalnum(), isalpha()
 #include "external/glad.h"      // Required for GLAD extensions loading library, includes OpenGL headers
 
 //----------------------------------------------------------------------------------
@@ -272,6 +354,7 @@ FNODEDEF int FSearch(char *filename, char *string);
 #define     MAX_LINES                   512                     // Max number of lines (8 lines for each node)
 #define     MAX_COMMENTS                16                      // Max number of comments
 #define     MAX_COMMENT_LENGTH          20                      // Max comment value text length
+#define     MAX_FUNCTIONS               16                      // Max number of library functions
 #define     MIN_COMMENT_SIZE            75                      // Min comment width and height values
 #define     NODE_LINE_DIVISIONS         20                      // Node curved line divisions
 #define     NODE_DATA_WIDTH             30                      // Node data text width
@@ -301,6 +384,7 @@ int selectedNode = -1;                      // Current selected node to drag in
 int editNode = -1;                          // Current edited node data
 int editNodeType = -1;                      // Current edited node data index
 char *editNodeText = NULL;                  // Current edited node data value text before any changes
+int changedNode = -1;                       // Last edited node id whose values need to be sent to the shader
 
 int linesCount = 0;                         // Created lines count
 FLine lines[MAX_LINES];                     // Lines pointers pool
@@ -309,6 +393,7 @@ FLine tempLine = NULL;                      // Temporally created line during li
 
 int commentsCount = 0;                      // Created comments count
 FComment comments[MAX_COMMENTS];            // Comments pointers pool
+
 int commentState = 0;                       // Current comment creation state (0 = waiting to create, 1 = waiting to finish creation)
 int selectedComment = -1;                   // Current selected comment to drag in canvas
 int editSize = -1;                          // Current edited comment
@@ -318,6 +403,15 @@ int selectedCommentNodes[MAX_NODES];        // Current selected comment nodes id
 int selectedCommentNodesCount;              // Current selected comment nodes ids list count
 FComment tempComment = NULL;                // Temporally created comment during comment states
 Vector2 tempCommentPos = { 0, 0 };          // Temporally created comment start position
+
+int functionsCount = 0;                     // Loaded library functions count
+FFunction functions[MAX_FUNCTIONS];         // Library functions pointers pool
+FFunction bodyFunction = NULL;              // Function whose body pools replace graph pools
+FNode graphNodes[MAX_NODES];                // Graph nodes pool saved while a function body is evaluated
+int graphNodesCount = 0;                    // Graph nodes count saved while a function body is evaluated
+FLine graphLines[MAX_LINES];                // Graph lines pool saved while a function body is evaluated
+int graphLinesCount = 0;                    // Graph lines count saved while a function body is evaluated
+
 Vector2 screenSize = { 1280, 720 };         // Window screen width
 Camera2D camera;                            // Node area 2d camera for panning
 Camera camera3d;                            // Visor camera 3d for model and shader visualization
@@ -349,6 +443,7 @@ static Matrix FMatrixMultiply(Matrix left, Matrix right);                  // Re
 static Matrix FMatrixTranslate(float x, float y, float z);                 // Returns translation matrix
 static Matrix FMatrixRotate(Vector3 axis, float angle);                    // Create rotation matrix from axis and angle provided in radians
 static Matrix FMatrixScale(float x, float y, float z);                     // Returns scaling matrix
+static Matrix FMatrixFrustum(double left, double right, double bottom, double top, double near, double far); // Returns perspective projection matrix
 static void FMatrixTranspose(Matrix *mat);                                 // Transposes provided matrix
 static void FMultiplyMatrixVector(Vector4 *v, Matrix mat);                 // Transform a quaternion given a transformation matrix
 static float FCos(float value);                                            // Returns the cosine value of a radian angle
@@ -381,6 +476,7 @@ FNODEDEF void InitFNode()
     nodesCount = 0;
     linesCount = 0;
     commentsCount = 0;
+    functionsCount = 0;
     selectedCommentNodesCount = 0;
     for (int i = 0; i < MAX_NODES; i++) selectedCommentNodes[i] = -1;
 
@@ -594,6 +690,21 @@ FNODEDEF FNode CreateNodeMaterial(FNodeType type, const char *name, int dataCoun
     return newNode;
 }
 
+// Creates a node which calls a library function with its declared inputs
+FNODEDEF FNode CreateNodeFunction(int function)
+{
+    FNode newNode = InitializeNode(true);
+
+    newNode->type = FNODE_FUNCTION;
+    newNode->name = functions[function]->name;
+    newNode->function = function;
+    newNode->inputsLimit = functions[function]->inputsCount;
+
+    UpdateNodeShapes(newNode);
+
+    return newNode;
+}
+
 // Initializes a new node with generic parameters
 FNODEDEF FNode InitializeNode(bool isOperator)
 {
@@ -632,6 +743,9 @@ FNODEDEF FNode InitializeNode(bool isOperator)
     newNode->inputsCount = 0;
     newNode->inputsLimit = MAX_INPUTS;
     newNode->property = false;
+    newNode->staticProperty = false;
+    newNode->instanceProperty = false;
+    newNode->function = -1;
 
     // Initialize shapes
     newNode->shape = (Rectangle){ GetRandomValue(-camera.offset.x + 0, -camera.offset.x + screenSize.x*0.85f - 50*4), GetRandomValue(-camera.offset.y + screenSize.y/2 - 20 - 100, camera.offset.y + screenSize.y/2 - 20 + 100), 10 + NODE_DATA_WIDTH, 40 };
@@ -938,777 +1052,864 @@ FNODEDEF void CalculateValues()
 {
     for (int i = 0; i < nodesCount; i++)
     {
-        if (nodes[i] != NULL)
-        {
-            // Reset node inputs values and inputs count
-            for (int k = 0; k < MAX_INPUTS; k++) nodes[i]->inputs[k] = -1;
-            nodes[i]->inputsCount = 0;
+        if (nodes[i] != NULL) CalculateNodeValues(nodes[i]);
+        else TraceLogFNode(true, "error trying to calculate values for a null referenced node");
+    }
+}
 
-            // Search for node inputs and calculate inputs count
-            for (int k = 0; k < linesCount; k++)
+// Calculates a specific node output values based on its current inputs
+FNODEDEF void CalculateNodeValues(FNode node)
+{
+    // Reset node inputs values and inputs count
+    for (int k = 0; k < MAX_INPUTS; k++) node->inputs[k] = -1;
+    node->inputsCount = 0;
+
+    // Search for node inputs and calculate inputs count
+    for (int k = 0; k < linesCount; k++)
+    {
+        if (lines[k] != NULL)
+        {
+            // Check if line output (to) is the node input id
+            if (lines[k]->to == node->id)
             {
-                if (lines[k] != NULL)
-                {
-                    // Check if line output (to) is the node input id
-                    if (lines[k]->to == nodes[i]->id)
-                    {
-                        nodes[i]->inputs[nodes[i]->inputsCount] = lines[k]->from;
-                        nodes[i]->inputsCount++;
-                    }
-                }
+                node->inputs[node->inputsCount] = lines[k]->from;
+                node->inputsCount++;
             }
+        }
+    }
 
-            // Check if current node is an operator
-            if (nodes[i]->type > FNODE_VECTOR4 && nodes[i]->type < FNODE_APPEND)
-            {
-                // Calculate output values count based on first input node value count
-                if (nodes[i]->inputsCount > 0) 
-                {
-                    // Get which index has the first input node id from current nude
-                    int index = GetNodeIndex(nodes[i]->inputs[0]);
+    // Check if current node is an operator
+    if (node->type > FNODE_VECTOR4 && node->type < FNODE_APPEND)
+    {
+        // Calculate output values count based on first input node value count
+        if (node->inputsCount > 0) 
+        {
+            // Get which index has the first input node id from current nude
+            int index = GetNodeIndex(node->inputs[0]);
 
-                    nodes[i]->output.dataCount = nodes[index]->output.dataCount;
-                    for (int k = 0; k < nodes[i]->output.dataCount; k++) nodes[i]->output.data[k].value = nodes[index]->output.data[k].value;
+            node->output.dataCount = nodes[index]->output.dataCount;
+            for (int k = 0; k < node->output.dataCount; k++) node->output.data[k].value = nodes[index]->output.data[k].value;
 
-                    for (int k = 1; k < nodes[i]->inputsCount; k++)
-                    {
-                        int inputIndex = GetNodeIndex(nodes[i]->inputs[k]);
+            for (int k = 1; k < node->inputsCount; k++)
+            {
+                int inputIndex = GetNodeIndex(node->inputs[k]);
 
-                        // Apply inputs values to output based on node operation type
-                        switch (nodes[i]->type)
+                // Apply inputs values to output based on node operation type
+                switch (node->type)
+                {
+                    case FNODE_ADD:
+                    {
+                        for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value += nodes[inputIndex]->output.data[j].value;
+                    } break;
+                    case FNODE_SUBTRACT:
+                    {
+                        for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value -= nodes[inputIndex]->output.data[j].value;
+                    } break;
+                    case FNODE_MULTIPLY:
+                    {
+                        if (nodes[inputIndex]->output.dataCount == 1)
                         {
-                            case FNODE_ADD:
-                            {
-                                for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value += nodes[inputIndex]->output.data[j].value;
-                            } break;
-                            case FNODE_SUBTRACT:
-                            {
-                                for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value -= nodes[inputIndex]->output.data[j].value;
-                            } break;
-                            case FNODE_MULTIPLY:
-                            {
-                                if (nodes[inputIndex]->output.dataCount == 1)
-                                {
-                                    for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value *= nodes[inputIndex]->output.data[0].value;
-                                }
-                                else
-                                {
-                                    for (int j = 0; j < nodes[i]->output.dataCount; j++)
-                                    {
-                                        if (nodes[inputIndex]->output.dataCount == 16 && nodes[i]->output.dataCount == 4)
-                                        {
-                                            Vector4 vector = { nodes[i]->output.data[0].value, nodes[i]->output.data[1].value, nodes[i]->output.data[2].value, nodes[i]->output.data[3].value };
-                                            Matrix matrix = { nodes[inputIndex]->output.data[4].value, nodes[inputIndex]->output.data[5].value, nodes[inputIndex]->output.data[6].value, nodes[inputIndex]->output.data[7].value,
-                                            nodes[inputIndex]->output.data[8].value, nodes[inputIndex]->output.data[9].value, nodes[inputIndex]->output.data[10].value, nodes[inputIndex]->output.data[11].value,
-                                            nodes[inputIndex]->output.data[12].value, nodes[inputIndex]->output.data[13].value, nodes[inputIndex]->output.data[14].value, nodes[inputIndex]->output.data[15].value };
-                                            FMultiplyMatrixVector(&vector, matrix);
-
-                                            for (int k = 0; k < MAX_VALUES; k++) nodes[i]->output.data[k].value = 0.0f;
-                                            nodes[i]->output.data[0].value = vector.x;
-                                            nodes[i]->output.data[1].value = vector.y;
-                                            nodes[i]->output.data[2].value = vector.z;
-                                            nodes[i]->output.data[3].value = vector.w;
-                                            nodes[i]->output.dataCount = 4;
-                                        }
-                                        else if (nodes[inputIndex]->output.dataCount == 4 && nodes[i]->output.dataCount == 16)
-                                        {
-                                            Vector4 vector = { nodes[inputIndex]->output.data[0].value, nodes[inputIndex]->output.data[1].value, nodes[inputIndex]->output.data[2].value, nodes[inputIndex]->output.data[3].value };
-                                            Matrix matrix = { nodes[i]->output.data[4].value, nodes[i]->output.data[5].value, nodes[i]->output.data[6].value, nodes[i]->output.data[7].value,
-                                            nodes[i]->output.data[8].value, nodes[i]->output.data[9].value, nodes[i]->output.data[10].value, nodes[i]->output.data[11].value,
-                                            nodes[i]->output.data[12].value, nodes[i]->output.data[13].value, nodes[i]->output.data[14].value, nodes[i]->output.data[15].value };
-                                            FMultiplyMatrixVector(&vector, matrix);
-
-                                            for (int k = 0; k < MAX_VALUES; k++) nodes[i]->output.data[k].value = 0.0f;
-                                            nodes[i]->output.data[0].value = vector.x;
-                                            nodes[i]->output.data[1].value = vector.y;
-                                            nodes[i]->output.data[2].value = vector.z;
-                                            nodes[i]->output.data[3].value = vector.w;
-                                            nodes[i]->output.dataCount = 4;
-                                        }
-                                        else nodes[i]->output.data[j].value *= nodes[inputIndex]->output.data[j].value;
-                                    }
-                                }
-                            } break;
-                            case FNODE_DIVIDE:
+                            for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value *= nodes[inputIndex]->output.data[0].value;
+                        }
+                        else
+                        {
+                            for (int j = 0; j < node->output.dataCount; j++)
                             {
-                                if (nodes[inputIndex]->output.dataCount == 1)
+                                if (nodes[inputIndex]->output.dataCount == 16 && node->output.dataCount == 4)
                                 {
-                                    for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value /= nodes[inputIndex]->output.data[0].value;
+                                    Vector4 vector = { node->output.data[0].value, node->output.data[1].value, node->output.data[2].value, node->output.data[3].value };
+                                    Matrix matrix = { nodes[inputIndex]->output.data[4].value, nodes[inputIndex]->output.data[5].value, nodes[inputIndex]->output.data[6].value, nodes[inputIndex]->output.data[7].value,
+                                    nodes[inputIndex]->output.data[8].value, nodes[inputIndex]->output.data[9].value, nodes[inputIndex]->output.data[10].value, nodes[inputIndex]->output.data[11].value,
+                                    nodes[inputIndex]->output.data[12].value, nodes[inputIndex]->output.data[13].value, nodes[inputIndex]->output.data[14].value, nodes[inputIndex]->output.data[15].value };
+                                    FMultiplyMatrixVector(&vector, matrix);
+
+                                    for (int k = 0; k < MAX_VALUES; k++) node->output.data[k].value = 0.0f;
+                                    node->output.data[0].value = vector.x;
+                                    node->output.data[1].value = vector.y;
+                                    node->output.data[2].value = vector.z;
+                                    node->output.data[3].value = vector.w;
+                                    node->output.dataCount = 4;
                                 }
-                                else
+                                else if (nodes[inputIndex]->output.dataCount == 4 && node->output.dataCount == 16)
                                 {
-                                    for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value /= nodes[inputIndex]->output.data[j].value;
+                                    Vector4 vector = { nodes[inputIndex]->output.data[0].value, nodes[inputIndex]->output.data[1].value, nodes[inputIndex]->output.data[2].value, nodes[inputIndex]->output.data[3].value };
+                                    Matrix matrix = { node->output.data[4].value, node->output.data[5].value, node->output.data[6].value, node->output.data[7].value,
+                                    node->output.data[8].value, node->output.data[9].value, node->output.data[10].value, node->output.data[11].value,
+                                    node->output.data[12].value, node->output.data[13].value, node->output.data[14].value, node->output.data[15].value };
+                                    FMultiplyMatrixVector(&vector, matrix);
+
+                                    for (int k = 0; k < MAX_VALUES; k++) node->output.data[k].value = 0.0f;
+                                    node->output.data[0].value = vector.x;
+                                    node->output.data[1].value = vector.y;
+                                    node->output.data[2].value = vector.z;
+                                    node->output.data[3].value = vector.w;
+                                    node->output.dataCount = 4;
                                 }
-                            } break;
-                            default: break;
+                                else node->output.data[j].value *= nodes[inputIndex]->output.data[j].value;
+                            }
                         }
-                    }
+                    } break;
+                    case FNODE_DIVIDE:
+                    {
+                        if (nodes[inputIndex]->output.dataCount == 1)
+                        {
+                            for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value /= nodes[inputIndex]->output.data[0].value;
+                        }
+                        else
+                        {
+                            for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value /= nodes[inputIndex]->output.data[j].value;
+                        }
+                    } break;
+                    default: break;
                 }
-                else
+            }
+        }
+        else
+        {
+            for (int k = 0; k < MAX_VALUES; k++) node->output.data[k].value = 0.0f;
+            node->output.dataCount = 0;
+        }
+    }
+    else if (node->type == FNODE_APPEND)
+    {
+        if (node->inputsCount > 0)
+        {
+            int valuesCount = 0;
+            for (int k = 0; k < node->inputsCount; k++)
+            {
+                int inputIndex = GetNodeIndex(node->inputs[k]);
+
+                for (int j = 0; j < nodes[inputIndex]->output.dataCount; j++)
                 {
-                    for (int k = 0; k < MAX_VALUES; k++) nodes[i]->output.data[k].value = 0.0f;
-                    nodes[i]->output.dataCount = 0;
+                    node->output.data[valuesCount].value = nodes[inputIndex]->output.data[j].value;
+                    valuesCount++;
                 }
             }
-            else if (nodes[i]->type == FNODE_APPEND)
+
+            node->output.dataCount = valuesCount;
+        }
+        else
+        {
+            for (int k = 0; k < MAX_VALUES; k++) node->output.data[k].value = 0.0f;
+            node->output.dataCount = 0;
+        }
+    }
+    else if (node->type > FNODE_APPEND)
+    {
+        if (node->inputsCount > 0)
+        {
+            int index = GetNodeIndex(node->inputs[0]);
+
+            node->output.dataCount = nodes[index]->output.dataCount;
+            for (int k = 0; k < node->output.dataCount; k++) node->output.data[k].value = nodes[index]->output.data[k].value;
+
+            switch (node->type)
             {
-                if (nodes[i]->inputsCount > 0)
+                case FNODE_ONEMINUS:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = 1 - node->output.data[j].value;
+                } break;
+                case FNODE_ABS:
                 {
-                    int valuesCount = 0;
-                    for (int k = 0; k < nodes[i]->inputsCount; k++)
+                    for (int j = 0; j < node->output.dataCount; j++)
                     {
-                        int inputIndex = GetNodeIndex(nodes[i]->inputs[k]);
-
-                        for (int j = 0; j < nodes[inputIndex]->output.dataCount; j++)
-                        {
-                            nodes[i]->output.data[valuesCount].value = nodes[inputIndex]->output.data[j].value;
-                            valuesCount++;
-                        }
+                        if (node->output.data[j].value < 0) node->output.data[j].value *= -1;
                     }
-
-                    nodes[i]->output.dataCount = valuesCount;
-                }
-                else
+                } break;
+                case FNODE_COS:
                 {
-                    for (int k = 0; k < MAX_VALUES; k++) nodes[i]->output.data[k].value = 0.0f;
-                    nodes[i]->output.dataCount = 0;
-                }
-            }
-            else if (nodes[i]->type > FNODE_APPEND)
-            {
-                if (nodes[i]->inputsCount > 0)
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = (float)FCos(node->output.data[j].value);
+                } break;
+                case FNODE_SIN:
                 {
-                    int index = GetNodeIndex(nodes[i]->inputs[0]);
-
-                    nodes[i]->output.dataCount = nodes[index]->output.dataCount;
-                    for (int k = 0; k < nodes[i]->output.dataCount; k++) nodes[i]->output.data[k].value = nodes[index]->output.data[k].value;
-
-                    switch (nodes[i]->type)
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = (float)FSin(node->output.data[j].value);
+                } break;
+                case FNODE_TAN:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = (float)FTan(node->output.data[j].value);
+                } break;
+                case FNODE_DEG2RAD:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value *= DEG2RAD;
+                } break;
+                case FNODE_RAD2DEG:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value *= RAD2DEG;
+                } break;
+                case FNODE_NORMALIZE:
+                {
+                    switch (node->output.dataCount)
                     {
-                        case FNODE_ONEMINUS:
+                        case 2:
                         {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = 1 - nodes[i]->output.data[j].value;
+                            Vector2 temp = { node->output.data[0].value, node->output.data[1].value };
+                            temp = FVector2Normalize(temp);
+                            node->output.data[0].value = temp.x;
+                            node->output.data[1].value = temp.y;
                         } break;
-                        case FNODE_ABS:
+                        case 3:
                         {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++)
-                            {
-                                if (nodes[i]->output.data[j].value < 0) nodes[i]->output.data[j].value *= -1;
-                            }
+                            Vector3 temp = { node->output.data[0].value, node->output.data[1].value, node->output.data[2].value };
+                            temp = FVector3Normalize(temp);
+                            node->output.data[0].value = temp.x;
+                            node->output.data[1].value = temp.y;
+                            node->output.data[2].value = temp.z;
                         } break;
-                        case FNODE_COS:
+                        case 4:
                         {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = (float)FCos(nodes[i]->output.data[j].value);
+                            Vector4 temp = { node->output.data[0].value, node->output.data[1].value, node->output.data[2].value, node->output.data[3].value };
+                            temp = FVector4Normalize(temp);
+                            node->output.data[0].value = temp.x;
+                            node->output.data[1].value = temp.y;
+                            node->output.data[2].value = temp.z;
+                            node->output.data[3].value = temp.w;
                         } break;
-                        case FNODE_SIN:
+                        default: break;
+                    }
+                } break;
+                case FNODE_NEGATE:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value *= -1;
+                } break;
+                case FNODE_RECIPROCAL:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = 1/node->output.data[j].value;
+                } break;
+                case FNODE_SQRT:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = FSquareRoot(node->output.data[j].value);
+                } break;
+                case FNODE_TRUNC:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = FTrunc(node->output.data[j].value);
+                } break;
+                case FNODE_ROUND:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = FRound(node->output.data[j].value);
+                } break;
+                case FNODE_VERTEXCOLOR:
+                {
+                    if (node->inputsCount == 1)
+                    {
+                        int index = GetNodeIndex(node->inputs[0]);
+                        switch ((int)nodes[index]->output.data[0].value)
                         {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = (float)FSin(nodes[i]->output.data[j].value);
-                        } break;
-                        case FNODE_TAN:
+                            case 0: node->output.dataCount = 4; break;
+                            case 1: node->output.dataCount = 3; break;
+                            default: node->output.dataCount = 1; break;
+                        }
+                    }
+                    else
+                    {
+                        node->output.dataCount = 0;
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                    }
+                }
+                case FNODE_CEIL:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = FCeil(node->output.data[j].value);
+                } break;
+                case FNODE_CLAMP01:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = FClamp(node->output.data[j].value, 0.0f, 1.0f);
+                } break;
+                case FNODE_EXP2:
+                {
+                    for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = FPower(2.0f, node->output.data[j].value);
+                } break;
+                case FNODE_POWER:
+                {
+                    if (node->inputsCount == 2)
+                    {
+                        int expIndex = GetNodeIndex(node->inputs[1]);
+
+                        if (nodes[expIndex]->output.dataCount == 1)
                         {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = (float)FTan(nodes[i]->output.data[j].value);
-                        } break;
-                        case FNODE_DEG2RAD:
+                            for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = FPower(node->output.data[j].value, nodes[expIndex]->output.data[0].value);
+                        }
+                        else TraceLogFNode(false, "values count of node %i should be 1 because it is an exponent (currently count: %i)", nodes[expIndex]->id, nodes[expIndex]->output.dataCount);
+                    }
+                    else
+                    {
+                        node->output.dataCount = 0;
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                    }
+                } break;
+                case FNODE_STEP:
+                {
+                    if (node->inputsCount == 2)
+                    {
+                        int indexB = GetNodeIndex(node->inputs[1]);
+
+                        if (nodes[indexB]->output.dataCount == 1) node->output.data[0].value = ((node->output.data[0].value <= nodes[indexB]->output.data[0].value) ? 1.0f : 0.0f);
+                        else TraceLogFNode(false, "values count of node %i should be 1 because it is an exponent (currently count: %i)", nodes[indexB]->id, nodes[indexB]->output.dataCount);
+                    }
+                    else
+                    {
+                        node->output.dataCount = 0;
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                    }
+                } break;
+                case FNODE_POSTERIZE:
+                {
+                    if (node->inputsCount == 2)
+                    {
+                        int expIndex = GetNodeIndex(node->inputs[1]);
+
+                        if (nodes[expIndex]->output.dataCount == 1)
                         {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value *= DEG2RAD;
-                        } break;
-                        case FNODE_RAD2DEG:
+                            for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = FPosterize(node->output.data[j].value, nodes[expIndex]->output.data[0].value);
+                        }
+                    }
+                    else
+                    {
+                        node->output.dataCount = 0;
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                    }
+                } break;
+                case FNODE_MAX:
+                case FNODE_MIN:
+                {
+                    for (int j = 1; j < node->inputsCount; j++)
+                    {
+                        int inputIndex = GetNodeIndex(node->inputs[j]);
+
+                        for (int k = 0; k < node->output.dataCount; k++)
                         {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value *= RAD2DEG;
-                        } break;
-                        case FNODE_NORMALIZE:
+                            if ((nodes[inputIndex]->output.data[k].value > node->output.data[k].value) && (node->type == FNODE_MAX)) node->output.data[k].value = nodes[inputIndex]->output.data[k].value;
+                            else if ((nodes[inputIndex]->output.data[k].value < node->output.data[k].value) && (node->type == FNODE_MIN)) node->output.data[k].value = nodes[inputIndex]->output.data[k].value;
+                        }
+                    }
+                } break;
+                case FNODE_LERP:
+                {                                
+                    if (node->inputsCount == 3)
+                    {
+                        int indexA = GetNodeIndex(node->inputs[0]);
+                        int indexB = GetNodeIndex(node->inputs[1]);
+                        int indexC = GetNodeIndex(node->inputs[2]);
+                        
+                        switch (node->output.dataCount)
                         {
-                            switch (nodes[i]->output.dataCount)
+                            case 1:
                             {
-                                case 2:
-                                {
-                                    Vector2 temp = { nodes[i]->output.data[0].value, nodes[i]->output.data[1].value };
-                                    temp = FVector2Normalize(temp);
-                                    nodes[i]->output.data[0].value = temp.x;
-                                    nodes[i]->output.data[1].value = temp.y;
-                                } break;
-                                case 3:
-                                {
-                                    Vector3 temp = { nodes[i]->output.data[0].value, nodes[i]->output.data[1].value, nodes[i]->output.data[2].value };
-                                    temp = FVector3Normalize(temp);
-                                    nodes[i]->output.data[0].value = temp.x;
-                                    nodes[i]->output.data[1].value = temp.y;
-                                    nodes[i]->output.data[2].value = temp.z;
-                                } break;
-                                case 4:
-                                {
-                                    Vector4 temp = { nodes[i]->output.data[0].value, nodes[i]->output.data[1].value, nodes[i]->output.data[2].value, nodes[i]->output.data[3].value };
-                                    temp = FVector4Normalize(temp);
-                                    nodes[i]->output.data[0].value = temp.x;
-                                    nodes[i]->output.data[1].value = temp.y;
-                                    nodes[i]->output.data[2].value = temp.z;
-                                    nodes[i]->output.data[3].value = temp.w;
-                                } break;
-                                default: break;
-                            }
-                        } break;
-                        case FNODE_NEGATE:
-                        {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value *= -1;
-                        } break;
-                        case FNODE_RECIPROCAL:
-                        {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = 1/nodes[i]->output.data[j].value;
-                        } break;
-                        case FNODE_SQRT:
-                        {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = FSquareRoot(nodes[i]->output.data[j].value);
-                        } break;
-                        case FNODE_TRUNC:
-                        {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = FTrunc(nodes[i]->output.data[j].value);
-                        } break;
-                        case FNODE_ROUND:
-                        {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = FRound(nodes[i]->output.data[j].value);
-                        } break;
-                        case FNODE_VERTEXCOLOR:
-                        {
-                            if (nodes[i]->inputsCount == 1)
+                                for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = FLerp(nodes[indexA]->output.data[j].value, nodes[indexB]->output.data[j].value, nodes[indexC]->output.data[j].value);
+                            } break;
+                            case 2:
                             {
-                                int index = GetNodeIndex(nodes[i]->inputs[0]);
-                                switch ((int)nodes[index]->output.data[0].value)
-                                {
-                                    case 0: nodes[i]->output.dataCount = 4; break;
-                                    case 1: nodes[i]->output.dataCount = 3; break;
-                                    default: nodes[i]->output.dataCount = 1; break;
-                                }
-                            }
-                            else
+                                Vector2 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value };
+                                Vector2 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value };
+                                Vector2 lerp = FVector2Lerp(vectorA, vectorB, nodes[indexC]->output.data[0].value);
+                                
+                                node->output.dataCount = 2;
+                                node->output.data[0].value = lerp.x;
+                                node->output.data[1].value = lerp.y;
+                            } break;
+                            case 3:
                             {
-                                nodes[i]->output.dataCount = 0;
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                            }
-                        }
-                        case FNODE_CEIL:
-                        {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = FCeil(nodes[i]->output.data[j].value);
-                        } break;
-                        case FNODE_CLAMP01:
-                        {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = FClamp(nodes[i]->output.data[j].value, 0.0f, 1.0f);
-                        } break;
-                        case FNODE_EXP2:
-                        {
-                            for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = FPower(2.0f, nodes[i]->output.data[j].value);
-                        } break;
-                        case FNODE_POWER:
-                        {
-                            if (nodes[i]->inputsCount == 2)
+                                Vector3 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value };
+                                Vector3 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexA]->output.data[2].value };
+                                Vector3 lerp = FVector3Lerp(vectorA, vectorB, nodes[indexC]->output.data[0].value);
+                                
+                                node->output.dataCount = 3;
+                                node->output.data[0].value = lerp.x;
+                                node->output.data[1].value = lerp.y;
+                                node->output.data[2].value = lerp.z;
+                            } break;
+                            case 4:
                             {
-                                int expIndex = GetNodeIndex(nodes[i]->inputs[1]);
+                                Vector4 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value, nodes[indexA]->output.data[3].value };
+                                Vector4 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexA]->output.data[2].value, nodes[indexA]->output.data[3].value };
+                                Vector4 lerp = FVector4Lerp(vectorA, vectorB, nodes[indexC]->output.data[0].value);
+                                
+                                node->output.dataCount = 4;
+                                node->output.data[0].value = lerp.x;
+                                node->output.data[1].value = lerp.y;
+                                node->output.data[2].value = lerp.z;
+                                node->output.data[3].value = lerp.w;
+                            } break;
+                            default: break;
+                        }
+                    }
+                    else
+                    {
+                        node->output.dataCount = 0;
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                    }
+                } break;
+                case FNODE_SMOOTHSTEP:
+                {                                
+                    if (node->inputsCount == 3)
+                    {
+                        int indexA = GetNodeIndex(node->inputs[0]);
+                        int indexB = GetNodeIndex(node->inputs[1]);
+                        int indexC = GetNodeIndex(node->inputs[2]);
+
+                        for (int j = 0; j < node->output.dataCount; j++) node->output.data[j].value = FSmoothStep(nodes[indexA]->output.data[j].value, nodes[indexB]->output.data[j].value, nodes[indexC]->output.data[j].value);
+                    }
+                    else
+                    {
+                        node->output.dataCount = 0;
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                    }
+                } break;
+                case FNODE_CROSSPRODUCT:
+                {
+                    if (node->inputsCount == 2)
+                    {
+                        int indexA = GetNodeIndex(node->inputs[0]);
+                        int indexB = GetNodeIndex(node->inputs[1]);
+
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+
+                        Vector3 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value };
+                        Vector3 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value };
+                        Vector3 cross = FCrossProduct(vectorA, vectorB);
+
+                        node->output.dataCount = 3;
+                        node->output.data[0].value = cross.x;
+                        node->output.data[1].value = cross.y;
+                        node->output.data[2].value = cross.z;
+                    }
+                    else
+                    {
+                        node->output.dataCount = 0;
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                    }
+                } break;
+                case FNODE_DESATURATE:
+                {
+                    if (node->inputsCount == 2)
+                    {
+                        int index = GetNodeIndex(node->inputs[0]);
+                        int index1 = GetNodeIndex(node->inputs[1]);
+
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = nodes[index]->output.data[j].value;
+                        node->output.dataCount = nodes[index]->output.dataCount;
+
+                        float amount = FClamp(nodes[index1]->output.data[0].value, 0.0f, 1.0f);
+                        float luminance = 0.3f*node->output.data[0].value + 0.6f*node->output.data[1].value + 0.1f*node->output.data[2].value;
+
+                        node->output.data[0].value = node->output.data[0].value + amount*(luminance - node->output.data[0].value);
+                        node->output.data[1].value = node->output.data[1].value + amount*(luminance - node->output.data[1].value);
+                        node->output.data[2].value = node->output.data[2].value + amount*(luminance - node->output.data[2].value);
+                    }
+                    else
+                    {
+                        node->output.dataCount = 0;
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                    }
+                } break;
+                case FNODE_DISTANCE:
+                {
+                    if (node->inputsCount == 2)
+                    {
+                        int indexA = GetNodeIndex(node->inputs[0]);
+                        int indexB = GetNodeIndex(node->inputs[1]);
 
-                                if (nodes[expIndex]->output.dataCount == 1)
-                                {
-                                    for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = FPower(nodes[i]->output.data[j].value, nodes[expIndex]->output.data[0].value);
-                                }
-                                else TraceLogFNode(false, "values count of node %i should be 1 because it is an exponent (currently count: %i)", nodes[expIndex]->id, nodes[expIndex]->output.dataCount);
-                            }
-                            else
-                            {
-                                nodes[i]->output.dataCount = 0;
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                            }
-                        } break;
-                        case FNODE_STEP:
+                        switch (node->output.dataCount)
                         {
-                            if (nodes[i]->inputsCount == 2)
+                            case 1: node->output.data[0].value = nodes[indexB]->output.data[0].value - nodes[indexA]->output.data[0].value; break;
+                            case 2:
                             {
-                                int indexB = GetNodeIndex(nodes[i]->inputs[1]);
+                                Vector2 direction = { 0, 0 };
+                                direction.x = nodes[indexB]->output.data[0].value - nodes[indexA]->output.data[0].value;
+                                direction.y = nodes[indexB]->output.data[1].value - nodes[indexA]->output.data[1].value;
 
-                                if (nodes[indexB]->output.dataCount == 1) nodes[i]->output.data[0].value = ((nodes[i]->output.data[0].value <= nodes[indexB]->output.data[0].value) ? 1.0f : 0.0f);
-                                else TraceLogFNode(false, "values count of node %i should be 1 because it is an exponent (currently count: %i)", nodes[indexB]->id, nodes[indexB]->output.dataCount);
-                            }
-                            else
-                            {
-                                nodes[i]->output.dataCount = 0;
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                            }
-                        } break;
-                        case FNODE_POSTERIZE:
-                        {
-                            if (nodes[i]->inputsCount == 2)
+                                node->output.data[0].value = FVector2Length(direction);
+                            } break;
+                            case 3:
                             {
-                                int expIndex = GetNodeIndex(nodes[i]->inputs[1]);
+                                Vector3 direction = { 0, 0, 0 };
+                                direction.x = nodes[indexB]->output.data[0].value - nodes[indexA]->output.data[0].value;
+                                direction.y = nodes[indexB]->output.data[1].value - nodes[indexA]->output.data[1].value;
+                                direction.z = nodes[indexB]->output.data[2].value - nodes[indexA]->output.data[2].value;
 
-                                if (nodes[expIndex]->output.dataCount == 1)
-                                {
-                                    for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = FPosterize(nodes[i]->output.data[j].value, nodes[expIndex]->output.data[0].value);
-                                }
-                            }
-                            else
-                            {
-                                nodes[i]->output.dataCount = 0;
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                            }
-                        } break;
-                        case FNODE_MAX:
-                        case FNODE_MIN:
-                        {
-                            for (int j = 1; j < nodes[i]->inputsCount; j++)
+                                node->output.data[0].value = FVector3Length(direction);
+                            } break;
+                            case 4:
                             {
-                                int inputIndex = GetNodeIndex(nodes[i]->inputs[j]);
+                                Vector4 direction = { 0, 0, 0, 0 };
+                                direction.x = nodes[indexB]->output.data[0].value - nodes[indexA]->output.data[0].value;
+                                direction.y = nodes[indexB]->output.data[1].value - nodes[indexA]->output.data[1].value;
+                                direction.z = nodes[indexB]->output.data[2].value - nodes[indexA]->output.data[2].value;
+                                direction.w = nodes[indexB]->output.data[3].value - nodes[indexA]->output.data[3].value;
 
-                                for (int k = 0; k < nodes[i]->output.dataCount; k++)
-                                {
-                                    if ((nodes[inputIndex]->output.data[k].value > nodes[i]->output.data[k].value) && (nodes[i]->type == FNODE_MAX)) nodes[i]->output.data[k].value = nodes[inputIndex]->output.data[k].value;
-                                    else if ((nodes[inputIndex]->output.data[k].value < nodes[i]->output.data[k].value) && (nodes[i]->type == FNODE_MIN)) nodes[i]->output.data[k].value = nodes[inputIndex]->output.data[k].value;
-                                }
-                            }
-                        } break;
-                        case FNODE_LERP:
-                        {                                
-                            if (nodes[i]->inputsCount == 3)
-                            {
-                                int indexA = GetNodeIndex(nodes[i]->inputs[0]);
-                                int indexB = GetNodeIndex(nodes[i]->inputs[1]);
-                                int indexC = GetNodeIndex(nodes[i]->inputs[2]);
-                                
-                                switch (nodes[i]->output.dataCount)
-                                {
-                                    case 1:
-                                    {
-                                        for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = FLerp(nodes[indexA]->output.data[j].value, nodes[indexB]->output.data[j].value, nodes[indexC]->output.data[j].value);
-                                    } break;
-                                    case 2:
-                                    {
-                                        Vector2 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value };
-                                        Vector2 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value };
-                                        Vector2 lerp = FVector2Lerp(vectorA, vectorB, nodes[indexC]->output.data[0].value);
-                                        
-                                        nodes[i]->output.dataCount = 2;
-                                        nodes[i]->output.data[0].value = lerp.x;
-                                        nodes[i]->output.data[1].value = lerp.y;
-                                    } break;
-                                    case 3:
-                                    {
-                                        Vector3 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value };
-                                        Vector3 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexA]->output.data[2].value };
-                                        Vector3 lerp = FVector3Lerp(vectorA, vectorB, nodes[indexC]->output.data[0].value);
-                                        
-                                        nodes[i]->output.dataCount = 3;
-                                        nodes[i]->output.data[0].value = lerp.x;
-                                        nodes[i]->output.data[1].value = lerp.y;
-                                        nodes[i]->output.data[2].value = lerp.z;
-                                    } break;
-                                    case 4:
-                                    {
-                                        Vector4 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value, nodes[indexA]->output.data[3].value };
-                                        Vector4 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexA]->output.data[2].value, nodes[indexA]->output.data[3].value };
-                                        Vector4 lerp = FVector4Lerp(vectorA, vectorB, nodes[indexC]->output.data[0].value);
-                                        
-                                        nodes[i]->output.dataCount = 4;
-                                        nodes[i]->output.data[0].value = lerp.x;
-                                        nodes[i]->output.data[1].value = lerp.y;
-                                        nodes[i]->output.data[2].value = lerp.z;
-                                        nodes[i]->output.data[3].value = lerp.w;
-                                    } break;
-                                    default: break;
-                                }
-                            }
-                            else
-                            {
-                                nodes[i]->output.dataCount = 0;
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                            }
-                        } break;
-                        case FNODE_SMOOTHSTEP:
-                        {                                
-                            if (nodes[i]->inputsCount == 3)
-                            {
-                                int indexA = GetNodeIndex(nodes[i]->inputs[0]);
-                                int indexB = GetNodeIndex(nodes[i]->inputs[1]);
-                                int indexC = GetNodeIndex(nodes[i]->inputs[2]);
+                                node->output.data[0].value = FVector4Length(direction);
+                            } break;
+                            default: break;
+                        }
 
-                                for (int j = 0; j < nodes[i]->output.dataCount; j++) nodes[i]->output.data[j].value = FSmoothStep(nodes[indexA]->output.data[j].value, nodes[indexB]->output.data[j].value, nodes[indexC]->output.data[j].value);
-                            }
-                            else
-                            {
-                                nodes[i]->output.dataCount = 0;
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                            }
-                        } break;
-                        case FNODE_CROSSPRODUCT:
+                        for (int j = 1; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                        node->output.dataCount = 1;
+                    }
+                    else
+                    {
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                        node->output.dataCount = 0;
+                    }
+                } break;
+                case FNODE_DOTPRODUCT:
+                {
+                    if (node->inputsCount == 2)
+                    {
+                        int indexA = GetNodeIndex(node->inputs[0]);
+                        int indexB = GetNodeIndex(node->inputs[1]);
+
+                        switch (node->output.dataCount)
                         {
-                            if (nodes[i]->inputsCount == 2)
+                            case 2:
+                            {
+                                Vector2 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value };
+                                Vector2 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value };
+                                node->output.data[0].value = FVector2Dot(vectorA, vectorB);
+                            } break;
+                            case 3:
                             {
-                                int indexA = GetNodeIndex(nodes[i]->inputs[0]);
-                                int indexB = GetNodeIndex(nodes[i]->inputs[1]);
-
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-
                                 Vector3 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value };
                                 Vector3 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value };
-                                Vector3 cross = FCrossProduct(vectorA, vectorB);
-
-                                nodes[i]->output.dataCount = 3;
-                                nodes[i]->output.data[0].value = cross.x;
-                                nodes[i]->output.data[1].value = cross.y;
-                                nodes[i]->output.data[2].value = cross.z;
-                            }
-                            else
-                            {
-                                nodes[i]->output.dataCount = 0;
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                            }
-                        } break;
-                        case FNODE_DESATURATE:
-                        {
-                            if (nodes[i]->inputsCount == 2)
+                                node->output.data[0].value = FVector3Dot(vectorA, vectorB);
+                            } break;
+                            case 4:
                             {
-                                int index = GetNodeIndex(nodes[i]->inputs[0]);
-                                int index1 = GetNodeIndex(nodes[i]->inputs[1]);
+                                Vector4 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value, nodes[indexA]->output.data[3].value };
+                                Vector4 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value, nodes[indexB]->output.data[3].value };
+                                node->output.data[0].value = FVector4Dot(vectorA, vectorB);
+                            } break;
+                            default: break;
+                        }
 
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = nodes[index]->output.data[j].value;
-                                nodes[i]->output.dataCount = nodes[index]->output.dataCount;
+                        for (int j = 1; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                        node->output.dataCount = 1;
+                    }
+                    else
+                    {
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                        node->output.dataCount = 0;
+                    }
+                } break;
+                case FNODE_LENGTH:
+                {
+                    switch (node->output.dataCount)
+                    {
+                        case 2: node->output.data[0].value = FVector2Length((Vector2){ node->output.data[0].value, node->output.data[1].value }); break;
+                        case 3: node->output.data[0].value = FVector3Length((Vector3){ node->output.data[0].value, node->output.data[1].value, node->output.data[2].value }); break;
+                        case 4: node->output.data[0].value = FVector4Length((Vector4){ node->output.data[0].value, node->output.data[1].value, node->output.data[2].value, node->output.data[3].value }); break;
+                        default: break;
+                    }
 
-                                float amount = FClamp(nodes[index1]->output.data[0].value, 0.0f, 1.0f);
-                                float luminance = 0.3f*nodes[i]->output.data[0].value + 0.6f*nodes[i]->output.data[1].value + 0.1f*nodes[i]->output.data[2].value;
+                    for (int j = 1; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                    node->output.dataCount = 1;
+                } break;
+                case FNODE_MULTIPLYMATRIX:
+                {
+                    if (node->inputsCount == 2)
+                    {
+                        int index = GetNodeIndex(node->inputs[1]);
+
+                        Matrix matrixA = { node->output.data[0].value, node->output.data[1].value, node->output.data[2].value, node->output.data[3].value, 
+                        node->output.data[4].value, node->output.data[5].value, node->output.data[6].value, node->output.data[7].value, 
+                        node->output.data[8].value, node->output.data[9].value, node->output.data[10].value, node->output.data[11].value, 
+                        node->output.data[12].value, node->output.data[13].value, node->output.data[14].value, node->output.data[15].value, };
+                        Matrix matrixB = { nodes[index]->output.data[0].value, nodes[index]->output.data[1].value, nodes[index]->output.data[2].value, nodes[index]->output.data[3].value, 
+                        nodes[index]->output.data[4].value, nodes[index]->output.data[5].value, nodes[index]->output.data[6].value, nodes[index]->output.data[7].value, 
+                        nodes[index]->output.data[8].value, nodes[index]->output.data[9].value, nodes[index]->output.data[10].value, nodes[index]->output.data[11].value, 
+                        nodes[index]->output.data[12].value, nodes[index]->output.data[13].value, nodes[index]->output.data[14].value, nodes[index]->output.data[15].value, };
+                        Matrix matrixAB = FMatrixMultiply(matrixA, matrixB);
+
+                        node->output.data[0].value = matrixAB.m0;
+                        node->output.data[1].value = matrixAB.m1;
+                        node->output.data[2].value = matrixAB.m2;
+                        node->output.data[3].value = matrixAB.m3;
+                        node->output.data[4].value = matrixAB.m4;
+                        node->output.data[5].value = matrixAB.m5;
+                        node->output.data[6].value = matrixAB.m6;
+                        node->output.data[7].value = matrixAB.m7;
+                        node->output.data[8].value = matrixAB.m8;
+                        node->output.data[9].value = matrixAB.m9;
+                        node->output.data[10].value = matrixAB.m10;
+                        node->output.data[11].value = matrixAB.m11;
+                        node->output.data[12].value = matrixAB.m12;
+                        node->output.data[13].value = matrixAB.m13;
+                        node->output.data[14].value = matrixAB.m14;
+                        node->output.data[15].value = matrixAB.m15;
+                    }
+                } break;
+                case FNODE_TRANSPOSE:
+                {
+                    Matrix matrix = { node->output.data[0].value, node->output.data[1].value, node->output.data[2].value, node->output.data[3].value, 
+                    node->output.data[4].value, node->output.data[5].value, node->output.data[6].value, node->output.data[7].value, 
+                    node->output.data[8].value, node->output.data[9].value, node->output.data[10].value, node->output.data[11].value, 
+                    node->output.data[12].value, node->output.data[13].value, node->output.data[14].value, node->output.data[15].value, };
+                    FMatrixTranspose(&matrix);
+
+                    node->output.data[0].value = matrix.m0;
+                    node->output.data[1].value = matrix.m1;
+                    node->output.data[2].value = matrix.m2;
+                    node->output.data[3].value = matrix.m3;
+                    node->output.data[4].value = matrix.m4;
+                    node->output.data[5].value = matrix.m5;
+                    node->output.data[6].value = matrix.m6;
+                    node->output.data[7].value = matrix.m7;
+                    node->output.data[8].value = matrix.m8;
+                    node->output.data[9].value = matrix.m9;
+                    node->output.data[10].value = matrix.m10;
+                    node->output.data[11].value = matrix.m11;
+                    node->output.data[12].value = matrix.m12;
+                    node->output.data[13].value = matrix.m13;
+                    node->output.data[14].value = matrix.m14;
+                    node->output.data[15].value = matrix.m15;
+                } break;
+                case FNODE_PROJECTION:
+                case FNODE_REJECTION:
+                {
+                    if (node->inputsCount == 2)
+                    {
+                        int indexA = GetNodeIndex(node->inputs[0]);
+                        int indexB = GetNodeIndex(node->inputs[1]);
 
-                                nodes[i]->output.data[0].value = nodes[i]->output.data[0].value + amount*(luminance - nodes[i]->output.data[0].value);
-                                nodes[i]->output.data[1].value = nodes[i]->output.data[1].value + amount*(luminance - nodes[i]->output.data[1].value);
-                                nodes[i]->output.data[2].value = nodes[i]->output.data[2].value + amount*(luminance - nodes[i]->output.data[2].value);
-                            }
-                            else
-                            {
-                                nodes[i]->output.dataCount = 0;
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                            }
-                        } break;
-                        case FNODE_DISTANCE:
+                        switch (node->output.dataCount)
                         {
-                            if (nodes[i]->inputsCount == 2)
+                            case 2:
                             {
-                                int indexA = GetNodeIndex(nodes[i]->inputs[0]);
-                                int indexB = GetNodeIndex(nodes[i]->inputs[1]);
+                                Vector2 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value };
+                                Vector2 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value };
+                                Vector2 newVector = ((node->type == FNODE_PROJECTION) ? FVector2Projection(vectorA, vectorB) : FVector2Rejection(vectorA, vectorB));
 
-                                switch (nodes[i]->output.dataCount)
-                                {
-                                    case 1: nodes[i]->output.data[0].value = nodes[indexB]->output.data[0].value - nodes[indexA]->output.data[0].value; break;
-                                    case 2:
-                                    {
-                                        Vector2 direction = { 0, 0 };
-                                        direction.x = nodes[indexB]->output.data[0].value - nodes[indexA]->output.data[0].value;
-                                        direction.y = nodes[indexB]->output.data[1].value - nodes[indexA]->output.data[1].value;
-
-                                        nodes[i]->output.data[0].value = FVector2Length(direction);
-                                    } break;
-                                    case 3:
-                                    {
-                                        Vector3 direction = { 0, 0, 0 };
-                                        direction.x = nodes[indexB]->output.data[0].value - nodes[indexA]->output.data[0].value;
-                                        direction.y = nodes[indexB]->output.data[1].value - nodes[indexA]->output.data[1].value;
-                                        direction.z = nodes[indexB]->output.data[2].value - nodes[indexA]->output.data[2].value;
-
-                                        nodes[i]->output.data[0].value = FVector3Length(direction);
-                                    } break;
-                                    case 4:
-                                    {
-                                        Vector4 direction = { 0, 0, 0, 0 };
-                                        direction.x = nodes[indexB]->output.data[0].value - nodes[indexA]->output.data[0].value;
-                                        direction.y = nodes[indexB]->output.data[1].value - nodes[indexA]->output.data[1].value;
-                                        direction.z = nodes[indexB]->output.data[2].value - nodes[indexA]->output.data[2].value;
-                                        direction.w = nodes[indexB]->output.data[3].value - nodes[indexA]->output.data[3].value;
-
-                                        nodes[i]->output.data[0].value = FVector4Length(direction);
-                                    } break;
-                                    default: break;
-                                }
+                                node->output.data[0].value = newVector.x;
+                                node->output.data[1].value = newVector.y;
 
-                                for (int j = 1; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                nodes[i]->output.dataCount = 1;
-                            }
-                            else
-                            {
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                nodes[i]->output.dataCount = 0;
-                            }
-                        } break;
-                        case FNODE_DOTPRODUCT:
-                        {
-                            if (nodes[i]->inputsCount == 2)
+                                for (int j = 2; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                                node->output.dataCount = 2;
+                            } break;
+                            case 3:
                             {
-                                int indexA = GetNodeIndex(nodes[i]->inputs[0]);
-                                int indexB = GetNodeIndex(nodes[i]->inputs[1]);
+                                Vector3 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value };
+                                Vector3 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value };
+                                Vector3 newVector = ((node->type == FNODE_PROJECTION) ? FVector3Projection(vectorA, vectorB) : FVector3Rejection(vectorA, vectorB));
 
-                                switch (nodes[i]->output.dataCount)
-                                {
-                                    case 2:
-                                    {
-                                        Vector2 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value };
-                                        Vector2 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value };
-                                        nodes[i]->output.data[0].value = FVector2Dot(vectorA, vectorB);
-                                    } break;
-                                    case 3:
-                                    {
-                                        Vector3 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value };
-                                        Vector3 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value };
-                                        nodes[i]->output.data[0].value = FVector3Dot(vectorA, vectorB);
-                                    } break;
-                                    case 4:
-                                    {
-                                        Vector4 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value, nodes[indexA]->output.data[3].value };
-                                        Vector4 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value, nodes[indexB]->output.data[3].value };
-                                        nodes[i]->output.data[0].value = FVector4Dot(vectorA, vectorB);
-                                    } break;
-                                    default: break;
-                                }
+                                node->output.data[0].value = newVector.x;
+                                node->output.data[1].value = newVector.y;
+                                node->output.data[2].value = newVector.z;
 
-                                for (int j = 1; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                nodes[i]->output.dataCount = 1;
-                            }
-                            else
-                            {
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                nodes[i]->output.dataCount = 0;
-                            }
-                        } break;
-                        case FNODE_LENGTH:
-                        {
-                            switch (nodes[i]->output.dataCount)
+                                for (int j = 3; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                                node->output.dataCount = 3;
+                            } break;
+                            case 4:
                             {
-                                case 2: nodes[i]->output.data[0].value = FVector2Length((Vector2){ nodes[i]->output.data[0].value, nodes[i]->output.data[1].value }); break;
-                                case 3: nodes[i]->output.data[0].value = FVector3Length((Vector3){ nodes[i]->output.data[0].value, nodes[i]->output.data[1].value, nodes[i]->output.data[2].value }); break;
-                                case 4: nodes[i]->output.data[0].value = FVector4Length((Vector4){ nodes[i]->output.data[0].value, nodes[i]->output.data[1].value, nodes[i]->output.data[2].value, nodes[i]->output.data[3].value }); break;
-                                default: break;
-                            }
+                                Vector4 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value, nodes[indexA]->output.data[3].value };
+                                Vector4 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value, nodes[indexB]->output.data[3].value };
+                                Vector4 newVector = ((node->type == FNODE_PROJECTION) ? FVector4Projection(vectorA, vectorB) : FVector4Rejection(vectorA, vectorB));
 
-                            for (int j = 1; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                            nodes[i]->output.dataCount = 1;
-                        } break;
-                        case FNODE_MULTIPLYMATRIX:
-                        {
-                            if (nodes[i]->inputsCount == 2)
-                            {
-                                int index = GetNodeIndex(nodes[i]->inputs[1]);
-
-                                Matrix matrixA = { nodes[i]->output.data[0].value, nodes[i]->output.data[1].value, nodes[i]->output.data[2].value, nodes[i]->output.data[3].value, 
-                                nodes[i]->output.data[4].value, nodes[i]->output.data[5].value, nodes[i]->output.data[6].value, nodes[i]->output.data[7].value, 
-                                nodes[i]->output.data[8].value, nodes[i]->output.data[9].value, nodes[i]->output.data[10].value, nodes[i]->output.data[11].value, 
-                                nodes[i]->output.data[12].value, nodes[i]->output.data[13].value, nodes[i]->output.data[14].value, nodes[i]->output.data[15].value, };
-                                Matrix matrixB = { nodes[index]->output.data[0].value, nodes[index]->output.data[1].value, nodes[index]->output.data[2].value, nodes[index]->output.data[3].value, 
-                                nodes[index]->output.data[4].value, nodes[index]->output.data[5].value, nodes[index]->output.data[6].value, nodes[index]->output.data[7].value, 
-                                nodes[index]->output.data[8].value, nodes[index]->output.data[9].value, nodes[index]->output.data[10].value, nodes[index]->output.data[11].value, 
-                                nodes[index]->output.data[12].value, nodes[index]->output.data[13].value, nodes[index]->output.data[14].value, nodes[index]->output.data[15].value, };
-                                Matrix matrixAB = FMatrixMultiply(matrixA, matrixB);
-
-                                nodes[i]->output.data[0].value = matrixAB.m0;
-                                nodes[i]->output.data[1].value = matrixAB.m1;
-                                nodes[i]->output.data[2].value = matrixAB.m2;
-                                nodes[i]->output.data[3].value = matrixAB.m3;
-                                nodes[i]->output.data[4].value = matrixAB.m4;
-                                nodes[i]->output.data[5].value = matrixAB.m5;
-                                nodes[i]->output.data[6].value = matrixAB.m6;
-                                nodes[i]->output.data[7].value = matrixAB.m7;
-                                nodes[i]->output.data[8].value = matrixAB.m8;
-                                nodes[i]->output.data[9].value = matrixAB.m9;
-                                nodes[i]->output.data[10].value = matrixAB.m10;
-                                nodes[i]->output.data[11].value = matrixAB.m11;
-                                nodes[i]->output.data[12].value = matrixAB.m12;
-                                nodes[i]->output.data[13].value = matrixAB.m13;
-                                nodes[i]->output.data[14].value = matrixAB.m14;
-                                nodes[i]->output.data[15].value = matrixAB.m15;
-                            }
-                        } break;
-                        case FNODE_TRANSPOSE:
-                        {
-                            Matrix matrix = { nodes[i]->output.data[0].value, nodes[i]->output.data[1].value, nodes[i]->output.data[2].value, nodes[i]->output.data[3].value, 
-                            nodes[i]->output.data[4].value, nodes[i]->output.data[5].value, nodes[i]->output.data[6].value, nodes[i]->output.data[7].value, 
-                            nodes[i]->output.data[8].value, nodes[i]->output.data[9].value, nodes[i]->output.data[10].value, nodes[i]->output.data[11].value, 
-                            nodes[i]->output.data[12].value, nodes[i]->output.data[13].value, nodes[i]->output.data[14].value, nodes[i]->output.data[15].value, };
-                            FMatrixTranspose(&matrix);
-
-                            nodes[i]->output.data[0].value = matrix.m0;
-                            nodes[i]->output.data[1].value = matrix.m1;
-                            nodes[i]->output.data[2].value = matrix.m2;
-                            nodes[i]->output.data[3].value = matrix.m3;
-                            nodes[i]->output.data[4].value = matrix.m4;
-                            nodes[i]->output.data[5].value = matrix.m5;
-                            nodes[i]->output.data[6].value = matrix.m6;
-                            nodes[i]->output.data[7].value = matrix.m7;
-                            nodes[i]->output.data[8].value = matrix.m8;
-                            nodes[i]->output.data[9].value = matrix.m9;
-                            nodes[i]->output.data[10].value = matrix.m10;
-                            nodes[i]->output.data[11].value = matrix.m11;
-                            nodes[i]->output.data[12].value = matrix.m12;
-                            nodes[i]->output.data[13].value = matrix.m13;
-                            nodes[i]->output.data[14].value = matrix.m14;
-                            nodes[i]->output.data[15].value = matrix.m15;
-                        } break;
-                        case FNODE_PROJECTION:
-                        case FNODE_REJECTION:
-                        {
-                            if (nodes[i]->inputsCount == 2)
-                            {
-                                int indexA = GetNodeIndex(nodes[i]->inputs[0]);
-                                int indexB = GetNodeIndex(nodes[i]->inputs[1]);
+                                node->output.data[0].value = newVector.x;
+                                node->output.data[1].value = newVector.y;
+                                node->output.data[2].value = newVector.z;
+                                node->output.data[3].value = newVector.w;
 
-                                switch (nodes[i]->output.dataCount)
-                                {
-                                    case 2:
-                                    {
-                                        Vector2 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value };
-                                        Vector2 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value };
-                                        Vector2 newVector = ((nodes[i]->type == FNODE_PROJECTION) ? FVector2Projection(vectorA, vectorB) : FVector2Rejection(vectorA, vectorB));
-
-                                        nodes[i]->output.data[0].value = newVector.x;
-                                        nodes[i]->output.data[1].value = newVector.y;
-
-                                        for (int j = 2; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                        nodes[i]->output.dataCount = 2;
-                                    } break;
-                                    case 3:
-                                    {
-                                        Vector3 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value };
-                                        Vector3 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value };
-                                        Vector3 newVector = ((nodes[i]->type == FNODE_PROJECTION) ? FVector3Projection(vectorA, vectorB) : FVector3Rejection(vectorA, vectorB));
-
-                                        nodes[i]->output.data[0].value = newVector.x;
-                                        nodes[i]->output.data[1].value = newVector.y;
-                                        nodes[i]->output.data[2].value = newVector.z;
-
-                                        for (int j = 3; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                        nodes[i]->output.dataCount = 3;
-                                    } break;
-                                    case 4:
-                                    {
-                                        Vector4 vectorA = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value, nodes[indexA]->output.data[3].value };
-                                        Vector4 vectorB = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value, nodes[indexB]->output.data[3].value };
-                                        Vector4 newVector = ((nodes[i]->type == FNODE_PROJECTION) ? FVector4Projection(vectorA, vectorB) : FVector4Rejection(vectorA, vectorB));
-
-                                        nodes[i]->output.data[0].value = newVector.x;
-                                        nodes[i]->output.data[1].value = newVector.y;
-                                        nodes[i]->output.data[2].value = newVector.z;
-                                        nodes[i]->output.data[3].value = newVector.w;
-
-                                        for (int j = 4; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                        nodes[i]->output.dataCount = 4;
-                                    } break;
-                                    default: break;
-                                }
-                            }
-                            else
-                            {
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                nodes[i]->output.dataCount = 0;
-                            }
-                        } break;
-                        case FNODE_HALFDIRECTION:
+                                for (int j = 4; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                                node->output.dataCount = 4;
+                            } break;
+                            default: break;
+                        }
+                    }
+                    else
+                    {
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                        node->output.dataCount = 0;
+                    }
+                } break;
+                case FNODE_HALFDIRECTION:
+                {
+                    if (node->inputsCount == 2)
+                    {
+                        int indexA = GetNodeIndex(node->inputs[0]);
+                        int indexB = GetNodeIndex(node->inputs[1]);
+
+                        bool check = true;
+                        check = ((nodes[indexA]->type <= FNODE_E) || (nodes[indexA]->type >= FNODE_MATRIX));
+                        if (check) check = ((nodes[indexB]->type <= FNODE_E) || (nodes[indexB]->type >= FNODE_MATRIX));
+
+                        if (check)
                         {
-                            if (nodes[i]->inputsCount == 2)
+                            switch (node->output.dataCount)
                             {
-                                int indexA = GetNodeIndex(nodes[i]->inputs[0]);
-                                int indexB = GetNodeIndex(nodes[i]->inputs[1]);
+                                case 2:
+                                {
+                                    Vector2 a = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value };
+                                    Vector2 b = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value };
+                                    Vector2 vectorA = FVector2Normalize(a);
+                                    Vector2 vectorB = FVector2Normalize(b);
+                                    Vector2 output = { vectorA.x + vectorB.x, vectorA.y + vectorB.y };
 
-                                bool check = true;
-                                check = ((nodes[indexA]->type <= FNODE_E) || (nodes[indexA]->type >= FNODE_MATRIX));
-                                if (check) check = ((nodes[indexB]->type <= FNODE_E) || (nodes[indexB]->type >= FNODE_MATRIX));
+                                    node->output.data[0].value = output.x;
+                                    node->output.data[1].value = output.y;
 
-                                if (check)
+                                    for (int j = 2; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                                    node->output.dataCount = 2;
+                                } break;
+                                case 3:
                                 {
-                                    switch (nodes[i]->output.dataCount)
-                                    {
-                                        case 2:
-                                        {
-                                            Vector2 a = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value };
-                                            Vector2 b = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value };
-                                            Vector2 vectorA = FVector2Normalize(a);
-                                            Vector2 vectorB = FVector2Normalize(b);
-                                            Vector2 output = { vectorA.x + vectorB.x, vectorA.y + vectorB.y };
-
-                                            nodes[i]->output.data[0].value = output.x;
-                                            nodes[i]->output.data[1].value = output.y;
-
-                                            for (int j = 2; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                            nodes[i]->output.dataCount = 2;
-                                        } break;
-                                        case 3:
-                                        {
-                                            Vector3 a = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value };
-                                            Vector3 b = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value };
-                                            Vector3 vectorA = FVector3Normalize(a);
-                                            Vector3 vectorB = FVector3Normalize(b);
-                                            Vector3 output = { vectorA.x + vectorB.x, vectorA.y + vectorB.y, vectorA.z + vectorB.z };
-
-                                            nodes[i]->output.data[0].value = output.x;
-                                            nodes[i]->output.data[1].value = output.y;
-                                            nodes[i]->output.data[2].value = output.z;
-
-                                            for (int j = 3; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                            nodes[i]->output.dataCount = 3;
-                                        } break;
-                                        case 4:
-                                        {
-                                            Vector4 a = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value, nodes[indexA]->output.data[3].value };
-                                            Vector4 b = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value, nodes[indexB]->output.data[3].value };
-                                            Vector4 vectorA = FVector4Normalize(a);
-                                            Vector4 vectorB = FVector4Normalize(b);
-                                            Vector4 output = { vectorA.x + vectorB.x, vectorA.y + vectorB.y, vectorA.z + vectorB.z, vectorA.w + vectorB.w };
-
-                                            nodes[i]->output.data[0].value = output.x;
-                                            nodes[i]->output.data[1].value = output.y;
-                                            nodes[i]->output.data[2].value = output.z;
-                                            nodes[i]->output.data[3].value = output.w;
-
-                                            for (int j = 4; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                            nodes[i]->output.dataCount = 4;
-                                        } break;
-                                        default: break;
-                                    }
-                                }
-                                else
+                                    Vector3 a = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value };
+                                    Vector3 b = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value };
+                                    Vector3 vectorA = FVector3Normalize(a);
+                                    Vector3 vectorB = FVector3Normalize(b);
+                                    Vector3 output = { vectorA.x + vectorB.x, vectorA.y + vectorB.y, vectorA.z + vectorB.z };
+
+                                    node->output.data[0].value = output.x;
+                                    node->output.data[1].value = output.y;
+                                    node->output.data[2].value = output.z;
+
+                                    for (int j = 3; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                                    node->output.dataCount = 3;
+                                } break;
+                                case 4:
                                 {
-                                    for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                }
-                            }
-                            else
-                            {
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                nodes[i]->output.dataCount = 0;
+                                    Vector4 a = { nodes[indexA]->output.data[0].value, nodes[indexA]->output.data[1].value, nodes[indexA]->output.data[2].value, nodes[indexA]->output.data[3].value };
+                                    Vector4 b = { nodes[indexB]->output.data[0].value, nodes[indexB]->output.data[1].value, nodes[indexB]->output.data[2].value, nodes[indexB]->output.data[3].value };
+                                    Vector4 vectorA = FVector4Normalize(a);
+                                    Vector4 vectorB = FVector4Normalize(b);
+                                    Vector4 output = { vectorA.x + vectorB.x, vectorA.y + vectorB.y, vectorA.z + vectorB.z, vectorA.w + vectorB.w };
+
+                                    node->output.data[0].value = output.x;
+                                    node->output.data[1].value = output.y;
+                                    node->output.data[2].value = output.z;
+                                    node->output.data[3].value = output.w;
+
+                                    for (int j = 4; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                                    node->output.dataCount = 4;
+                                } break;
+                                default: break;
                             }
                         }
-                        case FNODE_SAMPLER2D:
+                        else
                         {
-                            if (nodes[i]->inputsCount == 2)
-                            {
-                                int indexA = GetNodeIndex(nodes[i]->inputs[1]);
-                                switch ((int)nodes[indexA]->output.data[0].value)
-                                {
-                                    case 0: nodes[i]->output.dataCount = 4; break;
-                                    case 1: nodes[i]->output.dataCount = 3; break;
-                                    default: nodes[i]->output.dataCount = 1; break;
-                                }
-                            }
-                            else
-                            {
-                                for (int j = 0; j < MAX_VALUES; j++) nodes[i]->output.data[j].value = 0.0f;
-                                nodes[i]->output.dataCount = 0;
-                            }
-                        } break;
-                        default: break;
+                            for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                        }
+                    }
+                    else
+                    {
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                        node->output.dataCount = 0;
                     }
                 }
-                else
+                case FNODE_SAMPLER2D:
+                case FNODE_SAMPLERLOD:
+                case FNODE_SAMPLERBIAS:
+                case FNODE_SAMPLERGRAD:
                 {
-                    for (int k = 0; k < MAX_VALUES; k++) nodes[i]->output.data[k].value = 0.0f;
-                    nodes[i]->output.dataCount = 0;
-                }
+                    if (node->inputsCount >= 2)
+                    {
+                        int indexA = GetNodeIndex(node->inputs[1]);
+                        switch ((int)nodes[indexA]->output.data[0].value)
+                        {
+                            case 0: node->output.dataCount = 4; break;
+                            case 1: node->output.dataCount = 3; break;
+                            default: node->output.dataCount = 1; break;
+                        }
+                    }
+                    else
+                    {
+                        for (int j = 0; j < MAX_VALUES; j++) node->output.data[j].value = 0.0f;
+                        node->output.dataCount = 0;
+                    }
+                } break;
+                case FNODE_FUNCTION: CalculateFunctionValues(node); break;
+                default: break;
             }
+        }
+        else
+        {
+            for (int k = 0; k < MAX_VALUES; k++) node->output.data[k].value = 0.0f;
+            node->output.dataCount = 0;
+        }
+    }
+
+    if (node->type > FNODE_VECTOR4)
+    {
+        for (int k = 0; k < node->output.dataCount; k++) FFloatToString(node->output.data[k].valueText, node->output.data[k].value);
+    }
+
+    UpdateNodeShapes(node);
+}
+
+// Calculates a function node output values evaluating its library function body
+FNODEDEF void CalculateFunctionValues(FNode node)
+{
+    // Function nodes without library function are only kept while loading until they are skipped
+    if ((node->function >= 0) && (node->function < functionsCount))
+    {
+        FFunction function = functions[node->function];
+
+        // Function inputs keep their declared values count so CPU values match the generated GLSL function
+        for (int i = 0; i < function->inputsCount; i++)
+        {
+            FNode input = function->nodes[i];
+            for (int k = 0; k < MAX_VALUES; k++) input->output.data[k].value = 0.0f;
 
-            if (nodes[i]->type > FNODE_VECTOR4)
+            if (i < node->inputsCount)
             {
-                for (int k = 0; k < nodes[i]->output.dataCount; k++) FFloatToString(nodes[i]->output.data[k].valueText, nodes[i]->output.data[k].value);
-            }
+                int index = GetNodeIndex(node->inputs[i]);
+                int count = nodes[index]->output.dataCount;
 
-            UpdateNodeShapes(nodes[i]);
+                // Vectors are truncated or padded with zeros and matrices are only passed to matrix inputs
+                if ((count == input->output.dataCount) || ((count != 16) && (input->output.dataCount != 16)))
+                {
+                    for (int k = 0; (k < input->output.dataCount) && (k < count); k++) input->output.data[k].value = nodes[index]->output.data[k].value;
+                }
+            }
         }
-        else TraceLogFNode(true, "error trying to calculate values for a null referenced node");
+
+        // Function body nodes are calculated in their cached evaluation order
+        BeginFunctionBody(function);
+        for (int i = function->inputsCount; i < nodesCount; i++) CalculateNodeValues(nodes[i]);
+        EndFunctionBody();
+
+        FNode output = function->nodes[function->nodesCount - 1];
+        node->output.dataCount = output->output.dataCount;
+        for (int k = 0; k < MAX_VALUES; k++) node->output.data[k].value = output->output.data[k].value;
+    }
+}
+
+// Replaces graph nodes and lines pools by a function body pools
+FNODEDEF void BeginFunctionBody(FFunction function)
+{
+    if (bodyFunction == NULL)
+    {
+        bodyFunction = function;
+
+        graphNodesCount = nodesCount;
+        for (int i = 0; i < nodesCount; i++) graphNodes[i] = nodes[i];
+        graphLinesCount = linesCount;
+        for (int i = 0; i < linesCount; i++) graphLines[i] = lines[i];
+
+        nodesCount = function->nodesCount;
+        for (int i = 0; i < nodesCount; i++) nodes[i] = function->nodes[i];
+        linesCount = function->linesCount;
+        for (int i = 0; i < linesCount; i++) lines[i] = function->lines[i];
+    }
+    else TraceLogFNode(true, "error trying to evaluate function %s inside function %s body", function->name, bodyFunction->name);
+}
+
+// Stores current pools as function body pools and restores graph nodes and lines pools
+FNODEDEF void EndFunctionBody()
+{
+    if (bodyFunction != NULL)
+    {
+        if ((nodesCount > MAX_FUNCTION_NODES) || (linesCount > MAX_FUNCTION_NODES*MAX_INPUTS)) TraceLogFNode(true, "error trying to store function %s body with %i nodes", bodyFunction->name, nodesCount);
+
+        bodyFunction->nodesCount = nodesCount;
+        for (int i = 0; i < nodesCount; i++) bodyFunction->nodes[i] = nodes[i];
+        bodyFunction->linesCount = linesCount;
+        for (int i = 0; i < linesCount; i++) bodyFunction->lines[i] = lines[i];
+
+        nodesCount = graphNodesCount;
+        for (int i = 0; i < nodesCount; i++) nodes[i] = graphNodes[i];
+        linesCount = graphLinesCount;
+        for (int i = 0; i < linesCount; i++) lines[i] = graphLines[i];
+
+        bodyFunction = NULL;
     }
+    else TraceLogFNode(true, "error trying to restore graph pools without a function body");
 }
 
 // Draws a previously created node
@@ -1716,7 +1917,9 @@ FNODEDEF void DrawNode(FNode node)
 {
     if (node != NULL)
     {
-        if (node->property) DrawRectangleRec(node->shape, ((node->id == selectedNode) ? (Color){ 128, 204, 139, 255 } : (Color){ 173, 225, 181, 255 }));
+        if (node->staticProperty) DrawRectangleRec(node->shape, ((node->id == selectedNode) ? (Color){ 204, 185, 128, 255 } : (Color){ 225, 213, 173, 255 }));
+        else if (node->instanceProperty) DrawRectangleRec(node->shape, ((node->id == selectedNode) ? (Color){ 128, 170, 204, 255 } : (Color){ 173, 201, 225, 255 }));
+        else if (node->property) DrawRectangleRec(node->shape, ((node->id == selectedNode) ? (Color){ 128, 204, 139, 255 } : (Color){ 173, 225, 181, 255 }));
         else DrawRectangleRec(node->shape, ((node->id == selectedNode) ? GRAY : LIGHTGRAY));
         DrawRectangleLines(node->shape.x, node->shape.y, node->shape.width, node->shape.height, BLACK);
         DrawText(FormatText("%s [ID: %i]", node->name, node->id), node->shape.x + node->shape.width/2 - MeasureText(node->name, 10)/2, node->shape.y - 15, 10, BLACK);
@@ -1755,6 +1958,7 @@ FNODEDEF void DrawNode(FNode node)
                             FFloatToString(node->output.data[editNodeType].valueText, node->output.data[editNodeType].value);
 
                             CalculateValues();
+                            changedNode = node->id;
                         }
                         else
                         {
@@ -1945,6 +2149,43 @@ FNODEDEF void DrawNodeLine(FLine line)
                     if ((nodes[indexTo]->inputsCount > 0) && (nodes[indexTo]->inputs[0] == nodes[indexFrom]->id)) DrawText("Unit", from.x + 5, from.y - 30, 10, BLACK);
                     else if ((nodes[indexTo]->inputsCount > 1) && (nodes[indexTo]->inputs[1] == nodes[indexFrom]->id)) DrawText("Type", from.x + 5, from.y - 30, 10, BLACK);
                 } break;
+                case FNODE_SAMPLERLOD:
+                case FNODE_SAMPLERBIAS:
+                case FNODE_SAMPLERGRAD:
+                {
+                    if ((nodes[indexTo]->inputsCount > 0) && (nodes[indexTo]->inputs[0] == nodes[indexFrom]->id)) DrawText("Unit", from.x + 5, from.y - 30, 10, BLACK);
+                    else if ((nodes[indexTo]->inputsCount > 1) && (nodes[indexTo]->inputs[1] == nodes[indexFrom]->id)) DrawText("Type", from.x + 5, from.y - 30, 10, BLACK);
+                    else if ((nodes[indexTo]->inputsCount > 2) && (nodes[indexTo]->inputs[2] == nodes[indexFrom]->id))
+                    {
+                        if (nodes[indexTo]->type == FNODE_SAMPLERLOD) DrawText("LOD", from.x + 5, from.y - 30, 10, BLACK);
+                        else if (nodes[indexTo]->type == FNODE_SAMPLERBIAS) DrawText("Bias", from.x + 5, from.y - 30, 10, BLACK);
+                        else DrawText("dUV/dx", from.x + 5, from.y - 30, 10, BLACK);
+                    }
+                    else if ((nodes[indexTo]->inputsCount > 3) && (nodes[indexTo]->inputs[3] == nodes[indexFrom]->id)) DrawText("dUV/dy", from.x + 5, from.y - 30, 10, BLACK);
+                } break;
+                case FNODE_LUT:
+                {
+                    if ((nodes[indexTo]->inputsCount > 0) && (nodes[indexTo]->inputs[0] == nodes[indexFrom]->id)) DrawText("Value", from.x + 5, from.y - 30, 10, BLACK);
+                    else if ((nodes[indexTo]->inputsCount > 1) && (nodes[indexTo]->inputs[1] == nodes[indexFrom]->id)) DrawText("X", from.x + 5, from.y - 30, 10, BLACK);
+                    else if ((nodes[indexTo]->inputsCount > 2) && (nodes[indexTo]->inputs[2] == nodes[indexFrom]->id)) DrawText("Domain (min, max, size, unit)", from.x + 5, from.y - 30, 10, BLACK);
+                    else if ((nodes[indexTo]->inputsCount > 3) && (nodes[indexTo]->inputs[3] == nodes[indexFrom]->id)) DrawText("Y", from.x + 5, from.y - 30, 10, BLACK);
+                } break;
+                case FNODE_OPTIONAL:
+                {
+                    if ((nodes[indexTo]->inputsCount > 0) && (nodes[indexTo]->inputs[0] == nodes[indexFrom]->id)) DrawText("Detail", from.x + 5, from.y - 30, 10, BLACK);
+                    else if ((nodes[indexTo]->inputsCount > 1) && (nodes[indexTo]->inputs[1] == nodes[indexFrom]->id)) DrawText("Fallback", from.x + 5, from.y - 30, 10, BLACK);
+                } break;
+                case FNODE_FUNCTION:
+                {
+                    for (int i = 0; i < nodes[indexTo]->inputsCount; i++)
+                    {
+                        if (nodes[indexTo]->inputs[i] == nodes[indexFrom]->id)
+                        {
+                            DrawText(FormatText("Input %i", i), from.x + 5, from.y - 30, 10, BLACK);
+                            break;
+                        }
+                    }
+                } break;
                 default: break;
             }
         }
@@ -2098,13 +2339,11 @@ FNODEDEF bool FToggle(Rectangle bounds, bool toggle)
             {
                 toggle = false;
                 toggleState = TOGGLE_UNACTIVE;
-                glDisable(GL_CULL_FACE);
             }
             else
             {
                 toggle = true;
                 toggleState = TOGGLE_ACTIVE;
-                glEnable(GL_CULL_FACE);
             }
         }
     }
@@ -2247,6 +2486,37 @@ FNODEDEF void DestroyComment(FComment comment)
     else TraceLogFNode(true, "error trying to destroy a null referenced comment");
 }
 
+// Destroys a library function with its body nodes, lines and source
+FNODEDEF void DestroyFunction(FFunction function)
+{
+    if (function != NULL)
+    {
+        for (int i = 0; i < function->nodesCount; i++)
+        {
+            for (int k = 0; k < MAX_VALUES; k++)
+            {
+                FNODE_FREE(function->nodes[i]->output.data[k].valueText);
+                usedMemory -= MAX_NODE_LENGTH;
+            }
+
+            FNODE_FREE(function->nodes[i]);
+            usedMemory -= sizeof(FNodeData);
+        }
+
+        for (int i = 0; i < function->linesCount; i++)
+        {
+            FNODE_FREE(function->lines[i]);
+            usedMemory -= sizeof(FLineData);
+        }
+
+        if (function->source != NULL) FNODE_FREE(function->source);
+
+        FNODE_FREE(function);
+        usedMemory -= sizeof(FFunctionData);
+    }
+    else TraceLogFNode(true, "error trying to destroy a null referenced function");
+}
+
 // Unitializes FNode global variables
 FNODEDEF void CloseFNode()
 {
@@ -2280,6 +2550,12 @@ FNODEDEF void CloseFNode()
         }
     }
 
+    for (int i = 0; i < functionsCount; i++)
+    {
+        DestroyFunction(functions[i]);
+        functions[i] = NULL;
+    }
+
     for (int i = 0; i < commentsCount; i++)
     {
         if ((comments[i] != NULL) && (comments[i]->value != NULL))
@@ -2304,6 +2580,7 @@ FNODEDEF void CloseFNode()
     nodesCount = 0;
     linesCount = 0;
     commentsCount = 0;
+    functionsCount = 0;
     selectedCommentNodesCount = 0;
     for (int i = 0; i < MAX_NODES; i++) selectedCommentNodes[i] = -1;
 
@@ -2614,6 +2891,26 @@ static Matrix FMatrixScale(float x, float y, float z)
     return result;
 }
 
+// Returns perspective projection matrix
+static Matrix FMatrixFrustum(double left, double right, double bottom, double top, double near, double far)
+{
+    Matrix result = { 0 };
+
+    float rl = (right - left);
+    float tb = (top - bottom);
+    float fn = (far - near);
+
+    result.m0 = (near*2.0f)/rl;
+    result.m5 = (near*2.0f)/tb;
+    result.m8 = (right + left)/rl;
+    result.m9 = (top + bottom)/tb;
+    result.m10 = -(far + near)/fn;
+    result.m11 = -1.0f;
+    result.m14 = -(far*near*2.0f)/fn;
+
+    return result;
+}
+
 // Transposes provided matrix
 static void FMatrixTranspose(Matrix *mat)
 {
@@ -43,7 +43,58 @@
 #define     VERTEX_PATH                 "output/shader.vs"                  // Vertex shader output path
 #define     FRAGMENT_PATH               "output/shader.fs"                  // Fragment shader output path
 #define     DATA_PATH                   "output/shader.fnode"               // Shader data output path
+#define     LOD_VERTEX_PATH             "output/shader_lod%i.vs"            // Lower level of detail vertex shader output path
+#define     LOD_FRAGMENT_PATH           "output/shader_lod%i.fs"            // Lower level of detail fragment shader output path
+#define     REFLECTION_PATH             "output/shader.json"                // Shader reflection metadata output path
+#define     REFLECTION_HEADER_PATH      "output/shader.h"                   // Shader reflection C header output path
+#define     LOD_REFLECTION_PATH         "output/shader_lod%i.json"          // Lower level of detail shader reflection metadata output path
+#define     LOD_REFLECTION_HEADER_PATH  "output/shader_lod%i.h"             // Lower level of detail shader reflection C header output path
+#define     DEPTH_VERTEX_PATH           "output/shader_depth.vs"            // Depth only variant vertex shader output path
+#define     DEPTH_FRAGMENT_PATH         "output/shader_depth.fs"            // Depth only variant fragment shader output path
+#define     DEPTH_REFLECTION_PATH       "output/shader_depth.json"          // Depth only variant shader reflection metadata output path
+#define     DEPTH_REFLECTION_HEADER_PATH "output/shader_depth.h"            // Depth only variant shader reflection C header output path
+#define     MAX_LODS                    3                                   // Number of level of detail shader variants (level 0 is full detail)
+#define     DEPTH_VARIANT               MAX_LODS                            // Depth only shader variant index (after level of detail variants)
+#define     MAX_VARIANTS                (MAX_LODS + 1)                      // Number of shader variants (levels of detail and depth only variant)
+#define     LOD_BUDGET_SCALE            0.5f                                // Default fragment cost budget of a level of detail relative to previous level
+#define     FUNCTIONS_PATH              "output/functions.fnode"            // Library functions bodies data path
+#define     MAX_FUNCTION_SOURCE         8192                                // Max length of a library function generated GLSL code
+#define     PERMUTATIONS_PATH           "output/shader.permutations"        // Used static properties permutations output path
+#define     PACK_PATH                   "output/shader.pack"                // Packed dropped textures layout output path (alongside shader data file)
+#define     MAX_STATIC_NODES            8                                   // Max static property nodes selecting shader permutations
+#define     MAX_PERMUTATIONS            16                                  // Max static properties values combinations kept in permutation cache
+#define     MAX_INSTANCE_PROPERTIES     5                                   // Max per instance property nodes compiled as instance attributes
+#define     INSTANCE_LOCATION           6                                   // First instance attribute location (after raylib default vertex attributes)
+#define     INSTANCE_STRIDE             40                                  // Visor instances buffer floats per instance (transform, tint and properties)
+#define     INSTANCE_GRID               32                                  // Visor instanced stress scene instances per row
+#define     INSTANCE_SPACING            1.5f                                // Visor instanced stress scene distance between instances
+#define     INSTANCE_MODEL_SCALE        2.5f                                // Visor instanced stress scene model scale
+#define     FRAME_BLOCK_BINDING         0                                   // Shared per frame uniform block binding point
+#define     MATERIAL_BLOCK_BINDING      1                                   // Per material uniform block binding point
+#define     FRAME_UNIFORM_LOCATION      0                                   // First per frame uniform explicit location (mvp, modelMatrix, viewDirection, vertCurrentTime and fragCurrentTime)
+#define     VALUE_UNIFORM_LOCATION      8                                   // First value uniform explicit location (offset by node id)
+#define     FRAME_BLOCK_SIZE            96                                  // Per frame uniform block std140 size (model matrix, view direction and times)
+#define     MAX_BLOCK_SIZE              (MAX_NODES*64)                      // Max per material uniform block std140 size
+#define     MAX_BATCH_GRAPHS            64                                  // Max shader graphs compiled by a command line batch compile
+#define     PROGRAM_PATH                "output/program_%08x%s"             // Batch compile shared program files output path (canonical graph hash and variant suffix)
+#define     MANIFEST_PATH               "output/programs.manifest"          // Batch compile materials to shared programs manifest output path
+#define     MAX_SHADER_VARIABLES        256                                 // Max attributes, varyings, uniforms and samplers described by shader reflection
 #define     MAX_TEXTURES                30                                  // Shader maximum texture units
+#define     MAX_PACK_SIZE               4096                                // Max packed dropped textures atlas width and height
+#define     PACK_PADDING                2                                   // Packed textures atlas padding filled with their border texels to avoid filtering bleeding
+#define     MAX_HOISTED_VARYINGS        8                                   // Max number of fragment graph nodes moved to vertex shader as varyings
+#define     TEXCOORD_VARYING            MAX_NODES                           // Packed varyings index of texture coordinates (after nodes ids)
+#define     LOWP_RANGE                  2.0f                                // GLSL 100 lowp guaranteed float range
+#define     MEDIUMP_RANGE               16384.0f                            // GLSL 100 mediump guaranteed float range
+#define     UNBOUNDED_RANGE             1000000.0f                          // Range estimation used for values without known bounds
+#define     MAX_INLINE_LENGTH           128                                 // Max length of a node expression inlined into its consumer expression
+#define     COST_ALU                    1                                   // Cost model weight of an arithmetic instruction
+#define     COST_TRANSCENDENTAL         4                                   // Cost model weight of a transcendental instruction (quarter rate)
+#define     COST_TEXTURE                8                                   // Cost model weight of a texture fetch
+#define     COST_DISCARD                4                                   // Cost model weight of a fragment discard (disables early depth test)
+#define     MAX_LUT_RESOLUTION          256                                 // Max resolution of a baked 1D lookup table texture
+#define     MAX_LUT_RESOLUTION_2D       64                                  // Max resolution per axis of a baked 2D lookup table texture
+#define     LUT_ERROR_SAMPLES           2                                   // Analytic samples per lookup table texel and axis to measure its interpolation error
 #define     COMPILE_DURATION            120                                 // Shader compile result duration
 #define     MODEL_PATH                  "res/meshes/plant.obj"              // Example model file path
 #define     MODEL_TEXTURE_DIFFUSE       "res/textures/plant_color.png"      // Example model color texture file path
@@ -64,7 +115,7 @@ float modelRotation = 0.0f;                 // Current model visualization rotat
 int scrollState = 0;                        // Current mouse drag interface scroll state
 Vector2 canvasSize;                         // Interface screen size
 float menuScroll = 10.0f;                   // Current interface scrolling amount
-Vector2 scrollLimits = { 10, 1385 };        // Interface scrolling limits
+Vector2 scrollLimits = { 10, 1770 };        // Interface scrolling limits (increased by each library function button)
 Rectangle menuScrollRec = { 0, 0, 0, 0 };   // Interface scroll rectangle bounds
 Vector2 menuScrollLimits = { 5, 685 };      // Interface scroll rectangle position limits
 Rectangle canvasScroll = { 0, 0, 0, 0 };    // Interface scroll rectangle bounds
@@ -77,18 +128,92 @@ int viewUniform = -1;                       // Created shader view direction uni
 int transformUniform = -1;                  // Created shader model transform uniform location point
 int timeUniformV = -1;                      // Created shader current time uniform location point in vertex shader
 int timeUniformF = -1;                      // Created shader current time uniform location point in fragment shader
+int valueUniforms[MAX_NODES];               // Created shader constant values uniform location points by node id
+ShaderStage nodeStages[MAX_NODES];          // Fragment graph nodes evaluation stage by node id
+bool hoistedNodes[MAX_NODES];               // Fragment graph nodes moved out of fragment shader by node id (as per frame uniforms or varyings)
+int frameOrder[MAX_NODES];                  // Hoisted per frame nodes and their inputs node ids in evaluation order
+int frameOrderCount = 0;                    // Hoisted per frame nodes and their inputs count
+bool reachableNodes[MAX_NODES];             // Nodes reachable from vertex or fragment output nodes by node id
+bool foldedNodes[MAX_NODES];                // Constant subgraph nodes declared with their CPU calculated values by node id
+int mergedNodes[MAX_NODES];                 // Structurally identical nodes representative node id by node id
+unsigned int nodeHashes[MAX_NODES];         // Nodes operation and inputs hash used to find structurally identical nodes by node id
+bool declaredNodes[MAX_NODES];              // Current shader file compiled nodes by node id
+bool declaredConstants[MAX_NODES];          // Current shader file checked constant nodes by node id
+bool inlinedNodes[MAX_NODES];               // Current shader file nodes waiting to be inlined into their consumer by node id
+char inlinedExpressions[MAX_NODES][MAX_INLINE_LENGTH]; // Current shader file inlined nodes expression by node id
+bool writtenFunctions[MAX_FUNCTIONS];       // Current shader file written library functions by function index
+int focusedNode = -1;                       // Last selected node id used by node actions (collapse into function)
+Precision nodePrecisions[MAX_NODES];        // Fragment shader nodes selected precision by node id
+float nodeRanges[MAX_NODES];                // Fragment shader nodes max absolute value estimation by node id
+bool vertexStageNodes[MAX_NODES];           // Current shader variant nodes which vertex shader can declare by node id
+bool fragmentStageNodes[MAX_NODES];         // Current shader variant nodes which fragment shader can declare by node id
+ShaderCost nodeCosts[MAX_NODES];            // Current shader compiled nodes cost by node id
+Vector4 lutDomains[MAX_NODES];              // Current shader compiled lookup table nodes domain (min, max, resolution, unit) by node id
+unsigned int lutHashes[MAX_NODES];          // Baked lookup table nodes input subgraph hash by node id
+int lutOwners[MAX_TEXTURES];                // Baked lookup table node id owning each texture unit texture (-1 for loaded and dropped textures)
+float averageValues[MAX_NODES][4];          // Nodes output values estimation with texture samples replaced by their texture average color by node id
+bool approximatedNodes[MAX_NODES];          // Current level of detail nodes declared with their average values by node id
+int lodBudgets[MAX_LODS] = { -1, -1, -1 };  // Level of detail variants fragment cost budget (negative scales full detail cost)
+int previewLod = 0;                         // Current visor level of detail variant
+int staticNodes[MAX_STATIC_NODES];          // Current graph static property node ids sorted by id
+int staticNodesCount = 0;                   // Current graph static property nodes count
+int permutationValues[MAX_PERMUTATIONS][MAX_STATIC_NODES]; // Used permutations static property values
+unsigned int permutationHashes[MAX_PERMUTATIONS]; // Graph hash which permutation cache sources were compiled from
+char *permutationSources[MAX_PERMUTATIONS][MAX_VARIANTS][2]; // Permutation cache vertex and fragment shader sources by shader variant
+int permutationsCount = 0;                  // Used permutations count
+unsigned int programHash = 0;               // Batch compile shared program canonical hash reflection headers are written for (0 for single shader)
+bool depthVariant = false;                  // Current shader depth only variant state (vertex displacement or alpha tested fragments)
+bool instancing = false;                    // Current shader instancing setting (per instance transform, tint and properties attributes)
+bool instancedShader = false;               // Current visor shader compiled with instancing state
+int instanceNodes[MAX_INSTANCE_PROPERTIES]; // Current shader per instance property node ids sorted by id
+int instanceNodesCount = 0;                 // Current shader per instance property nodes count
+unsigned int instanceBuffer = 0;            // Visor instanced stress scene instances attributes buffer object
+int mvpUniform = -1;                        // Created shader model view projection uniform location point (instanced visor)
+int samplerUniforms[MAX_TEXTURES];          // Created shader texture units sampler uniform location points (instanced visor)
+bool uniformBlocks = false;                 // Current shader std140 uniform blocks setting (per frame and per material blocks instead of uniforms)
+bool blockShader = false;                   // Current visor shader compiled with uniform blocks state
+int varyingPacks[MAX_NODES + 1];            // Current shader variant packed varying index of hoisted nodes by node id and texture coordinates (-1 if not packed)
+int varyingOffsets[MAX_NODES + 1];          // Current shader variant packed varyings first component by node id and texture coordinates
+int packsCount = 0;                         // Current shader variant packed vec4 varyings count
+bool blockNodes[MAX_NODES];                 // Current shader uniform blocks member nodes by node id
+bool frameNodes[MAX_NODES];                 // Current shader hoisted per frame nodes declared in per frame uniform block by node id
+int blockOffsets[MAX_NODES];                // Current shader uniform blocks members std140 offset by node id
+int frameBlockSize = FRAME_BLOCK_SIZE;      // Current shader per frame uniform block std140 size (shared members and hoisted per frame nodes)
+float frameBlock[MAX_BLOCK_SIZE/4];         // Per frame uniform block data sent to the shared uniform buffer
+int materialBlockSize = 0;                  // Current shader per material uniform block std140 size
+float materialBlock[MAX_BLOCK_SIZE/4];      // Per material uniform block data sent to its uniform buffer
+bool materialBlockChanged = false;          // Per material uniform block data changed since last buffer update
+unsigned int frameBuffer = 0;               // Shared per frame uniform buffer object
+unsigned int materialBuffer = 0;            // Per material uniform buffer object
+ShaderCost vertexCost = { 0 };              // Current shader vertex stage cost
+ShaderCost fragmentCost = { 0 };            // Current shader fragment stage cost
 bool loadedShader = false;                  // Current loaded custom shader state
 float currentTime = 0;                      // Current global time to send to shader as attribute
 char **droppedFiles;                        // Current dropped files paths
 Texture2D textures[MAX_TEXTURES] = { 0 };   // Shader texture unit textures
 int loadedFiles = 0;                        // Loaded textures count
 bool usedUnits[MAX_TEXTURES] = { false };   // Shader compiling used texture units
+bool fetchedUnits[MAX_TEXTURES] = { false }; // Current shader file texture units already sampled into a shared texel
+char texturePaths[MAX_TEXTURES][256] = { { '\0' } }; // Dropped textures file paths by texture unit (empty for default and baked textures)
+TexturePacking texturePacking = PACKING_NONE; // Current dropped textures packing setting (atlas or texture array)
+TexturePacking packedMode = PACKING_NONE;   // Current packed textures mode (atlas when shader version has no texture arrays)
+bool packChanged = false;                   // Dropped textures changed since they were packed
+Texture2D packTexture = { 0 };              // Packed dropped textures atlas or texture array
+int packUnit = -1;                          // Packed textures atlas or texture array texture unit (-1 if textures are not packed)
+bool packedUnits[MAX_TEXTURES] = { false }; // Texture units sampled from packed textures
+int packLayers[MAX_TEXTURES];               // Packed textures texture array layer (or atlas packing order) by texture unit
+Rectangle packRects[MAX_TEXTURES];          // Packed textures atlas rectangles in pixels by texture unit
+int packUniform = -1;                       // Created shader packed texture array sampler uniform location point
 bool fullVisor = false;                     // Visor full screen state
 bool help = false;                          // Display help message state
 bool visorState = false;                    // Visor camera control state
 bool settings = false;                      // Interface settings window state
-ShaderVersion version = GLSL_330;           // Current shader version setting
+ShaderVersion version = GLSL_330;           // Current shader version setting (build target of command line compiler)
+CompileMode compileMode = COMPILE_AUTHORING; // Current shader compile mode setting (authoring keeps constant values as uniforms)
+Precision precisionMode = PRECISION_AUTO;   // Current GLSL 100 and GLSL ES 300 fragment shader precision setting (auto selects precision per node)
 bool backfaceCulling = false;               // Current shader backface culling state
+bool costHeatmap = false;                   // Canvas nodes fragment cost heatmap state
+bool unusedHighlight = false;               // Canvas nodes unreachable from output nodes highlight state
 int compileState = -1;                      // Compile state (awiting, successful, failed)
 int framesCounter = 0;                      // Global frames counter
 int compileFrame = 0;                       // Compile time frames count
@@ -97,7 +222,18 @@ Texture2D iconTex;                          // FNode icon texture used in help m
 //----------------------------------------------------------------------------------
 // Functions Declaration
 //----------------------------------------------------------------------------------
-void CheckPreviousShader();                                 // Check if there are a compatible shader in output folder
+void CheckPreviousShader(bool makeGraph);                   // Check if there are a compatible shader in output folder
+bool LoadGraph(const char *path);                           // Loads a shader graph nodes and lines from a data file
+void ReadGraphData(FILE *file);                             // Reads nodes and lines from a data file into current nodes and lines pools
+void WriteGraphData(FILE *file);                            // Writes current nodes and lines pools in a data file sorted by id
+void LoadFunctions();                                       // Loads library functions bodies and generates their GLSL code
+FFunction AddFunction(const char *name, int inputs);        // Adds an empty library function with a name and declared inputs count
+int GetFunctionIndex(const char *name);                     // Returns the index of a library function by its name
+bool IsFunctionNameValid(const char *name);                 // Check if a library function name can be part of a GLSL identifier
+void CompileFunction(FFunction function);                   // Generates a library function GLSL code, cost and CPU exactness from its body
+void SaveFunction(FFunction function);                      // Appends a library function body to library functions data file
+void CacheValueUniforms();                                  // Caches constant values uniform locations and sends their current values
+void SetValueUniform(FNode node);                           // Sends a constant value node current values to its shader uniform
 void UpdateMouseData();                                     // Updates current mouse position and delta position
 void UpdateInputsData();                                    // Updates current inputs states
 void UpdateScroll();                                        // Updates mouse scrolling for menu and canvas drag
@@ -108,15 +244,139 @@ void UpdateCommentCreationEdit();                           // Check comment cre
 void UpdateCommentsDrag();                                  // Check comment drag input
 void UpdateCommentsEdit();                                  // Check comment text edit input
 void UpdateShaderData();                                    // Update required values to created shader for geometry data calculations
+void EvaluateNode(FNode node);                              // Calculates a node and its inputs output values in CPU
+void SortFrameNodes();                                      // Sorts hoisted per frame nodes and their inputs in evaluation order to calculate them once per frame
+void AddFrameNode(FNode node, bool *visited);               // Adds a node after its inputs to per frame nodes evaluation order
+int MarkReachableNodes();                                   // Marks nodes reachable from output nodes and returns the number of unreachable nodes
+void FoldNodes();                                           // Marks operator nodes with only constant inputs to declare them with their CPU calculated values
+bool IsNodeFoldable(FNode node);                            // Check if an operator node can be declared as a constant with its CPU calculated values
+void MergeNodes();                                          // Links consumers of structurally identical nodes to a single representative node while compiling
+int GetMergedNode(FNode node);                              // Returns the representative node id of a node and all its structurally identical nodes
+unsigned int GetNodeHash(FNode node);                       // Returns a hash of a node operation, values count and representative inputs
+bool IsNodeEqual(FNode a, FNode b);                         // Check if two nodes compute the same values from the same representative inputs
+void GetMergedInputs(FNode node, int *inputs);              // Returns a node inputs representative node ids (sorted for commutative operations)
+bool IsNodeCommutative(FNode node);                         // Check if a node operation result does not depend on its inputs order
+void PlaceNodes();                                          // Computes fragment graph nodes evaluation stage and marks nodes to hoist out of fragment shader
+ShaderStage PlaceNode(FNode node);                          // Returns the cheapest stage where a fragment graph node can be evaluated
+bool IsNodeHoistable(FNode node);                           // Check if a node CPU calculated values match its GLSL operation
+bool IsNodeLinear(FNode node, ShaderStage *stages);         // Check if a node operation is linear in its per vertex inputs
+int CountNodeInstructions(FNode node, bool *counted, bool hoisting); // Returns instructions count of a node and its inputs in fragment shader
+ShaderCost GetNodeCost(FNode node);                         // Returns the cost of a node operation based on its type and output data count
+int GetCostTotal(ShaderCost cost);                          // Returns the weighted total of a shader cost
+void AddNodeCost(FNode node, ShaderCost cost, bool fragment); // Adds a compiled node cost to its shader stage cost
+const char *GetDataTypeName(int dataCount);                 // Returns GLSL data type name of an output values count
+Precision GetNodePrecision(FNode node);                     // Returns the lowest precision which fits a node values range and source
+const char *GetPrecisionQualifier(FNode node, bool fragment); // Returns GLSL 100 and GLSL ES 300 precision qualifier of a node declaration
+const char *GetUniformPrecision(FNode node, bool fragment);  // Returns GLSL 100 and GLSL ES 300 precision qualifier of a value uniform declaration
+void MarkStageNodes(FNode node, bool *stage);               // Marks a node and its inputs as nodes a shader stage can declare
 void CompileShader();                                       // Compiles all node structure to create the GLSL fragment shader in output folder
-void CheckConstant(FNode node, FILE *file);                 // Check nodes searching for constant values to define them in shaders
+void CompileShaderVariant(int lod, FILE *vertexFile, FILE *fragmentFile); // Compiles vertex and fragment shaders code of a level of detail or depth only variant
+bool IsDepthVariantNeeded();                                // Check if graph needs a depth only variant (vertex displacement or alpha tested fragments)
+bool IsVertexDisplaced(FNode node);                         // Check if a vertex graph node computes more than model view projection transform of vertex position
+void CollectAlphaTests(FNode node, int *samplers, bool *visited); // Collects fragment graph sampler node ids which discard transparent fragments by texture unit
+void CompileAlphaTests(FILE *declarationsFile, FILE *mainFile); // Compiles depth only variant fragment shader alpha tests declarations and main function body
+void WriteShaderHeader(FILE *file, bool fragment, bool textureLod, bool highp); // Writes shader credits, version, default precision, high precision qualifier and texture level of detail extension header
+int GetVersionNumber();                                     // Returns GLSL version number of current shader version setting
+bool HasExplicitLocations();                                // Returns true if current shader version declares attributes and outputs locations
+void WriteUniformLayout(FILE *file, int location, bool sampler); // Writes a uniform explicit location or sampler binding layout qualifier (GLSL 430)
+bool IsNameUsed(const char *code, const char *name);        // Check if a GLSL identifier is used in shader code (not only as part of a longer identifier)
+void PackVaryings(bool texCoord);                           // Assigns packed vec4 varyings components to used scalar and vec2 varyings
+void GetVaryingName(int varying, char *name);               // Returns a hoisted node (or texture coordinates) varying name or packed varying components expression
+const char *GetPackPrecision(int pack);                     // Returns GLSL 100 and GLSL ES 300 precision qualifier of a packed varying
+void WriteShaderFiles();                                    // Writes levels of detail and depth only shader files selecting used permutations cached code with preprocessor conditions
+int GetPermutation();                                       // Collects static property nodes and returns their current values permutation index adding it to used permutations
+void CompilePermutation(int permutation, unsigned int hash); // Compiles all levels of detail code of a permutation into permutation cache
+void LoadPermutations();                                    // Loads used permutations from permutations file if they match current static property nodes
+void SavePermutations();                                    // Saves used permutations static property values in permutations file
+void ClearPermutation(int permutation);                     // Frees a permutation cached shaders code
+unsigned int GetGraphHash();                                // Returns a hash of graph nodes, lines, textures and compile settings ignoring static property values
+void CanonicalizeGraph();                                   // Destroys unreachable nodes and renumbers nodes and lines in an order independent of their ids and positions
+unsigned int GetShapeHash(FNode node, unsigned int *hashes, bool *hashed); // Returns a hash of a node subgraph operations and values independent of node ids
+void GetCanonicalInputs(FNode node, unsigned int *hashes, int *inputs); // Returns a node inputs ids in canonical order (sorted by subgraph hash for commutative operations)
+int OrderCanonicalNodes(FNode node, unsigned int *hashes, int *ids, int count); // Assigns canonical ids to a node inputs subgraph in post order and returns next canonical id
+unsigned int GetCanonicalHash();                            // Returns a hash of a canonicalized graph including static property values
+char *GetCanonicalKey();                                    // Returns an allocated text of a canonicalized graph to compare graphs with the same canonical hash
+void WriteJsonString(FILE *file, const char *text);         // Writes a quoted JSON string escaping its special characters
+void CompileBatch(const char **paths, int count, int vertexBudget, int fragmentBudget); // Compiles shader graphs into one shared program per canonical graph hash and writes programs manifest
+void WriteProgramFiles(unsigned int hash);                  // Moves compiled levels of detail shaders and reflection metadata to shared program files
+void UnloadGraph();                                         // Destroys all nodes and lines, clears used permutations and restores default textures before loading another graph
+char *ReadShaderSource(FILE *file);                         // Returns an allocated copy of a shader file contents
+void SpecializeNodes();                                     // Links consumers of lerp nodes with a constant 0 or 1 amount to their selected input
+int GetSpecializedInput(FNode node);                        // Returns the input node id selected by a lerp node constant 0 or 1 amount (-1 if not constant)
+void CollectInstanceNodes();                                // Collects reachable per instance property nodes compiled as instance attributes
+int GetInstanceAttribute(FNode node);                       // Returns a per instance property node attribute index (-1 if compiled as uniform)
+void UpdateInstanceBuffer();                                // Fills visor stress scene instances buffer and caches instanced shader locations
+void CollectBlockNodes();                                   // Computes uniform blocks members std140 offsets and blocks size
+void WriteUniformBlocks(FILE *file);                        // Writes shared per frame and per material std140 uniform blocks declarations
+void BindUniformBlocks();                                   // Creates uniform buffers and binds current shader uniform blocks to their binding points
+void UploadUniformBlocks();                                 // Sends per frame and changed per material uniform blocks data with a single buffer update each
+void GetLodPaths(int lod, char *vertexPath, char *fragmentPath); // Returns vertex and fragment shader output paths of a level of detail or depth only variant
+void GetReflectionPaths(int lod, char *jsonPath, char *headerPath); // Returns reflection metadata and C header output paths of a level of detail or depth only variant
+void WriteReflectionFiles(int permutation);                 // Writes reflection metadata and C header of current permutation levels of detail shaders
+int ParseShaderVariables(const char *source, bool fragment, ShaderVariable *variables, int count); // Adds shader code declared variables to a variables list and returns its new length
+int GetVariableNode(const char *name);                      // Returns the node id compiled to a shader variable (-1 if it is not a node variable)
+int GetTypeComponents(const char *type);                    // Returns the float components of a GLSL data type name (0 for samplers)
+void GetUpperName(const char *name, char *output);          // Converts a shader variable name to an upper case C define name
+void WriteReflectionJson(FILE *file, int lod, ShaderVariable *variables, int count); // Writes shader variables reflection metadata in JSON format
+void WriteReflectionHeader(FILE *file, int lod, ShaderVariable *variables, int count); // Writes shader variables precomputed bindings in a C header
+void CalculateAverageValues();                              // Calculates nodes average output values replacing texture samples by their texture average color
+void EvaluateNodeValues(FNode node, bool *evaluated, bool average); // Calculates a node and its inputs output values once (optionally with texture samples replaced by their texture average color)
+Vector4 GetTextureAverage(Texture2D texture);               // Returns the average color of a texture in 0 to 1 range
+void ApproximateNodes(int lod);                             // Resolves optional nodes and replaces fragment subgraphs by their average values to fit a level of detail budget
+void ApproximateNode(FNode node);                           // Declares a node as a constant with its average values
+bool IsAverageFinite(FNode node);                           // Returns true if all node average output values can be declared as a constant
+bool IsNodeVarying(FNode node, bool *visited);              // Check if a node output depends on per vertex or per frame built-in values which have no average value
+ShaderCost GetSubgraphCost(FNode node, bool *counted);      // Returns fragment shader cost estimation of a node and its inputs
+void CheckConstant(FNode node, FILE *file, bool fragment);  // Check nodes searching for constant values to define them in shaders
 void CompileNode(FNode node, FILE *file, bool fragment);    // Compiles a specific node checking its inputs and writing current node operation in shader
+void WriteNodeExpression(FNode node, char *body, FILE *file, bool fragment); // Writes a node operation GLSL expression after its declaration
+void WriteFunctionArgument(FNode node, int input, char *text); // Writes a function node input converted to its library function input type
+void CompileTextureFetch(FNode node, int unit, FILE *file, bool fragment); // Compiles a texture unit fetch shared by all its sampler nodes
+void DeclareSampler(FILE *file, int unit);                  // Declares a texture unit sampler uniform once per shader file (packed units share their atlas or texture array sampler)
+int GetPackedUnit(int unit);                                // Returns the texture unit a texture unit is sampled from (atlas or texture array unit if it is packed)
+void GetPackedCoordinates(int unit, const char *coordinates, bool gradient, char *text); // Returns a texture unit coordinates (or gradient) expression remapped to its atlas rectangle or texture array layer
+void WriteSamplerLevelFetch(FNode node, char *text, bool fragment); // Writes an explicit level of detail, bias or gradients sampler node texture fetch expression
+void CompileLutNode(FNode node, FILE *file, bool fragment); // Compiles a lookup table node as a single texture fetch of its baked input subgraph
+bool IsLutNodeBakeable(FNode node);                         // Check if a lookup table node input subgraph only depends on its coordinates and constant values
+bool IsLutInputStatic(FNode node, FNode lut);               // Check if a lookup table input subgraph node only depends on the table coordinates and constant values
+Vector4 GetLutDomain(FNode node);                           // Returns a lookup table node domain (min, max, resolution, unit) clamped to valid values
+int GetLutUnit(FNode node, int unit);                       // Returns the first free texture unit from a requested unit to bake a lookup table node (-1 if all units are used)
+int GetLutSubgraph(FNode node, FNode lut, int *order, int count, bool *visited); // Adds a lookup table input subgraph node indices in evaluation order and returns their count
+float SampleLutNode(FNode node, int *order, int count, float x, float y); // Returns a lookup table node input subgraph value calculated in CPU at specific coordinates
+void BakeLutNode(FNode node);                               // Bakes a lookup table node input subgraph into a float texture if it changed since last bake
+void BakeLutNodes();                                        // Bakes all current shader compiled lookup table nodes
+void SetTextureUnit(int unit, Texture2D texture);           // Sets a shader texture unit texture unloading its previous texture
+void SetModelMap(int unit, Texture2D texture);              // Sets visor model material map of a texture unit
+void PackTextures();                                        // Packs dropped textures into an atlas or a texture array depending on texture packing setting and shader version
+Texture2D LoadTextureAtlas(int *units, int count);          // Loads dropped textures into an atlas shelf packed by height (empty texture if they don't fit in max atlas size)
+Texture2D LoadTextureArray(int *units, int count);          // Loads dropped textures into a texture array resized to the largest texture size
+void SavePackLayout();                                      // Saves packed textures layout alongside shader data file
+void LoadPackLayout(const char *path);                      // Loads dropped textures and texture packing setting from the pack layout file saved alongside a shader data file
+void BindPackTexture();                                     // Binds packed texture array to its texture unit before drawing visor model
+bool IsNodeConstant(FNode node);                            // Check if a node is compiled as a constant value which can not be edited from shader uniforms
+bool IsConstantEqual(FNode node, float value);              // Check if all components of a constant node are equal to a specific value
+bool IsNodeNormalized(FNode node);                          // Check if a node output values are known to be in 0 to 1 range
+void FormatFloat(float value, char *text);                  // Writes shortest GLSL float literal which reads back the same value
+void FormatConstant(FNode node, float scale, bool reciprocal, char *text); // Writes GLSL literal of a constant node values multiplied by a scale (or their reciprocal)
+int GetNodeConsumers(FNode node);                           // Returns the number of references to a node from other nodes inputs
+bool SimplifyNode(FNode node, char *expression, int *operands, ShaderCost *cost); // Rewrites a node operation as a cheaper equivalent expression
+bool IsNodeInlineable(FNode node, bool fragment);           // Check if a node expression can be substituted into its only consumer expression
+void InlineNodeExpressions(char *body, FILE *file, bool fragment); // Substitutes inlined nodes expressions in a node declaration body
+void WriteNodeBody(FNode node, char *body, FILE *file, bool fragment); // Writes a node declaration body in shader or keeps it to be inlined in its consumer
+bool IsAppendVectorizable(FNode node);                      // Check if an append node inputs are isomorphic scalar operations
+void CompileVectorizedAppend(FNode node, FILE *file, bool fragment); // Compiles an append node of isomorphic scalar operations as a single vector operation
 void AlignAllNodes();                                       // Aligns all created nodes
-void ClearUnusedNodes();                                    // Destroys all unused nodes
+void ClearUnusedNodes();                                    // Destroys all nodes unreachable from output nodes
+void MergeDuplicatedNodes();                                // Destroys structurally identical nodes linking their consumers to a single node
+void CollapseFunction();                                    // Collapses last selected node and its upstream operations into a library function node
+bool IsNodeCollapsible(FNode node);                         // Check if a node can be part of a library function body
+void MarkFunctionBody(FNode node, bool *body, bool *allowed); // Marks a node and its upstream collapsible nodes (only allowed nodes if any) as function body
+int GetFunctionOrder(FNode node, bool *body, bool *visited, int *order, int count, int *params, int *paramsCount); // Adds function body node ids in evaluation order and its external inputs, returns body count
 void ClearGraph();                                          // Destroys all created nodes and its linked lines
 void DrawCanvas();                                          // Draw canvas space to create nodes
 void DrawCanvasGrid(int divisions);                         // Draw canvas grid with a specific number of divisions for horizontal and vertical lines
 void DrawVisor();                                           // Draws a visor with default model rotating and current shader
+void DrawInstances();                                       // Draws visor stress scene default model instances with current instanced shader
 void DrawInterface();                                       // Draw interface to create nodes
 char *GetFileExtension(char *filename);                     // Returns the extension of a file
 bool CheckFileExtension(char *filename, char *extension);   // Check filename for specific extension
@@ -128,143 +388,560 @@ bool CheckTextureExtension(char *filename);                 // Check filename fo
 // Check if there are a compatible shader in output folder
 void CheckPreviousShader(bool makeGraph)
 {
-    Shader previousShader = LoadShader(VERTEX_PATH, FRAGMENT_PATH);
+    char vertexPath[64] = { '\0' };
+    char fragmentPath[64] = { '\0' };
+    GetLodPaths(previewLod, vertexPath, fragmentPath);
+
+    Shader previousShader = LoadShader(vertexPath, fragmentPath);
     if (previousShader.id > 0)
     {
         shader = previousShader;
         model.material.shader = shader;
-        viewUniform = GetShaderLocation(shader, "viewDirection");
-        transformUniform = GetShaderLocation(shader, "modelMatrix");
-        timeUniformV = GetShaderLocation(shader, "vertCurrentTime");
-        timeUniformF = GetShaderLocation(shader, "fragCurrentTime");
+        instancedShader = FSearch(vertexPath, "instanceTransform");
+        blockShader = FSearch(vertexPath, "FrameData");
+
+        // Per frame values are sent in a uniform block when shader uses uniform blocks
+        if (!blockShader)
+        {
+            viewUniform = GetShaderLocation(shader, "viewDirection");
+            transformUniform = GetShaderLocation(shader, "modelMatrix");
+            timeUniformV = GetShaderLocation(shader, "vertCurrentTime");
+            timeUniformF = GetShaderLocation(shader, "fragCurrentTime");
+        }
 
         if (makeGraph)
         {
-            FILE *dataFile = fopen(DATA_PATH, "r");
-            if (dataFile != NULL)
+            instancing = instancedShader;
+            uniformBlocks = blockShader;
+            LoadPackLayout(DATA_PATH);
+            PackTextures();
+            loadedShader = LoadGraph(DATA_PATH);
+            if (loadedShader)
+            {
+                MarkReachableNodes();
+                CollectInstanceNodes();
+                FoldNodes();
+                SpecializeNodes();
+                MergeNodes();
+                ApproximateNodes(previewLod);
+                CollectBlockNodes();
+                CalculateValues();
+
+                for (int i = 0; i < nodesCount; i++)
+                {
+                    if (reachableNodes[nodes[i]->id] && (lutDomains[nodes[i]->id].z == 0) && IsLutNodeBakeable(nodes[i])) lutDomains[nodes[i]->id] = GetLutDomain(nodes[i]);
+                }
+
+                BakeLutNodes();
+            }
+        }
+
+        if (blockShader) BindUniformBlocks();
+        if ((packUnit != -1) && (packedMode == PACKING_ARRAY)) packUniform = GetShaderLocation(shader, FormatText("texture%i", packUnit));
+        CacheValueUniforms();
+        if (instancedShader) UpdateInstanceBuffer();
+    }
+
+    if (!loadedShader)
+    {
+        CreateNodeMaterial(FNODE_VERTEX, "[OUTPUT] Vertex Position", 0);
+        CreateNodeMaterial(FNODE_FRAGMENT, "[OUTPUT] Fragment Color", 0);
+    }
+}
+
+// Loads a shader graph nodes and lines from a data file
+bool LoadGraph(const char *path)
+{
+    bool loaded = false;
+
+    FILE *dataFile = fopen(path, "r");
+    if (dataFile != NULL)
+    {
+        ReadGraphData(dataFile);
+
+        loaded = true;
+        fclose(dataFile);
+    }
+    else TraceLogFNode(false, "error when trying to open shader data file %s", path);
+
+    return loaded;
+}
+
+// Reads nodes and lines from a data file into current nodes and lines pools
+void ReadGraphData(FILE *file)
+{
+    float type = -1;
+    float inputs[MAX_INPUTS] = { -1, -1, -1, -1 };
+    float inputsCount = -1;
+    float inputsLimit = -1;
+    float dataCount = -1;
+    float property = -1;
+    float data[MAX_VALUES] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    float shapeX = -1;
+    float shapeY = -1;
+
+    while (fscanf(file, "%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,\n", &type, &property,
+    &inputs[0], &inputs[1], &inputs[2], &inputs[3], &inputsCount, &inputsLimit, &dataCount, &data[0], &data[1], &data[2],
+    &data[3], &data[4], &data[5], &data[6], &data[7], &data[8], &data[9], &data[10], &data[11], &data[12], &data[13], &data[14],
+    &data[15], &shapeX, &shapeY) > 0)
+    {                
+        FNode newNode = InitializeNode(true);
+        newNode->type = type;
+        newNode->property = property;
+        newNode->staticProperty = (property == 2.0f);
+        newNode->instanceProperty = (property == 3.0f);
+
+        if (type < FNODE_ADD) newNode->inputShape = (Rectangle){ 0, 0, 0, 0 };
+
+        switch ((int)type)
+        {
+            case FNODE_PI: newNode->name = "Pi"; break;
+            case FNODE_E: newNode->name = "e"; break;
+            case FNODE_TIME: newNode->name = "Current Time"; break;
+            case FNODE_VERTEXPOSITION: newNode->name = "Vertex Position"; break;
+            case FNODE_VERTEXNORMAL: newNode->name = "Normal Direction"; break;
+            case FNODE_FRESNEL: newNode->name = "Fresnel"; break;
+            case FNODE_VIEWDIRECTION: newNode->name = "View Direction"; break;
+            case FNODE_MVP: newNode->name = "MVP Matrix"; break;
+            case FNODE_MATRIX: newNode->name = "Matrix 4x4"; break;
+            case FNODE_VALUE: newNode->name = (newNode->staticProperty ? "Static Value" : (newNode->instanceProperty ? "Instance Value" : "Value")); break;
+            case FNODE_VECTOR2: newNode->name = "Vector 2"; break;
+            case FNODE_VECTOR3: newNode->name = "Vector 3"; break;
+            case FNODE_VECTOR4: newNode->name = (newNode->instanceProperty ? "Instance Color" : "Vector 4"); break;
+            case FNODE_ADD: newNode->name = "Add"; break;
+            case FNODE_SUBTRACT: newNode->name = "Subtract"; break;
+            case FNODE_MULTIPLY: newNode->name = "Multiply"; break;
+            case FNODE_DIVIDE: newNode->name = "Divide"; break;
+            case FNODE_APPEND: newNode->name = "Append"; break;
+            case FNODE_ONEMINUS: newNode->name = "One Minus"; break;
+            case FNODE_ABS: newNode->name = "Abs"; break;
+            case FNODE_COS:newNode->name = "Cos"; break;
+            case FNODE_SIN: newNode->name = "Sin"; break;
+            case FNODE_TAN: newNode->name = "Tan"; break;
+            case FNODE_DEG2RAD: newNode->name = "Deg to Rad"; break;
+            case FNODE_RAD2DEG: newNode->name = "Rad to Deg"; break;
+            case FNODE_NORMALIZE: newNode->name = "Normalize"; break;
+            case FNODE_NEGATE: newNode->name = "Negate"; break;
+            case FNODE_RECIPROCAL: newNode->name = "Reciprocal"; break;
+            case FNODE_SQRT: newNode->name = "Square Root"; break;
+            case FNODE_TRUNC: newNode->name = "Trunc"; break;
+            case FNODE_ROUND: newNode->name = "Round"; break;
+            case FNODE_VERTEXCOLOR: newNode->name = "Vertex Color"; break;
+            case FNODE_CEIL: newNode->name = "Ceil"; break;
+            case FNODE_CLAMP01: newNode->name = "Clamp 0-1"; break;
+            case FNODE_EXP2: newNode->name = "Exp 2"; break;
+            case FNODE_POWER: newNode->name = "Power"; break;
+            case FNODE_STEP: newNode->name = "Step"; break;
+            case FNODE_POSTERIZE: newNode->name = "Posterize"; break;
+            case FNODE_MAX: newNode->name = "Max"; break;
+            case FNODE_MIN: newNode->name = "Min"; break;
+            case FNODE_LERP: newNode->name = "Lerp"; break;
+            case FNODE_SMOOTHSTEP: newNode->name = "Smooth Step"; break;
+            case FNODE_CROSSPRODUCT: newNode->name = "Cross Product"; break;
+            case FNODE_DESATURATE: newNode->name = "Desaturate"; break;
+            case FNODE_DISTANCE: newNode->name = "Distance"; break;
+            case FNODE_DOTPRODUCT: newNode->name = "Dot Product"; break;
+            case FNODE_LENGTH: newNode->name = "Length"; break;
+            case FNODE_MULTIPLYMATRIX: newNode->name = "Multiply Matrix"; break;
+            case FNODE_TRANSPOSE: newNode->name = "Transpose"; break;
+            case FNODE_PROJECTION: newNode->name = "Projection Vector"; break;
+            case FNODE_REJECTION: newNode->name = "Rejection Vector"; break;
+            case FNODE_HALFDIRECTION: newNode->name = "Half Direction"; break;
+            case FNODE_SAMPLER2D: newNode->name = "Sampler 2D"; break;
+            case FNODE_VERTEX: newNode->name = "[OUTPUT] Vertex Position"; break;
+            case FNODE_FRAGMENT: newNode->name = "[OUTPUT] Fragment Color"; break;
+            case FNODE_LUT: newNode->name = "Bake to LUT"; break;
+            case FNODE_OPTIONAL: newNode->name = "LOD Optional"; break;
+            case FNODE_SAMPLERLOD: newNode->name = "Sampler 2D LOD"; break;
+            case FNODE_SAMPLERBIAS: newNode->name = "Sampler 2D Bias"; break;
+            case FNODE_SAMPLERGRAD: newNode->name = "Sampler 2D Grad"; break;
+            case FNODE_FUNCTION:
+            {
+                // Function nodes are bound to their library function by name after reading lines
+                newNode->name = "Missing Function";
+                newNode->property = false;
+                newNode->staticProperty = false;
+                newNode->instanceProperty = false;
+            } break;
+            default: break;
+        }
+
+        for (int i = 0; i < MAX_INPUTS; i++) newNode->inputs[i] = inputs[i];
+
+        newNode->inputsCount = inputsCount;
+        newNode->inputsLimit = inputsLimit;
+
+        for (int i = 0; i < MAX_VALUES; i++)
+        {
+            newNode->output.data[i].value = data[i];
+            FFloatToString(newNode->output.data[i].valueText, newNode->output.data[i].value);
+        }
+
+        newNode->output.dataCount = dataCount;
+        newNode->shape.x = shapeX;
+        newNode->shape.y = shapeY;
+
+        UpdateNodeShapes(newNode);
+    }
+
+    int from = -1;
+    int to = -1;            
+    while (fscanf(file, "?%i?%i\n", &from, &to) > 0)
+    {
+        tempLine = CreateNodeLine(from);
+        tempLine->to = to;
+    }
+
+    // Function nodes library function names are read by node id so library functions order does not matter
+    int id = -1;
+    char name[MAX_FUNCTION_NAME] = { '\0' };
+    while (fscanf(file, "!%i %15s\n", &id, name) == 2)
+    {
+        int function = GetFunctionIndex(name);
+
+        for (int i = 0; (i < nodesCount) && (function != -1); i++)
+        {
+            if ((nodes[i]->id == id) && (nodes[i]->type == FNODE_FUNCTION) && (nodes[i]->inputsCount <= functions[function]->inputsCount))
+            {
+                nodes[i]->function = function;
+                nodes[i]->name = functions[function]->name;
+                nodes[i]->inputsLimit = functions[function]->inputsCount;
+            }
+        }
+    }
+
+    // Function nodes without library function are skipped, function bodies keep them so their validation rejects them
+    if (bodyFunction == NULL)
+    {
+        for (int i = nodesCount - 1; i >= 0; i--)
+        {
+            if ((nodes[i]->type == FNODE_FUNCTION) && (nodes[i]->function == -1))
+            {
+                TraceLogFNode(false, "error when trying to load function node %i because its library function is not loaded, skipping it", nodes[i]->id);
+                DestroyNode(nodes[i]);
+            }
+        }
+    }
+
+    for (int i = 0; i < nodesCount; i++) UpdateNodeShapes(nodes[i]);
+    CalculateValues();
+    for (int i = 0; i < nodesCount; i++) UpdateNodeShapes(nodes[i]);
+}
+
+// Writes current nodes and lines pools in a data file sorted by id
+void WriteGraphData(FILE *file)
+{
+    // Nodes get ids in reading order so ids are written as positions to keep links after destroyed or skipped nodes
+    int positions[MAX_NODES] = { 0 };
+    for (int i = 0; i < nodesCount; i++)
+    {
+        for (int k = 0; k < nodesCount; k++)
+        {
+            if (nodes[k]->id < nodes[i]->id) positions[nodes[i]->id]++;
+        }
+    }
+
+    // Nodes data writing
+    int count = 0;
+    for (int i = 0; i < MAX_NODES; i++)
+    {
+        for (int k = 0; k < nodesCount; k++)
+        {
+            if (nodes[k]->id == i)
             {
-                float type = -1;
+                float type = (float)nodes[k]->type;
+                float property = (nodes[k]->staticProperty ? 2.0f : (nodes[k]->instanceProperty ? 3.0f : (float)nodes[k]->property));
                 float inputs[MAX_INPUTS] = { -1, -1, -1, -1 };
-                float inputsCount = -1;
-                float inputsLimit = -1;
-                float dataCount = -1;
-                float property = -1;
-                float data[MAX_VALUES] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
-                float shapeX = -1;
-                float shapeY = -1;
-
-                while (fscanf(dataFile, "%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,\n", &type, &property,
-                &inputs[0], &inputs[1], &inputs[2], &inputs[3], &inputsCount, &inputsLimit, &dataCount, &data[0], &data[1], &data[2],
-                &data[3], &data[4], &data[5], &data[6], &data[7], &data[8], &data[9], &data[10], &data[11], &data[12], &data[13], &data[14],
-                &data[15], &shapeX, &shapeY) > 0)
-                {                
-                    FNode newNode = InitializeNode(true);
-                    newNode->type = type;
-                    newNode->property = property;
-
-                    if (type < FNODE_ADD) newNode->inputShape = (Rectangle){ 0, 0, 0, 0 };
-
-                    switch ((int)type)
-                    {
-                        case FNODE_PI: newNode->name = "Pi"; break;
-                        case FNODE_E: newNode->name = "e"; break;
-                        case FNODE_TIME: newNode->name = "Current Time"; break;
-                        case FNODE_VERTEXPOSITION: newNode->name = "Vertex Position"; break;
-                        case FNODE_VERTEXNORMAL: newNode->name = "Normal Direction"; break;
-                        case FNODE_FRESNEL: newNode->name = "Fresnel"; break;
-                        case FNODE_VIEWDIRECTION: newNode->name = "View Direction"; break;
-                        case FNODE_MVP: newNode->name = "MVP Matrix"; break;
-                        case FNODE_MATRIX: newNode->name = "Matrix 4x4"; break;
-                        case FNODE_VALUE: newNode->name = "Value"; break;
-                        case FNODE_VECTOR2: newNode->name = "Vector 2"; break;
-                        case FNODE_VECTOR3: newNode->name = "Vector 3"; break;
-                        case FNODE_VECTOR4: newNode->name = "Vector 4"; break;
-                        case FNODE_ADD: newNode->name = "Add"; break;
-                        case FNODE_SUBTRACT: newNode->name = "Subtract"; break;
-                        case FNODE_MULTIPLY: newNode->name = "Multiply"; break;
-                        case FNODE_DIVIDE: newNode->name = "Divide"; break;
-                        case FNODE_APPEND: newNode->name = "Append"; break;
-                        case FNODE_ONEMINUS: newNode->name = "One Minus"; break;
-                        case FNODE_ABS: newNode->name = "Abs"; break;
-                        case FNODE_COS:newNode->name = "Cos"; break;
-                        case FNODE_SIN: newNode->name = "Sin"; break;
-                        case FNODE_TAN: newNode->name = "Tan"; break;
-                        case FNODE_DEG2RAD: newNode->name = "Deg to Rad"; break;
-                        case FNODE_RAD2DEG: newNode->name = "Rad to Deg"; break;
-                        case FNODE_NORMALIZE: newNode->name = "Normalize"; break;
-                        case FNODE_NEGATE: newNode->name = "Negate"; break;
-                        case FNODE_RECIPROCAL: newNode->name = "Reciprocal"; break;
-                        case FNODE_SQRT: newNode->name = "Square Root"; break;
-                        case FNODE_TRUNC: newNode->name = "Trunc"; break;
-                        case FNODE_ROUND: newNode->name = "Round"; break;
-                        case FNODE_VERTEXCOLOR: newNode->name = "Vertex Color"; break;
-                        case FNODE_CEIL: newNode->name = "Ceil"; break;
-                        case FNODE_CLAMP01: newNode->name = "Clamp 0-1"; break;
-                        case FNODE_EXP2: newNode->name = "Exp 2"; break;
-                        case FNODE_POWER: newNode->name = "Power"; break;
-                        case FNODE_STEP: newNode->name = "Step"; break;
-                        case FNODE_POSTERIZE: newNode->name = "Posterize"; break;
-                        case FNODE_MAX: newNode->name = "Max"; break;
-                        case FNODE_MIN: newNode->name = "Min"; break;
-                        case FNODE_LERP: newNode->name = "Lerp"; break;
-                        case FNODE_SMOOTHSTEP: newNode->name = "Smooth Step"; break;
-                        case FNODE_CROSSPRODUCT: newNode->name = "Cross Product"; break;
-                        case FNODE_DESATURATE: newNode->name = "Desaturate"; break;
-                        case FNODE_DISTANCE: newNode->name = "Distance"; break;
-                        case FNODE_DOTPRODUCT: newNode->name = "Dot Product"; break;
-                        case FNODE_LENGTH: newNode->name = "Length"; break;
-                        case FNODE_MULTIPLYMATRIX: newNode->name = "Multiply Matrix"; break;
-                        case FNODE_TRANSPOSE: newNode->name = "Transpose"; break;
-                        case FNODE_PROJECTION: newNode->name = "Projection Vector"; break;
-                        case FNODE_REJECTION: newNode->name = "Rejection Vector"; break;
-                        case FNODE_HALFDIRECTION: newNode->name = "Half Direction"; break;
-                        case FNODE_SAMPLER2D: newNode->name = "Sampler 2D"; break;
-                        case FNODE_VERTEX: newNode->name = "[OUTPUT] Vertex Position"; break;
-                        case FNODE_FRAGMENT: newNode->name = "[OUTPUT] Fragment Color"; break;
-                        default: break;
-                    }
+                for (int j = 0; j < nodes[k]->inputsCount; j++) inputs[j] = (float)positions[nodes[k]->inputs[j]];
+                float inputsCount = (float)nodes[k]->inputsCount;
+                float inputsLimit = (float)nodes[k]->inputsLimit;
+                float dataCount = (float)nodes[k]->output.dataCount;
+                float data[MAX_VALUES] = { nodes[k]->output.data[0].value, nodes[k]->output.data[1].value, nodes[k]->output.data[2].value, nodes[k]->output.data[3].value, nodes[k]->output.data[4].value,
+                nodes[k]->output.data[5].value, nodes[k]->output.data[6].value, nodes[k]->output.data[7].value, nodes[k]->output.data[8].value, nodes[k]->output.data[9].value, nodes[k]->output.data[10].value,
+                nodes[k]->output.data[11].value, nodes[k]->output.data[12].value, nodes[k]->output.data[13].value, nodes[k]->output.data[14].value, nodes[k]->output.data[15].value };
+                float shapeX = (float)nodes[k]->shape.x;
+                float shapeY = (float)nodes[k]->shape.y;
+
+                fprintf(file, "%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,\n", type, property,
+                inputs[0], inputs[1], inputs[2], inputs[3], inputsCount, inputsLimit, dataCount, data[0], data[1], data[2],
+                data[3], data[4], data[5], data[6], data[7], data[8], data[9], data[10], data[11], data[12], data[13], data[14],
+                data[15], shapeX, shapeY);
+
+                count++;
+                break;
+            }
+        }
 
-                    for (int i = 0; i < MAX_INPUTS; i++) newNode->inputs[i] = inputs[i];
+        if (count == nodesCount) break;
+    }
 
-                    newNode->inputsCount = inputsCount;
-                    newNode->inputsLimit = inputsLimit;
+    // Lines data writing
+    count = 0;
 
-                    for (int i = 0; i < MAX_VALUES; i++)
-                    {
-                        newNode->output.data[i].value = data[i];
-                        FFloatToString(newNode->output.data[i].valueText, newNode->output.data[i].value);
-                    }
+    for (int i = 0; i < MAX_LINES; i++)
+    {
+        for (int k = 0; k < linesCount; k++)
+        {
+            if (lines[k]->id == i)
+            {
+                fprintf(file, "?%i?%i\n", positions[lines[k]->from], positions[lines[k]->to]);
 
-                    newNode->output.dataCount = dataCount;
-                    newNode->shape.x = shapeX;
-                    newNode->shape.y = shapeY;
+                count++;
+                break;
+            }
+        }
 
-                    UpdateNodeShapes(newNode);
-                }
+        if (count == linesCount) break;
+    }
 
-                int from = -1;
-                int to = -1;            
-                while (fscanf(dataFile, "?%i?%i\n", &from, &to) > 0)
-                {
-                    tempLine = CreateNodeLine(from);
-                    tempLine->to = to;
-                }
+    // Function nodes library function names writing
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if ((nodes[i]->type == FNODE_FUNCTION) && (nodes[i]->function != -1)) fprintf(file, "!%i %s\n", positions[nodes[i]->id], functions[nodes[i]->function]->name);
+    }
+}
 
-                for (int i = 0; i < nodesCount; i++) UpdateNodeShapes(nodes[i]);
-                CalculateValues();
-                for (int i = 0; i < nodesCount; i++) UpdateNodeShapes(nodes[i]);
+// Loads library functions bodies and generates their GLSL code
+void LoadFunctions()
+{
+    FILE *file = fopen(FUNCTIONS_PATH, "r");
+    if (file != NULL)
+    {
+        char name[MAX_FUNCTION_NAME] = { '\0' };
+        int inputs = 0;
+
+        while ((functionsCount < MAX_FUNCTIONS) && (fscanf(file, "function %15s %i\n", name, &inputs) == 2))
+        {
+            FFunction function = AddFunction(name, inputs);
+
+            BeginFunctionBody(function);
+            ReadGraphData(file);
+
+            // Function names must be unique GLSL identifiers and bodies only contain their inputs, constants and operations calculated in CPU
+            bool valid = (IsFunctionNameValid(name) && (GetFunctionIndex(name) == (functionsCount - 1)) && (inputs > 0) && (inputs <= MAX_INPUTS) && (nodesCount > inputs) && (nodesCount <= MAX_FUNCTION_NODES) && (linesCount <= MAX_FUNCTION_NODES*MAX_INPUTS));
+            for (int i = 0; (i < nodesCount) && valid; i++)
+            {
+                if (i < inputs) valid = ((nodes[i]->type >= FNODE_MATRIX) && (nodes[i]->type <= FNODE_VECTOR4));
+                else valid = IsNodeCollapsible(nodes[i]);
+            }
+
+            // Invalid bodies are emptied before storing them so the function can be destroyed
+            if (!valid)
+            {
+                for (int i = nodesCount - 1; i >= 0; i--) DestroyNode(nodes[i]);
+            }
+
+            EndFunctionBody();
 
-                loadedShader = true;
-                fclose(dataFile);
+            if (valid)
+            {
+                CompileFunction(function);
+                TraceLogFNode(false, "loaded library function %s (%i inputs, %i nodes, cost %i)", name, inputs, function->nodesCount - inputs, GetCostTotal(function->cost));
+            }
+            else
+            {
+                functionsCount--;
+                functions[functionsCount] = NULL;
+                scrollLimits.y -= (UI_BUTTON_HEIGHT + UI_PADDING);
+                DestroyFunction(function);
+
+                TraceLogFNode(false, "error when trying to load library function %s because its name or body is not valid, skipping it", name);
             }
-            else TraceLogFNode(false, "error when trying to open previous shader data file");
         }
+
+        if ((functionsCount == MAX_FUNCTIONS) && !feof(file)) TraceLogFNode(false, "error when trying to load more library functions because max functions count is reached, skipping them");
+
+        fclose(file);
     }
+}
 
-    if (!loadedShader)
+// Adds an empty library function with a name and declared inputs count
+FFunction AddFunction(const char *name, int inputs)
+{
+    FFunction function = NULL;
+
+    if (functionsCount < MAX_FUNCTIONS)
     {
-        CreateNodeMaterial(FNODE_VERTEX, "[OUTPUT] Vertex Position", 0);
-        CreateNodeMaterial(FNODE_FRAGMENT, "[OUTPUT] Fragment Color", 0);
+        function = (FFunction)FNODE_MALLOC(sizeof(FFunctionData));
+        usedMemory += sizeof(FFunctionData);
+
+        strncpy(function->name, name, MAX_FUNCTION_NAME - 1);
+        function->name[MAX_FUNCTION_NAME - 1] = '\0';
+        function->inputsCount = inputs;
+        function->nodesCount = 0;
+        function->linesCount = 0;
+        function->source = NULL;
+        function->cost = (ShaderCost){ 0 };
+        function->exact = false;
+
+        functions[functionsCount] = function;
+        functionsCount++;
+
+        // Each library function adds a button to create its nodes in interface
+        scrollLimits.y += (UI_BUTTON_HEIGHT + UI_PADDING);
+    }
+    else TraceLogFNode(false, "error when trying to add library function %s because max functions count is reached", name);
+
+    return function;
+}
+
+// Returns the index of a library function by its name
+int GetFunctionIndex(const char *name)
+{
+    int index = -1;
+
+    for (int i = 0; i < functionsCount; i++)
+    {
+        if (strcmp(functions[i]->name, name) == 0)
+        {
+            index = i;
+            break;
+        }
+    }
+
+    return index;
+}
+
+// Check if a library function name can be part of a GLSL identifier
+bool IsFunctionNameValid(const char *name)
+{
+    // Generated functions are prefixed with fn_ and GLSL reserves identifiers with consecutive underscores
+    bool valid = isalpha(name[0]);
+
+    for (int i = 1; (name[i] != '\0') && valid; i++) valid = (isalnum(name[i]) || ((name[i] == '_') && (name[i - 1] != '_')));
+
+    return valid;
+}
+
+// Generates a library function GLSL code, cost and CPU exactness from its body
+void CompileFunction(FFunction function)
+{
+    char source[MAX_FUNCTION_SOURCE] = { '\0' };
+    char line[4096] = { '\0' };
+
+    function->cost = (ShaderCost){ 0 };
+    function->exact = true;
+
+    BeginFunctionBody(function);
+
+    // Function inputs are the parameters and last body node is the returned value
+    FNode output = nodes[nodesCount - 1];
+    sprintf(source, "// Library function %s\n%s fn_%s(", function->name, GetDataTypeName(output->output.dataCount), function->name);
+
+    for (int i = 0; i < function->inputsCount; i++)
+    {
+        sprintf(line, "%s%s node_%02i", ((i > 0) ? ", " : ""), GetDataTypeName(nodes[i]->output.dataCount), nodes[i]->id);
+        strcat(source, line);
+    }
+
+    strcat(source, ")\n{\n");
+
+    for (int i = function->inputsCount; i < nodesCount; i++)
+    {
+        if (nodes[i]->type < FNODE_ADD)
+        {
+            char literal[256] = { '\0' };
+            FormatConstant(nodes[i], 1.0f, false, literal);
+            sprintf(line, "    const %s node_%02i = %s;\n", GetDataTypeName(nodes[i]->output.dataCount), nodes[i]->id, literal);
+        }
+        else
+        {
+            ShaderCost cost = GetNodeCost(nodes[i]);
+            function->cost.alu += cost.alu;
+            function->cost.transcendental += cost.transcendental;
+            function->cost.texture += cost.texture;
+            function->cost.discard += cost.discard;
+            function->exact = (function->exact && IsNodeHoistable(nodes[i]));
+
+            sprintf(line, "    %s node_%02i = ", GetDataTypeName(nodes[i]->output.dataCount), nodes[i]->id);
+            WriteNodeExpression(nodes[i], line, NULL, false);
+        }
+
+        if ((strlen(source) + strlen(line)) < (MAX_FUNCTION_SOURCE - 32)) strcat(source, line);
+        else TraceLogFNode(true, "error when trying to compile library function %s because its code is too long", function->name);
+    }
+
+    sprintf(line, "    return node_%02i;\n}\n", output->id);
+    strcat(source, line);
+
+    EndFunctionBody();
+
+    if (function->source != NULL) FNODE_FREE(function->source);
+    function->source = (char *)FNODE_MALLOC(strlen(source) + 1);
+    strcpy(function->source, source);
+}
+
+// Appends a library function body to library functions data file
+void SaveFunction(FFunction function)
+{
+    FILE *file = fopen(FUNCTIONS_PATH, "a");
+    if (file != NULL)
+    {
+        fprintf(file, "function %s %i\n", function->name, function->inputsCount);
+
+        BeginFunctionBody(function);
+        WriteGraphData(file);
+        EndFunctionBody();
+
+        fclose(file);
+    }
+    else TraceLogFNode(true, "error when trying to open and write in library functions file");
+}
+
+// Caches constant values uniform locations and sends their current values
+void CacheValueUniforms()
+{
+    for (int i = 0; i < MAX_NODES; i++) valueUniforms[i] = -1;
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        bool hoistedUniform = (hoistedNodes[nodes[i]->id] && (nodeStages[nodes[i]->id] == STAGE_UNIFORM));
+
+        if (hoistedUniform || ((nodes[i]->type >= FNODE_MATRIX) && (nodes[i]->type <= FNODE_VECTOR4) && !nodes[i]->staticProperty && (GetInstanceAttribute(nodes[i]) == -1) && (nodes[i]->property || (compileMode == COMPILE_AUTHORING))))
+        {
+            if (!blockNodes[nodes[i]->id]) valueUniforms[nodes[i]->id] = GetShaderLocation(shader, FormatText("node_%02i", nodes[i]->id));
+            SetValueUniform(nodes[i]);
+        }
+    }
+}
+
+// Sends a constant value node current values to its shader uniform
+void SetValueUniform(FNode node)
+{
+    int location = valueUniforms[node->id];
+
+    // Uniform block members are sent with the whole block once per frame (per material block only when its values change)
+    if (frameNodes[node->id])
+    {
+        for (int i = 0; i < node->output.dataCount; i++) frameBlock[blockOffsets[node->id]/4 + i] = node->output.data[i].value;
+    }
+    else if (blockNodes[node->id])
+    {
+        for (int i = 0; i < node->output.dataCount; i++)
+        {
+            if (materialBlock[blockOffsets[node->id]/4 + i] != node->output.data[i].value)
+            {
+                materialBlock[blockOffsets[node->id]/4 + i] = node->output.data[i].value;
+                materialBlockChanged = true;
+            }
+        }
+    }
+    else if (location != -1)
+    {
+        if (node->output.dataCount == 16)
+        {
+            Matrix matrix = { 0 };
+            matrix.m0 = node->output.data[0].value; matrix.m1 = node->output.data[1].value; matrix.m2 = node->output.data[2].value; matrix.m3 = node->output.data[3].value;
+            matrix.m4 = node->output.data[4].value; matrix.m5 = node->output.data[5].value; matrix.m6 = node->output.data[6].value; matrix.m7 = node->output.data[7].value;
+            matrix.m8 = node->output.data[8].value; matrix.m9 = node->output.data[9].value; matrix.m10 = node->output.data[10].value; matrix.m11 = node->output.data[11].value;
+            matrix.m12 = node->output.data[12].value; matrix.m13 = node->output.data[13].value; matrix.m14 = node->output.data[14].value; matrix.m15 = node->output.data[15].value;
+            SetShaderValueMatrix(shader, location, matrix);
+        }
+        else
+        {
+            float values[4] = { node->output.data[0].value, node->output.data[1].value, node->output.data[2].value, node->output.data[3].value };
+            SetShaderValue(shader, location, values, node->output.dataCount);
+        }
     }
 }
 
@@ -426,6 +1103,7 @@ void UpdateNodesDrag()
                 if (CheckCollisionPointRec(mousePosition, CameraToViewRec(nodes[i]->shape, camera)))
                 {
                     selectedNode = nodes[i]->id;
+                    focusedNode = nodes[i]->id;
                     currentOffset = (Vector2){ mousePosition.x - nodes[i]->shape.x, mousePosition.y - nodes[i]->shape.y };
                     break;
                 }
@@ -441,7 +1119,7 @@ void UpdateNodesDrag()
         {
             for (int i = nodesCount - 1; i >= 0; i--)
             {
-                if (CheckCollisionPointRec(mousePosition, CameraToViewRec(nodes[i]->shape, camera)) && (nodes[i]->type < FNODE_VERTEX))
+                if (CheckCollisionPointRec(mousePosition, CameraToViewRec(nodes[i]->shape, camera)) && (nodes[i]->type != FNODE_VERTEX) && (nodes[i]->type != FNODE_FRAGMENT))
                 {
                     DestroyNode(nodes[i]);
                     CalculateValues();
@@ -534,6 +1212,8 @@ void UpdateNodesLink()
 
                             bool valuesCheck = true;
                             if (nodes[i]->type == FNODE_SAMPLER2D) valuesCheck = (nodes[indexFrom]->output.dataCount == 1);
+                            else if (nodes[i]->type == FNODE_SAMPLERGRAD) valuesCheck = (nodes[indexFrom]->output.dataCount == ((nodes[i]->inputsCount < 2) ? 1 : 2));
+                            else if ((nodes[i]->type == FNODE_SAMPLERLOD) || (nodes[i]->type == FNODE_SAMPLERBIAS)) valuesCheck = (nodes[indexFrom]->output.dataCount == 1);
                             else if (nodes[i]->type == FNODE_LERP) valuesCheck = (nodes[i]->inputsCount <= nodes[i]->inputsLimit);
                             else if (nodes[i]->type == FNODE_APPEND) valuesCheck = ((nodes[i]->output.dataCount + nodes[indexFrom]->output.dataCount <= 4) && (nodes[indexFrom]->output.dataCount == 1));
                             else if (nodes[i]->type == FNODE_VERTEXCOLOR) valuesCheck = (nodes[indexFrom]->output.dataCount == 1);
@@ -571,13 +1251,21 @@ void UpdateNodesLink()
                                 }
                             }
                             else if ((nodes[i]->type == FNODE_MULTIPLYMATRIX) || (nodes[i]->type == FNODE_TRANSPOSE)) valuesCheck = (nodes[indexFrom]->output.dataCount == 16);
-                            else if (nodes[i]->type >= FNODE_VERTEX) valuesCheck = (nodes[indexFrom]->output.dataCount <= nodes[i]->output.dataCount);
+                            else if (nodes[i]->type == FNODE_LUT) valuesCheck = (nodes[indexFrom]->output.dataCount == ((nodes[i]->inputsCount == 2) ? 4 : 1));
+                            else if (nodes[i]->type == FNODE_FUNCTION)
+                            {
+                                // Function arguments are linked with the rule used to evaluate them: vectors are truncated or padded and matrices only link to matrix inputs
+                                int count = functions[nodes[i]->function]->nodes[nodes[i]->inputsCount]->output.dataCount;
+                                valuesCheck = ((nodes[indexFrom]->output.dataCount == count) || ((nodes[indexFrom]->output.dataCount != 16) && (count != 16)));
+                            }
+                            else if ((nodes[i]->type == FNODE_VERTEX) || (nodes[i]->type == FNODE_FRAGMENT)) valuesCheck = (nodes[indexFrom]->output.dataCount <= nodes[i]->output.dataCount);
                             else if (nodes[i]->type > FNODE_DIVIDE) valuesCheck = (nodes[i]->output.dataCount == nodes[indexFrom]->output.dataCount);
 
                             if (((nodes[i]->inputsCount == 0) && (nodes[i]->type != FNODE_NORMALIZE) && (nodes[i]->type != FNODE_DOTPRODUCT) && 
                             (nodes[i]->type != FNODE_LENGTH) && (nodes[i]->type != FNODE_MULTIPLYMATRIX) && (nodes[i]->type != FNODE_TRANSPOSE) && (nodes[i]->type != FNODE_PROJECTION) &&
                             (nodes[i]->type != FNODE_DISTANCE) && (nodes[i]->type != FNODE_REJECTION) && (nodes[i]->type != FNODE_HALFDIRECTION) && (nodes[i]->type != FNODE_STEP) &&
-                            (nodes[i]->type != FNODE_LERP) && (nodes[i]->type != FNODE_SAMPLER2D)) || valuesCheck)
+                            (nodes[i]->type != FNODE_LERP) && (nodes[i]->type != FNODE_SAMPLER2D) && (nodes[i]->type != FNODE_LUT) && (nodes[i]->type != FNODE_FUNCTION) &&
+                            (nodes[i]->type != FNODE_SAMPLERLOD) && (nodes[i]->type != FNODE_SAMPLERBIAS) && (nodes[i]->type != FNODE_SAMPLERGRAD)) || valuesCheck)
                             {
                                 // Check if there is already a line created with same linking ids
                                 for (int k = 0; k < linesCount; k++)
@@ -965,19 +1653,11 @@ void UpdateShaderData()
         
         if (CheckTextureExtension(path) && (loadedFiles < MAX_TEXTURES))
         {
-            if (textures[loadedFiles].id != 0) UnloadTexture(textures[loadedFiles]);
-            textures[loadedFiles] = LoadTexture(path);
-            
-            if (shader.id > 0)
-            {
-                switch (loadedFiles)
-                {
-                    case 0: model.material.maps[MAP_ALBEDO].texture = textures[loadedFiles]; break;
-                    case 1: model.material.maps[MAP_NORMAL].texture = textures[loadedFiles]; break;
-                    case 2: model.material.maps[MAP_SPECULAR].texture = textures[loadedFiles]; break;
-                    default: break;
-                }
-            }
+            SetTextureUnit(loadedFiles, LoadTexture(path));
+
+            // Dropped textures paths are kept to pack them and save their pack layout
+            strncpy(texturePaths[loadedFiles], path, 255);
+            packChanged = true;
             
             loadedFiles++;
             if (loadedFiles == MAX_TEXTURES) loadedFiles = 0;
@@ -1019,651 +1699,5579 @@ void UpdateShaderData()
             SetShaderValue(shader, timeUniformF, time, 1);
         }
 
-        float resolution[2] = { (fullVisor ? screenSize.x : (screenSize.x/4)), (fullVisor ? screenSize.y : (screenSize.y/4)) };
-        SetShaderValue(fxaa, fxaaUniform, resolution, 2);
-    }
-}
-
-// Compiles all node structure to create the GLSL fragment shader in output folder
-void CompileShader()
-{
-    // Reset previous compiled shader data
-    if (loadedShader || (shader.id > 0)) UnloadShader(shader);
-    remove(DATA_PATH);
-    remove(VERTEX_PATH);
-    remove(FRAGMENT_PATH);
-    model.material.shader = GetShaderDefault();
-    for (int i = 0; i < MAX_TEXTURES; i++) usedUnits[i] = false;
-    compileState = -1;
-    compileFrame = 0;
-    viewUniform = -1;
-    transformUniform = -1;
-    timeUniformV = -1;
-    timeUniformF = -1;
-
-    // Open shader data file
-    FILE *dataFile = fopen(DATA_PATH, "w");
-    if (dataFile != NULL)
-    {
-        // Nodes data reading
-        int count = 0;
-        for (int i = 0; i < MAX_NODES; i++)
+        // Check if any constant value has been edited and send its new values to shader
+        if (changedNode != -1)
         {
-            for (int k = 0; k < nodesCount; k++)
+            for (int i = 0; i < nodesCount; i++)
             {
-                if (nodes[k]->id == i)
-                {
-                    float type = (float)nodes[k]->type;
-                    float property = (float)nodes[k]->property;
-                    float inputs[MAX_INPUTS] = { (float)nodes[k]->inputs[0], (float)nodes[k]->inputs[1], (float)nodes[k]->inputs[2], (float)nodes[k]->inputs[3] };
-                    float inputsCount = (float)nodes[k]->inputsCount;
-                    float inputsLimit = (float)nodes[k]->inputsLimit;
-                    float dataCount = (float)nodes[k]->output.dataCount;
-                    float data[MAX_VALUES] = { nodes[k]->output.data[0].value, nodes[k]->output.data[1].value, nodes[k]->output.data[2].value, nodes[k]->output.data[3].value, nodes[k]->output.data[4].value,
-                    nodes[k]->output.data[5].value, nodes[k]->output.data[6].value, nodes[k]->output.data[7].value, nodes[k]->output.data[8].value, nodes[k]->output.data[9].value, nodes[k]->output.data[10].value,
-                    nodes[k]->output.data[11].value, nodes[k]->output.data[12].value, nodes[k]->output.data[13].value, nodes[k]->output.data[14].value, nodes[k]->output.data[15].value };
-                    float shapeX = (float)nodes[k]->shape.x;
-                    float shapeY = (float)nodes[k]->shape.y;
-
-                    fprintf(dataFile, "%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,\n", type, property,
-                    inputs[0], inputs[1], inputs[2], inputs[3], inputsCount, inputsLimit, dataCount, data[0], data[1], data[2],
-                    data[3], data[4], data[5], data[6], data[7], data[8], data[9], data[10], data[11], data[12], data[13], data[14],
-                    data[15], shapeX, shapeY);
-                    
-                    count++;
+                if (nodes[i]->id == changedNode)
+                {
+                    // Static properties select a shader permutation compiled on demand and per instance properties are sent as instance attributes
+                    if (nodes[i]->staticProperty) CompileShader();
+                    else if (instancedShader && (GetInstanceAttribute(nodes[i]) != -1)) UpdateInstanceBuffer();
+                    else SetValueUniform(nodes[i]);
                     break;
                 }
             }
 
-            if (count == nodesCount) break;
-        }
+            // Rebake lookup tables whose input subgraph depends on the edited value
+            BakeLutNodes();
 
-        // Lines data reading
-        count = 0;
+            changedNode = -1;
+        }
 
-        for (int i = 0; i < MAX_NODES; i++)
+        // Calculate hoisted per frame nodes and their inputs once in CPU and send their values to shader (nodes deleted since last compile are skipped)
+        if (frameOrderCount > 0)
         {
-            for (int k = 0; k < nodesCount; k++)
+            int indices[MAX_NODES] = { 0 };
+
+            for (int i = 0; i < MAX_NODES; i++) indices[i] = -1;
+            for (int i = 0; i < nodesCount; i++) indices[nodes[i]->id] = i;
+
+            for (int i = 0; i < frameOrderCount; i++)
             {
-                if (lines[k]->id == i)
+                if (indices[frameOrder[i]] != -1)
                 {
-                    fprintf(dataFile, "?%i?%i\n", lines[k]->from, lines[k]->to);
-                    
-                    count++;
-                    break;
+                    FNode node = nodes[indices[frameOrder[i]]];
+
+                    if (node->type == FNODE_TIME) node->output.data[0].value = currentTime;
+                    else if (node->type > FNODE_VECTOR4) CalculateNodeValues(node);
+
+                    if (hoistedNodes[node->id] && (nodeStages[node->id] == STAGE_UNIFORM)) SetValueUniform(node);
                 }
             }
-
-            if (count == linesCount) break;
         }
 
-        fclose(dataFile);
+        if (blockShader) UploadUniformBlocks();
+
+        float resolution[2] = { (fullVisor ? screenSize.x : (screenSize.x/4)), (fullVisor ? screenSize.y : (screenSize.y/4)) };
+        SetShaderValue(fxaa, fxaaUniform, resolution, 2);
     }
-    else TraceLogFNode(true, "error when trying to open and write in data file");
+}
 
-    // Open vertex shader file to write data
-    FILE *vertexFile = fopen(VERTEX_PATH, "w");
-    if (vertexFile != NULL)
+// Calculates a node and its inputs output values in CPU
+void EvaluateNode(FNode node)
+{
+    for (int i = 0; i < node->inputsCount; i++)
     {
-        const char vCredits[] = "// Shader created with FNode 1.0 - Credits: Victor Fisac\n\n";
-        fprintf(vertexFile, vCredits);
+        int index = GetNodeIndex(node->inputs[i]);
+        EvaluateNode(nodes[index]);
+    }
+
+    if (node->type == FNODE_TIME) node->output.data[0].value = currentTime;
+    else if (node->type > FNODE_VECTOR4) CalculateNodeValues(node);
+}
+
+// Sorts hoisted per frame nodes and their inputs in evaluation order to calculate them once per frame
+void SortFrameNodes()
+{
+    bool visited[MAX_NODES] = { false };
+
+    frameOrderCount = 0;
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (hoistedNodes[nodes[i]->id] && (nodeStages[nodes[i]->id] == STAGE_UNIFORM)) AddFrameNode(nodes[i], visited);
+    }
+}
+
+// Adds a node after its inputs to per frame nodes evaluation order
+void AddFrameNode(FNode node, bool *visited)
+{
+    if (!visited[node->id])
+    {
+        visited[node->id] = true;
+
+        for (int i = 0; i < node->inputsCount; i++) AddFrameNode(nodes[GetNodeIndex(node->inputs[i])], visited);
+
+        frameOrder[frameOrderCount] = node->id;
+        frameOrderCount++;
+    }
+}
+
+// Marks nodes reachable from output nodes and returns the number of unreachable nodes
+int MarkReachableNodes()
+{
+    int indices[MAX_NODES] = { 0 };
+    int stack[MAX_NODES] = { 0 };
+    int stackCount = 0;
+    int unreachable = nodesCount;
+
+    for (int i = 0; i < MAX_NODES; i++) reachableNodes[i] = false;
+    for (int i = 0; i < nodesCount; i++) indices[nodes[i]->id] = i;
+
+    // Walk backwards from vertex and fragment output nodes visiting each node once
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if ((nodes[i]->type == FNODE_VERTEX) || (nodes[i]->type == FNODE_FRAGMENT))
+        {
+            reachableNodes[nodes[i]->id] = true;
+            stack[stackCount] = i;
+            stackCount++;
+        }
+    }
+
+    while (stackCount > 0)
+    {
+        stackCount--;
+        FNode node = nodes[stack[stackCount]];
+        unreachable--;
+
+        for (int i = 0; i < node->inputsCount; i++)
+        {
+            if (!reachableNodes[node->inputs[i]])
+            {
+                reachableNodes[node->inputs[i]] = true;
+                stack[stackCount] = indices[node->inputs[i]];
+                stackCount++;
+            }
+        }
+    }
+
+    return unreachable;
+}
+
+// Marks operator nodes with only constant inputs to declare them with their CPU calculated values
+void FoldNodes()
+{
+    int foldedCount = 0;
+    bool folding = true;
+
+    for (int i = 0; i < MAX_NODES; i++) foldedNodes[i] = false;
+
+    // Propagate folding from constant nodes to their consumers until no more nodes can be folded
+    while (folding)
+    {
+        folding = false;
+
+        for (int i = 0; i < nodesCount; i++)
+        {
+            if (reachableNodes[nodes[i]->id] && !foldedNodes[nodes[i]->id] && IsNodeFoldable(nodes[i]))
+            {
+                foldedNodes[nodes[i]->id] = true;
+                foldedCount++;
+                folding = true;
+            }
+        }
+    }
+
+    if (foldedCount > 0) TraceLogFNode(false, "constant folding: %i nodes declared as constants", foldedCount);
+}
+
+// Check if an operator node can be declared as a constant with its CPU calculated values
+bool IsNodeFoldable(FNode node)
+{
+    bool foldable = ((node->type >= FNODE_ADD) && (node->inputsCount > 0));
+
+    for (int i = 0; (i < node->inputsCount) && foldable; i++)
+    {
+        int index = GetNodeIndex(node->inputs[i]);
+        foldable = IsNodeConstant(nodes[index]);
+    }
+
+    // Only operations calculated in CPU as in GLSL are folded and their values must be valid GLSL literals
+    if (foldable)
+    {
+        EvaluateNode(node);
+        foldable = IsNodeHoistable(node);
+        for (int i = 0; (i < node->output.dataCount) && foldable; i++) foldable = isfinite(node->output.data[i].value);
+    }
+
+    return foldable;
+}
+
+// Links consumers of lerp nodes with a constant 0 or 1 amount to their selected input
+void SpecializeNodes()
+{
+    bool specialized[MAX_NODES] = { false };
+    int specializedCount = 0;
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (reachableNodes[nodes[i]->id])
+        {
+            for (int k = 0; k < nodes[i]->inputsCount; k++)
+            {
+                FNode input = nodes[GetNodeIndex(nodes[i]->inputs[k])];
+                int selected = GetSpecializedInput(input);
+
+                while (selected != -1)
+                {
+                    if (!specialized[input->id]) specializedCount++;
+                    specialized[input->id] = true;
+
+                    input = nodes[GetNodeIndex(selected)];
+                    selected = GetSpecializedInput(input);
+                }
+
+                nodes[i]->inputs[k] = input->id;
+            }
+        }
+    }
+
+    // Prune discarded branches that are not used by other nodes
+    if (specializedCount > 0)
+    {
+        int unreachable = MarkReachableNodes();
+        TraceLogFNode(false, "static specialization: %i lerp nodes replaced by their selected input (%i nodes unreachable)", specializedCount, unreachable);
+    }
+}
+
+// Returns the input node id selected by a lerp node constant 0 or 1 amount (-1 if not constant)
+int GetSpecializedInput(FNode node)
+{
+    int selected = -1;
+
+    if ((node->type == FNODE_LERP) && (node->inputsCount == 3))
+    {
+        FNode amount = nodes[GetNodeIndex(node->inputs[2])];
+
+        if (IsNodeConstant(amount) && (amount->output.dataCount == 1) && ((amount->output.data[0].value == 0.0f) || (amount->output.data[0].value == 1.0f)))
+        {
+            FNode input = nodes[GetNodeIndex(node->inputs[(int)amount->output.data[0].value])];
+            if (input->output.dataCount == node->output.dataCount) selected = input->id;
+        }
+    }
+
+    return selected;
+}
+
+// Collects reachable per instance property nodes compiled as instance attributes
+void CollectInstanceNodes()
+{
+    instanceNodesCount = 0;
+
+    // Instance attributes need explicit attribute locations and divisors
+    if (instancing && (version == GLSL_100))
+    {
+        TraceLogFNode(false, "instancing is not supported by GLSL 100 shader version, shader compiled without instancing");
+        instancing = false;
+    }
+
+    if (instancing)
+    {
+        for (int i = 0; i < MAX_NODES; i++)
+        {
+            for (int k = 0; k < nodesCount; k++)
+            {
+                if ((nodes[k]->id == i) && nodes[k]->instanceProperty && reachableNodes[i])
+                {
+                    if (instanceNodesCount < MAX_INSTANCE_PROPERTIES) instanceNodes[instanceNodesCount++] = i;
+                    else TraceLogFNode(false, "per instance property %i compiled as uniform, max instance properties reached", i);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Returns a per instance property node attribute index (-1 if compiled as uniform)
+int GetInstanceAttribute(FNode node)
+{
+    int attribute = -1;
+
+    for (int i = 0; i < instanceNodesCount; i++)
+    {
+        if (instanceNodes[i] == node->id) attribute = i;
+    }
+
+    return attribute;
+}
+
+// Fills visor stress scene instances buffer and caches instanced shader locations
+void UpdateInstanceBuffer()
+{
+    int count = INSTANCE_GRID*INSTANCE_GRID;
+    float *data = (float *)FNODE_MALLOC(count*INSTANCE_STRIDE*sizeof(float));
+    unsigned int seed = 2166136261u;
+
+    for (int i = 0; i < count; i++)
+    {
+        float *instance = data + i*INSTANCE_STRIDE;
+        float random[4 + MAX_INSTANCE_PROPERTIES] = { 0.0f };
+
+        // Same random sequence every update so only edited properties change between updates
+        for (int k = 0; k < 4 + MAX_INSTANCE_PROPERTIES; k++)
+        {
+            seed = seed*1664525u + 1013904223u;
+            random[k] = (float)(seed >> 8)/16777216.0f;
+        }
+
+        // Instance transform columns with a random rotation around up axis
+        Vector3 position = { (i%INSTANCE_GRID - (INSTANCE_GRID - 1)/2.0f)*INSTANCE_SPACING, -1.0f, (i/INSTANCE_GRID - (INSTANCE_GRID - 1)/2.0f)*INSTANCE_SPACING };
+        Matrix transform = FMatrixMultiply(FMatrixScale(INSTANCE_MODEL_SCALE, INSTANCE_MODEL_SCALE, INSTANCE_MODEL_SCALE), FMatrixRotate((Vector3){ 0, 1, 0 }, random[0]*2.0f*PI));
+        transform = FMatrixMultiply(transform, FMatrixTranslate(position.x, position.y, position.z));
+
+        float matrix[16] = { transform.m0, transform.m1, transform.m2, transform.m3, transform.m4, transform.m5, transform.m6, transform.m7,
+        transform.m8, transform.m9, transform.m10, transform.m11, transform.m12, transform.m13, transform.m14, transform.m15 };
+        for (int k = 0; k < 16; k++) instance[k] = matrix[k];
+
+        // Instance color tint
+        instance[16] = 0.75f + random[1]*0.25f;
+        instance[17] = 0.75f + random[2]*0.25f;
+        instance[18] = 0.75f + random[3]*0.25f;
+        instance[19] = 1.0f;
+
+        // Per instance properties vary between half and one and a half times their editor values
+        for (int k = 0; k < MAX_INSTANCE_PROPERTIES; k++)
+        {
+            float *values = instance + 20 + k*4;
+            for (int j = 0; j < 4; j++) values[j] = 0.0f;
+
+            if (k < instanceNodesCount)
+            {
+                FNode node = nodes[GetNodeIndex(instanceNodes[k])];
+                for (int j = 0; j < node->output.dataCount; j++) values[j] = node->output.data[j].value*((j < 3) ? (0.5f + random[4 + k]) : 1.0f);
+            }
+        }
+    }
+
+    if (instanceBuffer == 0) glGenBuffers(1, &instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, count*INSTANCE_STRIDE*sizeof(float), data, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    FNODE_FREE(data);
+
+    // Instanced draws don't use raylib models drawing so its locations are cached here
+    mvpUniform = GetShaderLocation(shader, "mvp");
+    for (int i = 0; i < MAX_TEXTURES; i++) samplerUniforms[i] = ((textures[i].id > 0) ? glGetUniformLocation(shader.id, FormatText("texture%i", i)) : -1);
+}
+
+// Computes uniform blocks members std140 offsets and blocks size
+void CollectBlockNodes()
+{
+    int offset = 0;
+    int frameOffset = FRAME_BLOCK_SIZE;
+
+    for (int i = 0; i < MAX_NODES; i++)
+    {
+        blockNodes[i] = false;
+        frameNodes[i] = false;
+        blockOffsets[i] = -1;
+    }
+
+    // Block members are the values declared as uniforms, sorted by id with std140 alignment
+    for (int i = 0; (i < MAX_NODES) && uniformBlocks; i++)
+    {
+        for (int k = 0; k < nodesCount; k++)
+        {
+            if ((nodes[k]->id == i) && reachableNodes[i] && !foldedNodes[i])
+            {
+                bool hoistedUniform = (hoistedNodes[i] && (nodeStages[i] == STAGE_UNIFORM));
+
+                if (hoistedUniform || ((nodes[k]->type >= FNODE_MATRIX) && (nodes[k]->type <= FNODE_VECTOR4) && !nodes[k]->staticProperty && (GetInstanceAttribute(nodes[k]) == -1) && (nodes[k]->property || (compileMode == COMPILE_AUTHORING))))
+                {
+                    int count = nodes[k]->output.dataCount;
+                    int alignment = ((count == 1) ? 4 : ((count == 2) ? 8 : 16));
+                    bool visited[MAX_NODES] = { false };
+
+                    blockNodes[i] = true;
+
+                    // Hoisted nodes calculated from time change every frame, they follow per frame block shared members so material block is only sent when edited
+                    if (hoistedUniform && IsNodeVarying(nodes[k], visited))
+                    {
+                        frameOffset = (frameOffset + alignment - 1)/alignment*alignment;
+                        frameNodes[i] = true;
+                        blockOffsets[i] = frameOffset;
+                        frameOffset += count*4;
+                    }
+                    else
+                    {
+                        offset = (offset + alignment - 1)/alignment*alignment;
+                        blockOffsets[i] = offset;
+                        offset += ((count == 16) ? 64 : count*4);
+                    }
+                }
+
+                break;
+            }
+        }
+    }
+
+    materialBlockSize = (offset + 15)/16*16;
+    frameBlockSize = (frameOffset + 15)/16*16;
+}
+
+// Writes shared per frame and per material std140 uniform blocks declarations
+void WriteUniformBlocks(FILE *file)
+{
+    // GLSL ES 300 members declared in both stages must match precision, fragment shader default precision can be lower
+    const char *precision = ((version == GLSL_300ES) ? "highp " : "");
+
+    if (version == GLSL_430) fprintf(file, "layout(std140, binding = %i) uniform FrameData\n", FRAME_BLOCK_BINDING);
+    else fprintf(file, "layout(std140) uniform FrameData\n");
+
+    fprintf(file, "{\n");
+    fprintf(file, "    %smat4 modelMatrix;    // offset 0\n", precision);
+    fprintf(file, "    %svec3 viewDirection;    // offset 64\n", precision);
+    fprintf(file, "    %sfloat vertCurrentTime;    // offset 76\n", precision);
+    fprintf(file, "    %sfloat fragCurrentTime;    // offset 80\n", precision);
+
+    for (int i = 0; i < MAX_NODES; i++)
+    {
+        if (frameNodes[i]) fprintf(file, "    %s%s node_%02i;    // offset %i\n", precision, GetDataTypeName(nodes[GetNodeIndex(i)]->output.dataCount), i, blockOffsets[i]);
+    }
+
+    fprintf(file, "};\n\n");
+
+    // Empty blocks are not valid GLSL
+    if (materialBlockSize > 0)
+    {
+        if (version == GLSL_430) fprintf(file, "layout(std140, binding = %i) uniform MaterialData\n{\n", MATERIAL_BLOCK_BINDING);
+        else fprintf(file, "layout(std140) uniform MaterialData\n{\n");
+
+        for (int i = 0; i < MAX_NODES; i++)
+        {
+            if (blockNodes[i] && !frameNodes[i]) fprintf(file, "    %s%s node_%02i;    // offset %i\n", precision, GetDataTypeName(nodes[GetNodeIndex(i)]->output.dataCount), i, blockOffsets[i]);
+        }
+
+        fprintf(file, "};\n\n");
+    }
+}
+
+// Creates uniform buffers and binds current shader uniform blocks to their binding points
+void BindUniformBlocks()
+{
+    // Per frame buffer is shared by all shaders, its size follows current shader hoisted per frame nodes
+    if (frameBuffer == 0) glGenBuffers(1, &frameBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, frameBlockSize, NULL, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, frameBuffer);
+
+    if (materialBlockSize > 0)
+    {
+        if (materialBuffer == 0) glGenBuffers(1, &materialBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, materialBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, materialBlockSize, NULL, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BLOCK_BINDING, materialBuffer);
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    unsigned int frameIndex = glGetUniformBlockIndex(shader.id, "FrameData");
+    if (frameIndex != GL_INVALID_INDEX) glUniformBlockBinding(shader.id, frameIndex, FRAME_BLOCK_BINDING);
+
+    unsigned int materialIndex = glGetUniformBlockIndex(shader.id, "MaterialData");
+    if (materialIndex != GL_INVALID_INDEX) glUniformBlockBinding(shader.id, materialIndex, MATERIAL_BLOCK_BINDING);
+
+    for (int i = 0; i < MAX_BLOCK_SIZE/4; i++)
+    {
+        frameBlock[i] = 0.0f;
+        materialBlock[i] = 0.0f;
+    }
+
+    materialBlockChanged = true;
+}
+
+// Sends per frame and changed per material uniform blocks data with a single buffer update each
+void UploadUniformBlocks()
+{
+    Matrix transform = model.transform;
+    Vector3 viewVector = { camera3d.position.x - camera3d.target.x, camera3d.position.y - camera3d.target.y, camera3d.position.z - camera3d.target.z };
+    viewVector = FVector3Normalize(viewVector);
+
+    float matrix[16] = { transform.m0, transform.m1, transform.m2, transform.m3, transform.m4, transform.m5, transform.m6, transform.m7,
+    transform.m8, transform.m9, transform.m10, transform.m11, transform.m12, transform.m13, transform.m14, transform.m15 };
+    for (int i = 0; i < 16; i++) frameBlock[i] = matrix[i];
+
+    frameBlock[16] = viewVector.x;
+    frameBlock[17] = viewVector.y;
+    frameBlock[18] = viewVector.z;
+    frameBlock[19] = currentTime;
+    frameBlock[20] = currentTime;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, frameBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, frameBlockSize, frameBlock);
+
+    if (materialBlockChanged && (materialBlockSize > 0))
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, materialBuffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, materialBlockSize, materialBlock);
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    materialBlockChanged = false;
+}
+
+// Links consumers of structurally identical nodes to a single representative node while compiling
+void MergeNodes()
+{
+    int mergedCount = 0;
+
+    for (int i = 0; i < MAX_NODES; i++) mergedNodes[i] = -1;
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (reachableNodes[nodes[i]->id]) GetMergedNode(nodes[i]);
+    }
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (reachableNodes[nodes[i]->id] && (mergedNodes[nodes[i]->id] != nodes[i]->id))
+        {
+            // Duplicated nodes are detached from their inputs so they are not counted as consumers
+            for (int k = 0; k < MAX_INPUTS; k++) nodes[i]->inputs[k] = -1;
+            nodes[i]->inputsCount = 0;
+            reachableNodes[nodes[i]->id] = false;
+
+            TraceLogFNode(false, "node %i merged with identical node %i", nodes[i]->id, mergedNodes[nodes[i]->id]);
+            mergedCount++;
+        }
+        else if (reachableNodes[nodes[i]->id])
+        {
+            for (int k = 0; k < nodes[i]->inputsCount; k++) nodes[i]->inputs[k] = mergedNodes[nodes[i]->inputs[k]];
+        }
+    }
+
+    if (mergedCount > 0) TraceLogFNode(false, "common subexpressions: %i duplicated nodes merged", mergedCount);
+}
+
+// Returns the representative node id of a node and all its structurally identical nodes
+int GetMergedNode(FNode node)
+{
+    if (mergedNodes[node->id] == -1)
+    {
+        int merged = node->id;
+        mergedNodes[node->id] = node->id;
+
+        for (int i = 0; i < node->inputsCount; i++)
+        {
+            int index = GetNodeIndex(node->inputs[i]);
+            GetMergedNode(nodes[index]);
+        }
+
+        // Search previous representative nodes with the same hash and check their structure
+        nodeHashes[node->id] = GetNodeHash(node);
+
+        for (int i = 0; (i < nodesCount) && (merged == node->id); i++)
+        {
+            int id = nodes[i]->id;
+            if ((id != node->id) && (mergedNodes[id] == id) && (nodeHashes[id] == nodeHashes[node->id]) && IsNodeEqual(node, nodes[i])) merged = id;
+        }
+
+        mergedNodes[node->id] = merged;
+    }
+
+    return mergedNodes[node->id];
+}
+
+// Returns a hash of a node operation, values count and representative inputs
+unsigned int GetNodeHash(FNode node)
+{
+    unsigned int hash = 2166136261u;
+
+    // Constant nodes are identified by their values and operator nodes by their inputs
+    if (IsNodeConstant(node))
+    {
+        for (int i = 0; i < node->output.dataCount; i++)
+        {
+            unsigned int bits = 0;
+            memcpy(&bits, &node->output.data[i].value, sizeof(float));
+            hash = (hash ^ bits)*16777619u;
+        }
+    }
+    else
+    {
+        int inputs[MAX_INPUTS] = { -1, -1, -1, -1 };
+        GetMergedInputs(node, inputs);
+
+        hash = (hash ^ (unsigned int)(node->type + 2))*16777619u;
+        hash = (hash ^ (unsigned int)(node->function + 1))*16777619u;
+        for (int i = 0; i < node->inputsCount; i++) hash = (hash ^ (unsigned int)inputs[i])*16777619u;
+    }
+
+    hash = (hash ^ (unsigned int)node->output.dataCount)*16777619u;
+
+    return hash;
+}
+
+// Check if two nodes compute the same values from the same representative inputs
+bool IsNodeEqual(FNode a, FNode b)
+{
+    bool equal = ((a->type != FNODE_VERTEX) && (a->type != FNODE_FRAGMENT) && (b->type != FNODE_VERTEX) && (b->type != FNODE_FRAGMENT) && (a->output.dataCount == b->output.dataCount));
+
+    if (equal)
+    {
+        if (IsNodeConstant(a) || IsNodeConstant(b))
+        {
+            equal = (IsNodeConstant(a) && IsNodeConstant(b));
+            for (int i = 0; (i < a->output.dataCount) && equal; i++) equal = (a->output.data[i].value == b->output.data[i].value);
+        }
+        else if ((a->type == b->type) && (a->inputsCount == b->inputsCount) && (a->function == b->function))
+        {
+            // Editable values are different uniforms, so only shader built-in values are equal without inputs
+            if (a->inputsCount == 0) equal = ((a->type >= FNODE_TIME) && (a->type <= FNODE_MVP));
+            else
+            {
+                int inputsA[MAX_INPUTS] = { -1, -1, -1, -1 };
+                int inputsB[MAX_INPUTS] = { -1, -1, -1, -1 };
+                GetMergedInputs(a, inputsA);
+                GetMergedInputs(b, inputsB);
+
+                for (int i = 0; (i < a->inputsCount) && equal; i++) equal = (inputsA[i] == inputsB[i]);
+            }
+        }
+        else equal = false;
+    }
+
+    return equal;
+}
+
+// Returns a node inputs representative node ids (sorted for commutative operations)
+void GetMergedInputs(FNode node, int *inputs)
+{
+    for (int i = 0; i < node->inputsCount; i++) inputs[i] = mergedNodes[node->inputs[i]];
+
+    if (IsNodeCommutative(node))
+    {
+        for (int i = 1; i < node->inputsCount; i++)
+        {
+            for (int k = i; (k > 0) && (inputs[k - 1] > inputs[k]); k--)
+            {
+                int temp = inputs[k];
+                inputs[k] = inputs[k - 1];
+                inputs[k - 1] = temp;
+            }
+        }
+    }
+}
+
+// Check if a node operation result does not depend on its inputs order
+bool IsNodeCommutative(FNode node)
+{
+    bool commutative = false;
+
+    switch (node->type)
+    {
+        case FNODE_ADD:
+        case FNODE_MULTIPLY:
+        case FNODE_MAX:
+        case FNODE_MIN:
+        case FNODE_DISTANCE:
+        case FNODE_DOTPRODUCT:
+        case FNODE_HALFDIRECTION: commutative = true; break;
+        default: break;
+    }
+
+    for (int i = 0; i < node->inputsCount; i++)
+    {
+        int index = GetNodeIndex(node->inputs[i]);
+        int firstIndex = GetNodeIndex(node->inputs[0]);
+
+        // Inputs order only can be ignored if GLSL operation does not depend on their types
+        if ((nodes[index]->output.dataCount != nodes[firstIndex]->output.dataCount) || (nodes[index]->output.dataCount > 4)) commutative = false;
+    }
+
+    return commutative;
+}
+
+// Computes fragment graph nodes evaluation stage and marks nodes to hoist out of fragment shader
+void PlaceNodes()
+{
+    int varyingsCount = 0;
+
+    for (int i = 0; i < MAX_NODES; i++)
+    {
+        nodeStages[i] = STAGE_NONE;
+        hoistedNodes[i] = false;
+
+        // Nodes approximated by their average values don't evaluate their inputs
+        if (approximatedNodes[i]) nodeStages[i] = STAGE_FRAGMENT;
+    }
+
+    if (nodes[1]->inputsCount > 0)
+    {
+        int index = GetNodeIndex(nodes[1]->inputs[0]);
+        PlaceNode(nodes[index]);
+
+        // Hoist operator nodes evaluated in a cheaper stage than any of their consumers
+        for (int i = 0; i < nodesCount; i++)
+        {
+            ShaderStage stage = nodeStages[nodes[i]->id];
+            bool hoist = false;
+
+            if (((stage == STAGE_UNIFORM) || (stage == STAGE_VERTEX)) && (nodes[i]->type >= FNODE_ADD) && (nodes[i]->type != FNODE_VERTEXCOLOR) && (nodes[i]->output.dataCount <= 4) && !foldedNodes[nodes[i]->id])
+            {
+                hoist = (nodes[i]->id == nodes[1]->inputs[0]);
+
+                for (int k = 0; (k < nodesCount) && !hoist; k++)
+                {
+                    if ((nodeStages[nodes[k]->id] != STAGE_NONE) && (nodeStages[nodes[k]->id] != stage))
+                    {
+                        for (int j = 0; j < nodes[k]->inputsCount; j++)
+                        {
+                            if (nodes[k]->inputs[j] == nodes[i]->id) hoist = true;
+                        }
+                    }
+                }
+
+                if (hoist && (stage == STAGE_VERTEX))
+                {
+                    if (varyingsCount < MAX_HOISTED_VARYINGS) varyingsCount++;
+                    else hoist = false;
+                }
+            }
+
+            hoistedNodes[nodes[i]->id] = hoist;
+        }
+    }
+}
+
+// Returns the cheapest stage where a fragment graph node can be evaluated
+ShaderStage PlaceNode(FNode node)
+{
+    if (nodeStages[node->id] == STAGE_NONE)
+    {
+        ShaderStage stage = STAGE_FRAGMENT;
+
+        switch (node->type)
+        {
+            case FNODE_PI:
+            case FNODE_E:
+            case FNODE_TIME:
+            case FNODE_MATRIX:
+            case FNODE_VALUE:
+            case FNODE_VECTOR2:
+            case FNODE_VECTOR3:
+            case FNODE_VECTOR4: stage = ((GetInstanceAttribute(node) != -1) ? STAGE_VERTEX : STAGE_UNIFORM); break;
+            case FNODE_VERTEXPOSITION:
+            case FNODE_VERTEXNORMAL:
+            case FNODE_VERTEXCOLOR: stage = STAGE_VERTEX; break;
+            case FNODE_FRESNEL:
+            case FNODE_VIEWDIRECTION:
+            case FNODE_MVP:
+            case FNODE_SAMPLER2D: stage = STAGE_FRAGMENT; break;
+            case FNODE_SAMPLERLOD:
+            case FNODE_SAMPLERBIAS:
+            case FNODE_SAMPLERGRAD:
+            {
+                // Level of detail, bias and gradients inputs can be evaluated in a cheaper stage than the fetch
+                for (int i = 2; i < node->inputsCount; i++) PlaceNode(nodes[GetNodeIndex(node->inputs[i])]);
+                stage = STAGE_FRAGMENT;
+            } break;
+            case FNODE_LUT:
+            {
+                // Baked lookup tables only evaluate their coordinates inputs
+                for (int i = 0; i < node->inputsCount; i++)
+                {
+                    if ((i % 2 == 1) || !IsLutNodeBakeable(node)) PlaceNode(nodes[GetNodeIndex(node->inputs[i])]);
+                }
+            } break;
+            default:
+            {
+                ShaderStage stages[MAX_INPUTS] = { STAGE_NONE, STAGE_NONE, STAGE_NONE, STAGE_NONE };
+                ShaderStage inputsStage = STAGE_UNIFORM;
+
+                for (int i = 0; i < node->inputsCount; i++)
+                {
+                    int index = GetNodeIndex(node->inputs[i]);
+                    stages[i] = PlaceNode(nodes[index]);
+                    if (stages[i] > inputsStage) inputsStage = stages[i];
+                }
+
+                if (node->inputsCount > 0)
+                {
+                    // Per frame values are calculated in CPU when possible, otherwise once per vertex
+                    if (inputsStage == STAGE_UNIFORM) stage = (IsNodeHoistable(node) ? STAGE_UNIFORM : STAGE_VERTEX);
+                    else if ((inputsStage == STAGE_VERTEX) && IsNodeLinear(node, stages)) stage = STAGE_VERTEX;
+                }
+            } break;
+        }
+
+        nodeStages[node->id] = stage;
+    }
+
+    return nodeStages[node->id];
+}
+
+// Check if a node CPU calculated values match its GLSL operation
+bool IsNodeHoistable(FNode node)
+{
+    bool hoistable = ((node->output.dataCount > 0) && (node->output.dataCount <= 4));
+
+    switch (node->type)
+    {
+        case FNODE_ADD:
+        case FNODE_SUBTRACT:
+        case FNODE_MULTIPLY:
+        case FNODE_DIVIDE:
+        case FNODE_APPEND:
+        case FNODE_ONEMINUS:
+        case FNODE_ABS:
+        case FNODE_COS:
+        case FNODE_SIN:
+        case FNODE_TAN:
+        case FNODE_DEG2RAD:
+        case FNODE_RAD2DEG:
+        case FNODE_NORMALIZE:
+        case FNODE_NEGATE:
+        case FNODE_RECIPROCAL:
+        case FNODE_SQRT:
+        case FNODE_TRUNC:
+        case FNODE_CEIL:
+        case FNODE_CLAMP01:
+        case FNODE_EXP2:
+        case FNODE_POSTERIZE:
+        case FNODE_MAX:
+        case FNODE_MIN:
+        case FNODE_CROSSPRODUCT:
+        case FNODE_DOTPRODUCT:
+        case FNODE_LENGTH: break;
+        case FNODE_STEP: hoistable = (hoistable && (node->output.dataCount == 1)); break;
+        case FNODE_LERP: hoistable = (hoistable && (node->output.dataCount <= 2)); break;
+        case FNODE_FUNCTION: hoistable = (hoistable && functions[node->function]->exact); break;
+        default: hoistable = false; break;
+    }
+
+    // Check inputs values count to avoid GLSL implicit conversions not handled by CPU calculations
+    for (int i = 0; (i < node->inputsCount) && hoistable; i++)
+    {
+        int index = GetNodeIndex(node->inputs[i]);
+        int count = nodes[index]->output.dataCount;
+
+        switch (node->type)
+        {
+            case FNODE_APPEND: hoistable = (count <= 4); break;
+            case FNODE_NORMALIZE:
+            case FNODE_DOTPRODUCT:
+            case FNODE_LENGTH: hoistable = ((count > 1) && (count <= 4)); break;
+            case FNODE_MULTIPLY:
+            case FNODE_DIVIDE: hoistable = ((count == node->output.dataCount) || ((i > 0) && (count == 1))); break;
+            case FNODE_POSTERIZE: hoistable = ((i == 0) ? (count == node->output.dataCount) : (count == 1)); break;
+            case FNODE_LERP: hoistable = ((count == node->output.dataCount) || ((i == 2) && (count == 1))); break;
+            case FNODE_FUNCTION: hoistable = (count == functions[node->function]->nodes[i]->output.dataCount); break;
+            default: hoistable = (count == node->output.dataCount); break;
+        }
+    }
+
+    return hoistable;
+}
+
+// Check if a node operation is linear in its per vertex inputs (so interpolating it gives the same result)
+bool IsNodeLinear(FNode node, ShaderStage *stages)
+{
+    bool linear = false;
+    int vertexInputs = 0;
+
+    for (int i = 0; i < node->inputsCount; i++)
+    {
+        if (stages[i] == STAGE_VERTEX) vertexInputs++;
+    }
+
+    switch (node->type)
+    {
+        case FNODE_ADD:
+        case FNODE_SUBTRACT:
+        case FNODE_APPEND:
+        case FNODE_ONEMINUS:
+        case FNODE_NEGATE:
+        case FNODE_DEG2RAD:
+        case FNODE_RAD2DEG:
+        case FNODE_TRANSPOSE: linear = true; break;
+        case FNODE_MULTIPLY:
+        case FNODE_MULTIPLYMATRIX:
+        case FNODE_CROSSPRODUCT:
+        case FNODE_DOTPRODUCT: linear = (vertexInputs <= 1); break;
+        case FNODE_DIVIDE: linear = ((vertexInputs == 1) && (stages[0] == STAGE_VERTEX)); break;
+        case FNODE_LERP: linear = ((stages[2] == STAGE_UNIFORM) || ((stages[0] == STAGE_UNIFORM) && (stages[1] == STAGE_UNIFORM))); break;
+        default: break;
+    }
+
+    return linear;
+}
+
+// Returns instructions count of a node and its not counted inputs in fragment shader (hoisted and folded nodes are skipped if required)
+int CountNodeInstructions(FNode node, bool *counted, bool hoisting)
+{
+    int count = 0;
+
+    if (!counted[node->id] && !(hoisting && (hoistedNodes[node->id] || foldedNodes[node->id])))
+    {
+        counted[node->id] = true;
+
+        if (((node->type >= FNODE_ADD) && (node->type != FNODE_VERTEXCOLOR)) || (node->type == FNODE_FRESNEL)) count++;
+
+        for (int i = 0; i < node->inputsCount; i++)
+        {
+            int index = GetNodeIndex(node->inputs[i]);
+
+            // Baked lookup tables input subgraph is not evaluated in shader
+            if (!hoisting || (node->type != FNODE_LUT) || (i % 2 == 1) || !IsLutNodeBakeable(node)) count += CountNodeInstructions(nodes[index], counted, hoisting);
+        }
+    }
+
+    return count;
+}
+
+// Returns the cost of a node operation based on its type and output data count
+ShaderCost GetNodeCost(FNode node)
+{
+    ShaderCost cost = { 0 };
+    int count = node->output.dataCount;
+    int inputCount = count;
+
+    if (node->inputsCount > 0) inputCount = nodes[GetNodeIndex(node->inputs[0])]->output.dataCount;
+
+    switch (node->type)
+    {
+        case FNODE_FRESNEL: cost.alu = 4; break;
+        case FNODE_ADD:
+        case FNODE_SUBTRACT: cost.alu = count*(node->inputsCount - 1); break;
+        case FNODE_MULTIPLY:
+        {
+            // Matrix and vector multiplications are a dot product per output component
+            for (int i = 1; i < node->inputsCount; i++)
+            {
+                int dataCount = nodes[GetNodeIndex(node->inputs[i])]->output.dataCount;
+                if ((dataCount == 16) || (inputCount == 16)) cost.alu += ((count == 16) ? 64 : 16);
+                else cost.alu += count;
+            }
+        } break;
+        case FNODE_DIVIDE:
+        {
+            cost.alu = count*(node->inputsCount - 1);
+            cost.transcendental = count*(node->inputsCount - 1);
+        } break;
+        case FNODE_ONEMINUS:
+        case FNODE_ABS:
+        case FNODE_DEG2RAD:
+        case FNODE_RAD2DEG:
+        case FNODE_NEGATE:
+        case FNODE_TRUNC:
+        case FNODE_ROUND:
+        case FNODE_CEIL:
+        case FNODE_CLAMP01:
+        case FNODE_STEP:
+        case FNODE_MAX:
+        case FNODE_MIN: cost.alu = count; break;
+        case FNODE_COS:
+        case FNODE_SIN:
+        case FNODE_TAN:
+        case FNODE_RECIPROCAL:
+        case FNODE_SQRT:
+        case FNODE_EXP2: cost.transcendental = count; break;
+        case FNODE_POWER:
+        {
+            cost.alu = count;
+            cost.transcendental = count*2;
+        } break;
+        case FNODE_POSTERIZE:
+        {
+            cost.alu = count*2;
+            cost.transcendental = count;
+        } break;
+        case FNODE_LERP: cost.alu = count*2; break;
+        case FNODE_SMOOTHSTEP:
+        {
+            cost.alu = count*5;
+            cost.transcendental = count;
+        } break;
+        case FNODE_NORMALIZE:
+        {
+            cost.alu = inputCount + count;
+            cost.transcendental = 1;
+        } break;
+        case FNODE_LENGTH:
+        {
+            cost.alu = inputCount;
+            cost.transcendental = 1;
+        } break;
+        case FNODE_DISTANCE:
+        {
+            cost.alu = inputCount*2;
+            cost.transcendental = 1;
+        } break;
+        case FNODE_DOTPRODUCT: cost.alu = inputCount; break;
+        case FNODE_CROSSPRODUCT: cost.alu = 6; break;
+        case FNODE_DESATURATE: cost.alu = 3 + count*2; break;
+        case FNODE_MULTIPLYMATRIX: cost.alu = 64; break;
+        case FNODE_PROJECTION:
+        case FNODE_REJECTION:
+        {
+            cost.alu = count*(inputCount*2 + 1);
+            cost.transcendental = count;
+        } break;
+        case FNODE_HALFDIRECTION:
+        {
+            cost.alu = count*2 + inputCount;
+            cost.transcendental = 1;
+        } break;
+        case FNODE_SAMPLER2D:
+        {
+            cost.texture = 1;
+
+            // Full color and alpha channel samples discard transparent fragments
+            if (node->inputsCount > 1)
+            {
+                int channel = (int)nodes[GetNodeIndex(node->inputs[1])]->output.data[0].value;
+                if ((channel == 0) || (channel == 5)) cost.discard = 1;
+            }
+        } break;
+        case FNODE_SAMPLERLOD: cost.texture = 1; break;
+        case FNODE_SAMPLERBIAS:
+        {
+            // Biased fetches add the bias to the level of detail calculated from implicit derivatives
+            cost.alu = 1;
+            cost.texture = 1;
+        } break;
+        case FNODE_SAMPLERGRAD:
+        {
+            // Explicit gradients fetches run at half texture rate and scale both gradients to compute the level of detail
+            cost.alu = 4;
+            cost.texture = 2;
+        } break;
+        case FNODE_LUT:
+        {
+            // Baked lookup tables cost a coordinate scale and offset per axis and a texture fetch
+            if (IsLutNodeBakeable(node))
+            {
+                cost.alu = ((node->inputsCount > 3) ? 2 : 1);
+                cost.texture = 1;
+            }
+        } break;
+        case FNODE_FUNCTION: cost = functions[node->function]->cost; break;
+        default: break;
+    }
+
+    // Atlas packed textures clamp and remap texture coordinates (and scale gradients) before sampling
+    if (((node->type == FNODE_SAMPLER2D) || (node->type >= FNODE_SAMPLERLOD)) && (node->inputsCount > 0) && (packedMode == PACKING_ATLAS))
+    {
+        if (packedUnits[(int)nodes[GetNodeIndex(node->inputs[0])]->output.data[0].value]) cost.alu += ((node->type == FNODE_SAMPLERGRAD) ? 8 : 4);
+    }
+
+    return cost;
+}
+
+// Returns the weighted total of a shader cost
+int GetCostTotal(ShaderCost cost)
+{
+    return (cost.alu*COST_ALU + cost.transcendental*COST_TRANSCENDENTAL + cost.texture*COST_TEXTURE + cost.discard*COST_DISCARD);
+}
+
+// Adds a compiled node cost to its shader stage cost
+void AddNodeCost(FNode node, ShaderCost cost, bool fragment)
+{
+    ShaderCost *stageCost = (fragment ? &fragmentCost : &vertexCost);
+
+    // Samplers of an already fetched texture unit only read its shared texel
+    if ((node->type == FNODE_SAMPLER2D) && fetchedUnits[(int)nodes[GetNodeIndex(node->inputs[0])]->output.data[0].value])
+    {
+        cost.alu = 0;
+        cost.texture = 0;
+    }
+
+    // Vertex texture samples don't discard
+    if ((node->type == FNODE_SAMPLER2D) && !fragment) cost.discard = 0;
+
+    stageCost->alu += cost.alu;
+    stageCost->transcendental += cost.transcendental;
+    stageCost->texture += cost.texture;
+    stageCost->discard += cost.discard;
+
+    if (fragment)
+    {
+        nodeCosts[node->id].alu += cost.alu;
+        nodeCosts[node->id].transcendental += cost.transcendental;
+        nodeCosts[node->id].texture += cost.texture;
+        nodeCosts[node->id].discard += cost.discard;
+    }
+}
+
+// Returns GLSL data type name of an output values count
+const char *GetDataTypeName(int dataCount)
+{
+    const char *name = "float";
+
+    switch (dataCount)
+    {
+        case 2: name = "vec2"; break;
+        case 3: name = "vec3"; break;
+        case 4: name = "vec4"; break;
+        case 16: name = "mat4"; break;
+        default: break;
+    }
+
+    return name;
+}
+
+// Returns the lowest precision which fits a node values range and source
+Precision GetNodePrecision(FNode node)
+{
+    if (nodePrecisions[node->id] == PRECISION_AUTO)
+    {
+        Precision precision = PRECISION_LOWP;
+        float range = 0.0f;
+        float ranges[MAX_INPUTS] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        // Operations are calculated with the highest precision of their inputs
+        for (int i = 0; i < node->inputsCount; i++)
+        {
+            int index = GetNodeIndex(node->inputs[i]);
+            Precision inputPrecision = GetNodePrecision(nodes[index]);
+
+            if (inputPrecision > precision) precision = inputPrecision;
+            ranges[i] = nodeRanges[nodes[index]->id];
+        }
+
+        switch (node->type)
+        {
+            case FNODE_PI:
+            case FNODE_E:
+            case FNODE_VALUE:
+            case FNODE_VECTOR2:
+            case FNODE_VECTOR3:
+            case FNODE_VECTOR4:
+            {
+                for (int i = 0; i < node->output.dataCount; i++)
+                {
+                    if (fabs(node->output.data[i].value) > range) range = fabs(node->output.data[i].value);
+                }
+
+                if (node->type == FNODE_PI) range = PI;
+                else if (node->type == FNODE_E) range = 2.72f;
+
+                // Uniform values can be edited so they are not stored with less than default precision
+                if (!node->staticProperty && (node->property || (compileMode == COMPILE_AUTHORING))) precision = PRECISION_MEDIUMP;
+            } break;
+            case FNODE_TIME:
+            case FNODE_VERTEXPOSITION:
+            case FNODE_MVP:
+            case FNODE_MATRIX:
+            {
+                precision = PRECISION_HIGHP;
+                range = UNBOUNDED_RANGE;
+            } break;
+            case FNODE_VERTEXNORMAL:
+            case FNODE_VIEWDIRECTION:
+            {
+                precision = PRECISION_MEDIUMP;
+                range = 1.0f;
+            } break;
+            case FNODE_FRESNEL:
+            {
+                precision = PRECISION_MEDIUMP;
+                range = 2.0f;
+            } break;
+            case FNODE_VERTEXCOLOR:
+            case FNODE_SAMPLER2D:
+            case FNODE_SAMPLERLOD:
+            case FNODE_SAMPLERBIAS:
+            case FNODE_SAMPLERGRAD:
+            {
+                precision = PRECISION_LOWP;
+                range = 1.0f;
+            } break;
+            case FNODE_ADD:
+            case FNODE_SUBTRACT:
+            {
+                for (int i = 0; i < node->inputsCount; i++) range += ranges[i];
+            } break;
+            case FNODE_MULTIPLY:
+            {
+                range = 1.0f;
+                for (int i = 0; i < node->inputsCount; i++) range *= ranges[i];
+            } break;
+            case FNODE_APPEND:
+            case FNODE_MAX:
+            case FNODE_MIN:
+            {
+                for (int i = 0; i < node->inputsCount; i++)
+                {
+                    if (ranges[i] > range) range = ranges[i];
+                }
+            } break;
+            case FNODE_ONEMINUS: range = 1.0f + ranges[0]; break;
+            case FNODE_ABS:
+            case FNODE_NEGATE:
+            case FNODE_POSTERIZE:
+            case FNODE_LUT:
+            case FNODE_OPTIONAL: range = ranges[0]; break;
+            case FNODE_TRUNC:
+            case FNODE_ROUND:
+            case FNODE_CEIL: range = ranges[0] + 1.0f; break;
+            case FNODE_DEG2RAD: range = ranges[0]*DEG2RAD; break;
+            case FNODE_RAD2DEG: range = ranges[0]*RAD2DEG; break;
+            case FNODE_SQRT: range = sqrt(ranges[0]); break;
+            case FNODE_EXP2: range = pow(2.0f, ranges[0]); break;
+            case FNODE_LERP: range = (ranges[0] + ranges[1])*(1.0f + ranges[2]); break;
+            case FNODE_CROSSPRODUCT: range = 2.0f*ranges[0]*ranges[1]; break;
+            case FNODE_DOTPRODUCT: range = 4.0f*ranges[0]*ranges[1]; break;
+            case FNODE_LENGTH: range = 2.0f*ranges[0]; break;
+            case FNODE_DISTANCE: range = 2.0f*(ranges[0] + ranges[1]); break;
+            case FNODE_DESATURATE: range = ((ranges[0] > 1.0f) ? ranges[0] : 1.0f); break;
+            case FNODE_COS:
+            case FNODE_SIN:
+            case FNODE_NORMALIZE:
+            case FNODE_CLAMP01:
+            case FNODE_STEP:
+            case FNODE_SMOOTHSTEP:
+            case FNODE_HALFDIRECTION:
+            {
+                // Bounded results don't need more than default precision whatever their inputs are
+                if (precision > PRECISION_MEDIUMP) precision = PRECISION_MEDIUMP;
+                range = 1.0f;
+            } break;
+            default: range = UNBOUNDED_RANGE; break;
+        }
+
+        // Promote precision when estimated range exceeds current precision guaranteed range
+        if (!(range < UNBOUNDED_RANGE)) range = UNBOUNDED_RANGE;
+        if ((precision == PRECISION_LOWP) && (range > LOWP_RANGE)) precision = PRECISION_MEDIUMP;
+        if ((precision == PRECISION_MEDIUMP) && (range > MEDIUMP_RANGE)) precision = PRECISION_HIGHP;
+
+        nodePrecisions[node->id] = precision;
+        nodeRanges[node->id] = range;
+    }
+
+    return nodePrecisions[node->id];
+}
+
+// Returns GLSL 100 and GLSL ES 300 precision qualifier of a node declaration (empty if precision is not selected per node)
+const char *GetPrecisionQualifier(FNode node, bool fragment)
+{
+    const char *qualifier = "";
+
+    if (fragment && ((version == GLSL_100) || (version == GLSL_300ES)) && (precisionMode == PRECISION_AUTO))
+    {
+        switch (GetNodePrecision(node))
+        {
+            case PRECISION_LOWP: qualifier = "lowp "; break;
+            case PRECISION_MEDIUMP: qualifier = "mediump "; break;
+            case PRECISION_HIGHP: qualifier = "HIGHP "; break;
+            default: break;
+        }
+    }
+
+    return qualifier;
+}
+
+// Returns GLSL 100 and GLSL ES 300 precision qualifier of a value uniform declaration (explicit in both stages if both can declare it)
+const char *GetUniformPrecision(FNode node, bool fragment)
+{
+    const char *qualifier = "";
+
+    // Uniforms declared in both stages must match precision, vertex shader default precision is highp and fragment shader default precision can be lower
+    if (((version == GLSL_100) || (version == GLSL_300ES)) && vertexStageNodes[node->id] && fragmentStageNodes[node->id])
+    {
+        switch (precisionMode)
+        {
+            case PRECISION_AUTO: qualifier = ((GetNodePrecision(node) == PRECISION_HIGHP) ? "HIGHP " : "mediump "); break;
+            case PRECISION_LOWP: qualifier = "lowp "; break;
+            case PRECISION_MEDIUMP: qualifier = "mediump "; break;
+            case PRECISION_HIGHP: qualifier = "highp "; break;
+            default: break;
+        }
+    }
+    else if (fragment && (GetNodePrecision(node) == PRECISION_HIGHP)) qualifier = GetPrecisionQualifier(node, fragment);
+
+    return qualifier;
+}
+
+// Marks a node and its inputs as nodes a shader stage can declare
+void MarkStageNodes(FNode node, bool *stage)
+{
+    if (!stage[node->id])
+    {
+        stage[node->id] = true;
+
+        for (int i = 0; i < node->inputsCount; i++) MarkStageNodes(nodes[GetNodeIndex(node->inputs[i])], stage);
+    }
+}
+
+// Compiles all node structure to create the GLSL fragment shader in output folder
+void CompileShader()
+{
+    // Reset previous compiled shader data
+    if (loadedShader || (shader.id > 0)) UnloadShader(shader);
+    remove(DATA_PATH);
+    for (int i = 0; i < MAX_VARIANTS; i++)
+    {
+        char vertexPath[64] = { '\0' };
+        char fragmentPath[64] = { '\0' };
+        GetLodPaths(i, vertexPath, fragmentPath);
+        remove(vertexPath);
+        remove(fragmentPath);
+
+        // Reflection files of variants not generated anymore (depth only variant) are removed with their shaders
+        GetReflectionPaths(i, vertexPath, fragmentPath);
+        remove(vertexPath);
+        remove(fragmentPath);
+    }
+    model.material.shader = GetShaderDefault();
+    frameOrderCount = 0;
+    compileState = -1;
+    compileFrame = 0;
+    viewUniform = -1;
+    transformUniform = -1;
+    timeUniformV = -1;
+    timeUniformF = -1;
+    packUniform = -1;
+    for (int i = 0; i < MAX_NODES; i++) valueUniforms[i] = -1;
+    for (int i = 0; i < MAX_NODES; i++) lutDomains[i] = (Vector4){ 0, 0, 0, 0 };
+
+    // Prune nodes unreachable from output nodes
+    int unreachable = MarkReachableNodes();
+    if (unreachable > 0) TraceLogFNode(false, "dead nodes: %i of %i nodes are unreachable from output nodes and have been pruned", unreachable, nodesCount);
+
+    // Collect per instance properties of all permutations before static specialization
+    CollectInstanceNodes();
+
+    // Depth prepass and shadow passes need a matching program when vertex positions are displaced or fragments are alpha tested
+    // Depth only variant is compiled with full detail, so alpha tests are collected without previous compile lower detail approximations
+    for (int i = 0; i < MAX_NODES; i++) approximatedNodes[i] = false;
+    depthVariant = IsDepthVariantNeeded();
+
+    // Uniform blocks are not supported by GLSL 100 shader version
+    if (uniformBlocks && (version == GLSL_100))
+    {
+        TraceLogFNode(false, "uniform blocks are not supported by GLSL 100 shader version, shader compiled with uniforms");
+        uniformBlocks = false;
+    }
+
+    // Dropped textures are packed before compiling so samplers read their atlas rectangle or texture array layer
+    PackTextures();
+
+    // Open shader data file
+    FILE *dataFile = fopen(DATA_PATH, "w");
+    if (dataFile != NULL)
+    {
+        WriteGraphData(dataFile);
+        fclose(dataFile);
+    }
+    else TraceLogFNode(true, "error when trying to open and write in data file");
+
+    SavePackLayout();
+
+    // Compile used permutations missing from permutation cache and current permutation last to keep its compile state
+    int permutation = GetPermutation();
+    unsigned int hash = GetGraphHash();
+    int cached = 0;
+
+    for (int i = 0; i < permutationsCount; i++)
+    {
+        if (i != permutation)
+        {
+            if ((permutationHashes[i] == hash) && (permutationSources[i][0][0] != NULL)) cached++;
+            else CompilePermutation(i, hash);
+        }
+    }
+
+    CompilePermutation(permutation, hash);
+
+    if (staticNodesCount > 0) TraceLogFNode(false, "shader permutations: %i static properties values combinations used (%i reused from permutation cache)", permutationsCount, cached);
+
+    WriteShaderFiles();
+    SavePermutations();
+    WriteReflectionFiles(permutation);
+
+    compileState = 1;
+    compileFrame = framesCounter;
+
+    // Restore merged nodes inputs from their lines and approximated nodes values
+    CalculateValues();
+
+    // Bake lookup tables once their input subgraphs are linked again
+    BakeLutNodes();
+
+    SortFrameNodes();
+    CheckPreviousShader(false);
+}
+
+// Compiles vertex and fragment shaders code of a level of detail or depth only variant
+void CompileShaderVariant(int lod, FILE *vertexFile, FILE *fragmentFile)
+{
+    // Restore merged nodes inputs and approximated nodes values from previous variant
+    CalculateValues();
+    for (int i = 0; i < MAX_NODES; i++) nodeCosts[i] = (ShaderCost){ 0 };
+    vertexCost = (ShaderCost){ 0 };
+    fragmentCost = (ShaderCost){ 0 };
+
+    // Fold constant subgraphs, merge identical nodes, approximate lower detail nodes and hoist per frame and per vertex work out of fragment shader
+    MarkReachableNodes();
+    FoldNodes();
+    SpecializeNodes();
+    MergeNodes();
+    ApproximateNodes((lod == DEPTH_VARIANT) ? 0 : lod);
+    CollectBlockNodes();
+
+    // Depth only variant fragment shader only runs alpha tests, so fragment graph nodes are not hoisted to vertex shader
+    if (lod == DEPTH_VARIANT)
+    {
+        for (int i = 0; i < MAX_NODES; i++) hoistedNodes[i] = false;
+    }
+    else if (nodes[1]->inputsCount > 0)
+    {
+        bool counted[MAX_NODES] = { false };
+        bool countedHoisted[MAX_NODES] = { false };
+        int index = GetNodeIndex(nodes[1]->inputs[0]);
+        int instructions = CountNodeInstructions(nodes[index], counted, false);
+        int hoistedInstructions = CountNodeInstructions(nodes[index], countedHoisted, true);
+
+        TraceLogFNode(false, "LOD%i fragment shader instructions: %i before constant folding and stage hoisting, %i after", lod, instructions, hoistedInstructions);
+    }
+
+    // Compile fragment shader first, its used varyings select vertex shader outputs and attributes
+    FILE *codeFiles[4] = { tmpfile(), tmpfile(), tmpfile(), tmpfile() };
+    char *codes[4] = { NULL };                  // Vertex declarations, vertex main, fragment declarations and fragment main code
+
+    if ((codeFiles[0] == NULL) || (codeFiles[1] == NULL) || (codeFiles[2] == NULL) || (codeFiles[3] == NULL)) TraceLogFNode(true, "error when trying to create shader variant temporary files");
+
+    for (int i = 0; i < MAX_NODES; i++)
+    {
+        declaredNodes[i] = false;
+        declaredConstants[i] = false;
+        inlinedNodes[i] = false;
+        nodePrecisions[i] = PRECISION_AUTO;
+        nodeRanges[i] = 0.0f;
+    }
+
+    for (int i = 0; i < MAX_TEXTURES; i++)
+    {
+        usedUnits[i] = false;
+        fetchedUnits[i] = false;
+    }
+
+    for (int i = 0; i < MAX_FUNCTIONS; i++) writtenFunctions[i] = false;
+
+    // Stages nodes are marked before compiling fragment shader to declare uniforms used by both stages with the same precision
+    for (int i = 0; i < MAX_NODES; i++)
+    {
+        vertexStageNodes[i] = false;
+        fragmentStageNodes[i] = false;
+    }
+
+    if (nodes[0]->inputsCount > 0) MarkStageNodes(nodes[GetNodeIndex(nodes[0]->inputs[0])], vertexStageNodes);
+    if (nodes[1]->inputsCount > 0) MarkStageNodes(nodes[GetNodeIndex(nodes[1]->inputs[0])], fragmentStageNodes);
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (hoistedNodes[nodes[i]->id] && (nodeStages[nodes[i]->id] == STAGE_VERTEX)) MarkStageNodes(nodes[i], vertexStageNodes);
+    }
+
+    int index = 0;
+
+    if (lod == DEPTH_VARIANT) CompileAlphaTests(codeFiles[2], codeFiles[3]);
+    else
+    {
+        index = GetNodeIndex(nodes[1]->inputs[0]);
+        CheckConstant(nodes[index], codeFiles[2], true);
+        CompileNode(nodes[index], codeFiles[3], true);
+
+        switch (version)
+        {
+            case GLSL_330:
+            case GLSL_430:
+            case GLSL_300ES:
+            {
+                switch (nodes[index]->output.dataCount)
+                {
+                    case 1: fprintf(codeFiles[3], "\n    finalColor = vec4(node_%02i, node_%02i, node_%02i, 1.0);\n}", nodes[1]->inputs[0], nodes[1]->inputs[0], nodes[1]->inputs[0]); break;
+                    case 2: fprintf(codeFiles[3], "\n    finalColor = vec4(node_%02i.xy, 0.0, 1.0);\n}", nodes[1]->inputs[0]); break;
+                    case 3: fprintf(codeFiles[3], "\n    finalColor = vec4(node_%02i.xyz, 1.0);\n}", nodes[1]->inputs[0]); break;
+                    case 4: fprintf(codeFiles[3], "\n    finalColor = node_%02i;\n}", nodes[1]->inputs[0]); break;
+                    default: break;
+                }
+            } break;
+            case GLSL_100:
+            {
+                switch (nodes[index]->output.dataCount)
+                {
+                    case 1: fprintf(codeFiles[3], "\n    gl_FragColor = vec4(node_%02i, node_%02i, node_%02i, 1.0);\n}", nodes[1]->inputs[0], nodes[1]->inputs[0], nodes[1]->inputs[0]); break;
+                    case 2: fprintf(codeFiles[3], "\n    gl_FragColor = vec4(node_%02i.xy, 0.0, 1.0);\n}", nodes[1]->inputs[0]); break;
+                    case 3: fprintf(codeFiles[3], "\n    gl_FragColor = vec4(node_%02i.xyz, 1.0);\n}", nodes[1]->inputs[0]); break;
+                    case 4: fprintf(codeFiles[3], "\n    gl_FragColor = node_%02i;\n}", nodes[1]->inputs[0]); break;
+                    default: break;
+                }
+            } break;
+            default: break;
+        }
+    }
+
+    // Compile vertex shader with fragment graph nodes hoisted to vertex shader written to their varyings
+    for (int i = 0; i < MAX_NODES; i++)
+    {
+        declaredNodes[i] = false;
+        declaredConstants[i] = false;
+        inlinedNodes[i] = false;
+    }
+
+    for (int i = 0; i < MAX_TEXTURES; i++)
+    {
+        usedUnits[i] = false;
+        fetchedUnits[i] = false;
+    }
+
+    for (int i = 0; i < MAX_FUNCTIONS; i++) writtenFunctions[i] = false;
+
+    codes[2] = ReadShaderSource(codeFiles[2]);
+    codes[3] = ReadShaderSource(codeFiles[3]);
+
+    const char *varyingNames[4] = { "fragPosition", "fragNormal", "fragTexCoord", "fragColor" };
+    const char *attributeNames[4] = { "vertexPosition", "vertexNormal", "vertexTexCoord", "vertexColor" };
+    const char *varyingTypes[4] = { "vec3", "vec3", "vec2", "vec4" };
+    const char *varyingPrecisions[4] = { "HIGHP ", "mediump ", "mediump ", "lowp " };
+    const int attributeLocations[4] = { 0, 2, 1, 3 };
+    bool usedVaryings[4] = { false };
+
+    for (int i = 0; i < 4; i++) usedVaryings[i] = (IsNameUsed(codes[2], varyingNames[i]) || IsNameUsed(codes[3], varyingNames[i]));
+
+    PackVaryings(usedVaryings[2]);
+
+    index = GetNodeIndex(nodes[0]->inputs[0]);
+    CheckConstant(nodes[index], codeFiles[0], false);
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (hoistedNodes[nodes[i]->id] && (nodeStages[nodes[i]->id] == STAGE_VERTEX)) CheckConstant(nodes[i], codeFiles[0], false);
+    }
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (hoistedNodes[nodes[i]->id] && (nodeStages[nodes[i]->id] == STAGE_VERTEX))
+        {
+            char varying[32] = { '\0' };
+            GetVaryingName(nodes[i]->id, varying);
+
+            CompileNode(nodes[i], codeFiles[1], false);
+            fprintf(codeFiles[1], "    %s = node_%02i;\n", varying, nodes[i]->id);
+        }
+    }
+
+    CompileNode(nodes[index], codeFiles[1], false);
+
+    switch (nodes[index]->output.dataCount)
+    {
+        case 1: fprintf(codeFiles[1], "\n    gl_Position = vec4(node_%02i, node_%02i, node_%02i, 1.0);\n}", nodes[0]->inputs[0], nodes[0]->inputs[0], nodes[0]->inputs[0]); break;
+        case 2: fprintf(codeFiles[1], "\n    gl_Position = vec4(node_%02i.xy, 0.0, 1.0);\n}", nodes[0]->inputs[0]); break;
+        case 3: fprintf(codeFiles[1], "\n    gl_Position = vec4(node_%02i.xyz, 1.0);\n}", nodes[0]->inputs[0]); break;
+        case 4: fprintf(codeFiles[1], "\n    gl_Position = node_%02i;\n}", nodes[0]->inputs[0]); break;
+        case 16: fprintf(codeFiles[1], "\n    gl_Position = node_%02i;\n}", nodes[0]->inputs[0]); break;
+        default: break;
+    }
+
+    codes[0] = ReadShaderSource(codeFiles[0]);
+    codes[1] = ReadShaderSource(codeFiles[1]);
+
+    for (int i = 0; i < 4; i++) fclose(codeFiles[i]);
+
+    // Write vertex shader code declaring only attributes, varyings and uniforms used by both shaders
+    for (int i = 0; i < 4; i++)
+    {
+        int location = attributeLocations[i];
+
+        if (usedVaryings[i] || IsNameUsed(codes[0], attributeNames[i]) || IsNameUsed(codes[1], attributeNames[i]))
+        {
+            // Explicit attributes locations match raylib default vertex attributes locations
+            if (HasExplicitLocations()) fprintf(vertexFile, "layout(location = %i) ", location);
+            fprintf(vertexFile, ((version != GLSL_100) ? "in %s %s;\n" : "attribute %s %s;\n"), varyingTypes[i], attributeNames[i]);
+        }
+    }
+
+    fprintf(vertexFile, "\n");
+
+    // Per instance attributes use locations after raylib default vertex attributes
+    if (instancing)
+    {
+        fprintf(vertexFile, "layout(location = %i) in mat4 instanceTransform;\n", INSTANCE_LOCATION);
+        fprintf(vertexFile, "layout(location = %i) in vec4 instanceColor;\n", INSTANCE_LOCATION + 4);
+
+        for (int i = 0; i < instanceNodesCount; i++)
+        {
+            FNode node = nodes[GetNodeIndex(instanceNodes[i])];
+            fprintf(vertexFile, "layout(location = %i) in %s instanceNode_%02i;\n", INSTANCE_LOCATION + 5 + i, GetDataTypeName(node->output.dataCount), node->id);
+        }
+
+        fprintf(vertexFile, "\n");
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (usedVaryings[i] && ((i != 2) || (varyingPacks[TEXCOORD_VARYING] == -1))) fprintf(vertexFile, ((version != GLSL_100) ? "out %s %s;\n" : "varying %s %s;\n"), varyingTypes[i], varyingNames[i]);
+    }
+
+    for (int i = 0; i < instanceNodesCount; i++)
+    {
+        FNode node = nodes[GetNodeIndex(instanceNodes[i])];
+        fprintf(vertexFile, "flat out %s node_%02i;\n", GetDataTypeName(node->output.dataCount), node->id);
+    }
+
+    // Fragment graph nodes hoisted to vertex shader output attributes (scalar and vec2 nodes can share packed vec4 attributes)
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (hoistedNodes[nodes[i]->id] && (nodeStages[nodes[i]->id] == STAGE_VERTEX) && (varyingPacks[nodes[i]->id] == -1))
+        {
+            fprintf(vertexFile, ((version != GLSL_100) ? "out %s fragNode_%02i;\n" : "varying %s fragNode_%02i;\n"), GetDataTypeName(nodes[i]->output.dataCount), nodes[i]->id);
+        }
+    }
+
+    for (int i = 0; i < packsCount; i++) fprintf(vertexFile, ((version != GLSL_100) ? "out vec4 fragPack%i;\n" : "varying vec4 fragPack%i;\n"), i);
+
+    fprintf(vertexFile, "\n");
+
+    if (IsNameUsed(codes[0], "mvp") || IsNameUsed(codes[1], "mvp"))
+    {
+        WriteUniformLayout(vertexFile, FRAME_UNIFORM_LOCATION, false);
+        fprintf(vertexFile, "uniform mat4 mvp;\n");
+    }
+
+    // Per frame uniform block is a shared layout, so it is declared whole when any of its members is used
+    if (uniformBlocks)
+    {
+        fprintf(vertexFile, "\n");
+        WriteUniformBlocks(vertexFile);
+    }
+    else
+    {
+        if (IsNameUsed(codes[0], "vertCurrentTime") || IsNameUsed(codes[1], "vertCurrentTime"))
+        {
+            WriteUniformLayout(vertexFile, FRAME_UNIFORM_LOCATION + 3, false);
+            fprintf(vertexFile, "uniform float vertCurrentTime;\n");
+        }
+
+        fprintf(vertexFile, "\n");
+    }
+
+    fprintf(vertexFile, "// Constant and uniform values\n%s", codes[0]);
+    fprintf(vertexFile, "\nvoid main()\n{\n");
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (usedVaryings[i])
+        {
+            char varying[32] = { '\0' };
+
+            if (i == 2) GetVaryingName(TEXCOORD_VARYING, varying);
+            else strcpy(varying, varyingNames[i]);
+
+            // Per instance color tint is applied to vertex color
+            if ((i == 3) && instancing) fprintf(vertexFile, "    %s = %s*instanceColor;\n", varying, attributeNames[i]);
+            else fprintf(vertexFile, "    %s = %s;\n", varying, attributeNames[i]);
+        }
+    }
+
+    // Per instance properties are sent to fragment shader without interpolation
+    for (int i = 0; i < instanceNodesCount; i++) fprintf(vertexFile, "    node_%02i = instanceNode_%02i;\n", instanceNodes[i], instanceNodes[i]);
+
+    fprintf(vertexFile, "\n%s", codes[1]);
+
+    // Write fragment shader code declaring only used varyings and uniforms
+    fprintf(fragmentFile, "// Input attributes\n");
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (usedVaryings[i] && ((i != 2) || (varyingPacks[TEXCOORD_VARYING] == -1)))
+        {
+            const char *precision = ((((version == GLSL_100) || (version == GLSL_300ES)) && (precisionMode == PRECISION_AUTO)) ? varyingPrecisions[i] : "");
+            fprintf(fragmentFile, ((version != GLSL_100) ? "in %s%s %s;\n" : "varying %s%s %s;\n"), precision, varyingTypes[i], varyingNames[i]);
+        }
+    }
+
+    for (int i = 0; (i < instanceNodesCount) && (version != GLSL_100); i++)
+    {
+        FNode node = nodes[GetNodeIndex(instanceNodes[i])];
+        fprintf(fragmentFile, "flat in %s node_%02i;\n", GetDataTypeName(node->output.dataCount), node->id);
+    }
+
+    // Fragment graph nodes hoisted to vertex shader input attributes
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (hoistedNodes[nodes[i]->id] && (nodeStages[nodes[i]->id] == STAGE_VERTEX) && (varyingPacks[nodes[i]->id] == -1))
+        {
+            fprintf(fragmentFile, ((version != GLSL_100) ? "in %s%s fragNode_%02i;\n" : "varying %s%s fragNode_%02i;\n"), GetPrecisionQualifier(nodes[i], true), GetDataTypeName(nodes[i]->output.dataCount), nodes[i]->id);
+        }
+    }
+
+    for (int i = 0; i < packsCount; i++) fprintf(fragmentFile, ((version != GLSL_100) ? "in %svec4 fragPack%i;\n" : "varying %svec4 fragPack%i;\n"), GetPackPrecision(i), i);
+
+    fprintf(fragmentFile, "\n");
+
+    fprintf(fragmentFile, "// Uniform attributes\n");
+
+    if (uniformBlocks) WriteUniformBlocks(fragmentFile);
+    else
+    {
+        const char *uniformNames[3] = { "viewDirection", "modelMatrix", "fragCurrentTime" };
+        const char *uniformTypes[3] = { "vec3", "mat4", "float" };
+        const int uniformLocations[3] = { FRAME_UNIFORM_LOCATION + 2, FRAME_UNIFORM_LOCATION + 1, FRAME_UNIFORM_LOCATION + 4 };
+
+        for (int i = 0; i < 3; i++)
+        {
+            if (IsNameUsed(codes[2], uniformNames[i]) || IsNameUsed(codes[3], uniformNames[i]))
+            {
+                WriteUniformLayout(fragmentFile, uniformLocations[i], false);
+                fprintf(fragmentFile, "uniform %s %s;\n", uniformTypes[i], uniformNames[i]);
+            }
+        }
+
+        fprintf(fragmentFile, "\n");
+    }
+
+    // Depth only variant fragment shader doesn't write color
+    if ((version != GLSL_100) && (lod != DEPTH_VARIANT))
+    {
+        fprintf(fragmentFile, "// Output attributes\n");
+        if (HasExplicitLocations()) fprintf(fragmentFile, "layout(location = 0) ");
+        fprintf(fragmentFile, "out vec4 finalColor;\n\n");
+    }
+
+    fprintf(fragmentFile, "// Constant and uniform values\n%s", codes[2]);
+    fprintf(fragmentFile, "\nvoid main()\n{\n");
+
+    // Packed varyings are unpacked to their usual names so compiled nodes code reads them unchanged
+    bool unpacked = false;
+
+    if (usedVaryings[2] && (varyingPacks[TEXCOORD_VARYING] != -1))
+    {
+        char varying[32] = { '\0' };
+        GetVaryingName(TEXCOORD_VARYING, varying);
+
+        const char *precision = ((((version == GLSL_100) || (version == GLSL_300ES)) && (precisionMode == PRECISION_AUTO)) ? varyingPrecisions[2] : "");
+        fprintf(fragmentFile, "    %svec2 fragTexCoord = %s;\n", precision, varying);
+        unpacked = true;
+    }
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (hoistedNodes[nodes[i]->id] && (nodeStages[nodes[i]->id] == STAGE_VERTEX) && (varyingPacks[nodes[i]->id] != -1))
+        {
+            char varying[32] = { '\0' };
+            GetVaryingName(nodes[i]->id, varying);
+
+            fprintf(fragmentFile, "    %s%s fragNode_%02i = %s;\n", GetPrecisionQualifier(nodes[i], true), GetDataTypeName(nodes[i]->output.dataCount), nodes[i]->id, varying);
+            unpacked = true;
+        }
+    }
+
+    if (unpacked) fprintf(fragmentFile, "\n");
+    fprintf(fragmentFile, "%s", codes[3]);
+
+    for (int i = 0; i < 4; i++) FNODE_FREE(codes[i]);
+    char variant[16] = { '\0' };
+    if (lod == DEPTH_VARIANT) strcpy(variant, "depth only");
+    else sprintf(variant, "LOD%i", lod);
+
+    TraceLogFNode(false, "%s vertex shader cost: %i (%i alu, %i transcendental, %i texture, %i discard)", variant, GetCostTotal(vertexCost), vertexCost.alu, vertexCost.transcendental, vertexCost.texture, vertexCost.discard);
+    TraceLogFNode(false, "%s fragment shader cost: %i (%i alu, %i transcendental, %i texture, %i discard)", variant, GetCostTotal(fragmentCost), fragmentCost.alu, fragmentCost.transcendental, fragmentCost.texture, fragmentCost.discard);
+
+    // Vertex texture fetches need vertex shader texture image units, OpenGL ES 2.0 devices may have none (checked once with full detail variant)
+    int vertexUnits = 0;
+    for (int i = 0; i < MAX_TEXTURES; i++)
+    {
+        if (usedUnits[i]) vertexUnits++;
+    }
+
+    if ((vertexUnits > 0) && (lod == 0))
+    {
+        int maxUnits = 0;
+        glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &maxUnits);
+
+        if (vertexUnits > maxUnits) TraceLogFNode(false, "%s vertex shader samples %i texture unit(s) but current device only supports %i vertex texture units", variant, vertexUnits, maxUnits);
+        else if (version == GLSL_100) TraceLogFNode(false, "%s vertex shader samples %i texture unit(s), GLSL 100 devices need GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS of at least %i (it can be 0 on OpenGL ES 2.0)", variant, vertexUnits, vertexUnits);
+    }
+}
+
+// Check if graph needs a depth only variant (vertex displacement or alpha tested fragments)
+bool IsDepthVariantNeeded()
+{
+    bool needed = false;
+
+    if (nodes[0]->inputsCount > 0) needed = IsVertexDisplaced(nodes[GetNodeIndex(nodes[0]->inputs[0])]);
+
+    if (!needed && (nodes[1]->inputsCount > 0))
+    {
+        int samplers[MAX_TEXTURES];
+        bool visited[MAX_NODES] = { false };
+
+        for (int i = 0; i < MAX_TEXTURES; i++) samplers[i] = -1;
+        CollectAlphaTests(nodes[GetNodeIndex(nodes[1]->inputs[0])], samplers, visited);
+
+        for (int i = 0; i < MAX_TEXTURES; i++)
+        {
+            if (samplers[i] != -1) needed = true;
+        }
+    }
+
+    return needed;
+}
+
+// Check if a vertex graph node computes more than model view projection transform of vertex position
+bool IsVertexDisplaced(FNode node)
+{
+    bool displaced = true;
+
+    // Only MVP*vec4(vertexPosition, 1.0) keeps default vertex positions, any other matrix, vector or operation can move them
+    if (((node->type == FNODE_MULTIPLY) || (node->type == FNODE_MULTIPLYMATRIX)) && (node->inputsCount == 2))
+    {
+        FNode matrix = nodes[GetNodeIndex(node->inputs[0])];
+        FNode vector = nodes[GetNodeIndex(node->inputs[1])];
+
+        if ((matrix->type == FNODE_MVP) && (vector->type == FNODE_APPEND) && (vector->inputsCount == 2))
+        {
+            FNode position = nodes[GetNodeIndex(vector->inputs[0])];
+            FNode w = nodes[GetNodeIndex(vector->inputs[1])];
+
+            // Authoring mode declares values which are not properties as uniforms only to edit them in the editor
+            bool one = (IsConstantEqual(w, 1.0f) || ((w->type == FNODE_VALUE) && !w->property && (w->output.data[0].value == 1.0f)));
+
+            displaced = !((position->type == FNODE_VERTEXPOSITION) && (w->output.dataCount == 1) && one);
+        }
+    }
+
+    return displaced;
+}
+
+// Collects fragment graph sampler node ids which discard transparent fragments by texture unit
+void CollectAlphaTests(FNode node, int *samplers, bool *visited)
+{
+    if (!visited[node->id])
+    {
+        visited[node->id] = true;
+
+        if ((node->type == FNODE_SAMPLER2D) && (GetNodeCost(node).discard > 0))
+        {
+            int unit = (int)nodes[GetNodeIndex(node->inputs[0])]->output.data[0].value;
+            if (samplers[unit] == -1) samplers[unit] = node->id;
+        }
+
+        // Nodes approximated by their average values don't evaluate their inputs
+        if (!approximatedNodes[node->id])
+        {
+            for (int i = 0; i < node->inputsCount; i++) CollectAlphaTests(nodes[GetNodeIndex(node->inputs[i])], samplers, visited);
+        }
+    }
+}
+
+// Compiles depth only variant fragment shader alpha tests declarations and main function body
+void CompileAlphaTests(FILE *declarationsFile, FILE *mainFile)
+{
+    int samplers[MAX_TEXTURES];
+    bool visited[MAX_NODES] = { false };
+
+    for (int i = 0; i < MAX_TEXTURES; i++) samplers[i] = -1;
+    if (nodes[1]->inputsCount > 0) CollectAlphaTests(nodes[GetNodeIndex(nodes[1]->inputs[0])], samplers, visited);
+
+    for (int i = 0; i < MAX_TEXTURES; i++)
+    {
+        if (samplers[i] != -1)
+        {
+            FNode node = nodes[GetNodeIndex(samplers[i])];
+
+            DeclareSampler(declarationsFile, i);
+
+            AddNodeCost(node, GetNodeCost(node), true);
+            CompileTextureFetch(node, i, mainFile, true);
+            fprintf(mainFile, "    if (texel%i.a == 0.0) discard;\n", i);
+        }
+    }
+
+    fprintf(mainFile, "}");
+}
+
+// Writes shader credits, version, default precision, high precision qualifier and texture level of detail extension header
+void WriteShaderHeader(FILE *file, bool fragment, bool textureLod, bool highp)
+{
+    const char credits[] = "// Shader created with FNode 1.0 - Credits: Victor Fisac\n\n";
+    fprintf(file, credits);
+
+    // Shader definition to embed, no external file required
+    switch (version)
+    {
+        case GLSL_330:
+        case GLSL_430: fprintf(file, "#version %i\n\n", GetVersionNumber()); break;
+        case GLSL_100:
+        case GLSL_300ES:
+        {
+            const char *header = ((version == GLSL_300ES) ? "#version 300 es\n" : "#version 100\n");
+
+            if (fragment)
+            {
+                fprintf(file, header);
+
+                // Explicit level of detail and gradients fetches fall back to implicit level of detail without extension support
+                if (textureLod)
+                {
+                    const char fTextureLod[] = "\n#ifdef GL_EXT_shader_texture_lod\n"
+                    "#extension GL_EXT_shader_texture_lod : enable\n"
+                    "#define TEXTURE_LOD(sampler, coord, lod) texture2DLodEXT(sampler, coord, lod)\n"
+                    "#define TEXTURE_GRAD(sampler, coord, dx, dy) texture2DGradEXT(sampler, coord, dx, dy)\n"
+                    "#else\n"
+                    "#define TEXTURE_LOD(sampler, coord, lod) texture2D(sampler, coord)\n"
+                    "#define TEXTURE_GRAD(sampler, coord, dx, dy) texture2D(sampler, coord)\n"
+                    "#endif\n\n";
+                    fprintf(file, fTextureLod);
+                }
+
+                switch (precisionMode)
+                {
+                    case PRECISION_AUTO:
+                    {
+                        // Default precision for declarations without qualifier, highp is optional in fragment shaders
+                        const char fPrecision[] = "precision mediump float;\n\n"
+                        "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+                        "#define HIGHP highp\n"
+                        "#else\n"
+                        "#define HIGHP mediump\n"
+                        "#endif\n\n";
+                        fprintf(file, fPrecision);
+                    } break;
+                    case PRECISION_LOWP: fprintf(file, "precision lowp float;\n\n"); break;
+                    case PRECISION_MEDIUMP: fprintf(file, "precision mediump float;\n\n"); break;
+                    case PRECISION_HIGHP: fprintf(file, "precision highp float;\n\n"); break;
+                    default: break;
+                }
+            }
+            else
+            {
+                fprintf(file, "%s\n", header);
+
+                // Uniforms shared with fragment shader are declared highp only if fragment shaders support it (macro is defined in both stages)
+                if (highp)
+                {
+                    const char vPrecision[] = "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+                    "#define HIGHP highp\n"
+                    "#else\n"
+                    "#define HIGHP mediump\n"
+                    "#endif\n\n";
+                    fprintf(file, vPrecision);
+                }
+            }
+        } break;
+        default: break;
+    }
+}
+
+// Returns GLSL version number of current shader version setting
+int GetVersionNumber()
+{
+    int number = 330;
+
+    switch (version)
+    {
+        case GLSL_100: number = 100; break;
+        case GLSL_430: number = 430; break;
+        case GLSL_300ES: number = 300; break;
+        default: break;
+    }
+
+    return number;
+}
+
+// Returns true if current shader version declares attributes and outputs locations
+bool HasExplicitLocations()
+{
+    return ((version == GLSL_430) || (version == GLSL_300ES));
+}
+
+// Writes a uniform explicit location or sampler binding layout qualifier (GLSL 430)
+void WriteUniformLayout(FILE *file, int location, bool sampler)
+{
+    // GLSL ES 300 uniforms locations and bindings are still assigned when linking
+    if (version == GLSL_430) fprintf(file, (sampler ? "layout(binding = %i) " : "layout(location = %i) "), location);
+}
+
+// Check if a GLSL identifier is used in shader code (not only as part of a longer identifier)
+bool IsNameUsed(const char *code, const char *name)
+{
+    bool used = false;
+    int length = (int)strlen(name);
+
+    for (const char *found = strstr(code, name); (found != NULL) && !used; found = strstr(found + 1, name))
+    {
+        char previous = ((found > code) ? found[-1] : ' ');
+        char next = found[length];
+
+        used = !(isalnum(previous) || (previous == '_') || isalnum(next) || (next == '_'));
+    }
+
+    return used;
+}
+
+// Assigns packed vec4 varyings components to used scalar and vec2 varyings (texture coordinates and fragment graph nodes hoisted to vertex shader)
+void PackVaryings(bool texCoord)
+{
+    int varyings[MAX_HOISTED_VARYINGS + 1] = { 0 };
+    int sizes[MAX_HOISTED_VARYINGS + 1] = { 0 };
+    int freeComponents[MAX_HOISTED_VARYINGS + 1] = { 0 };
+    int members[MAX_HOISTED_VARYINGS + 1] = { 0 };
+    int packIndices[MAX_HOISTED_VARYINGS + 1] = { 0 };
+    int varyingsCount = 0;
+    int count = 0;
+
+    for (int i = 0; i <= MAX_NODES; i++)
+    {
+        varyingPacks[i] = -1;
+        varyingOffsets[i] = 0;
+    }
+
+    // Vector2 varyings are placed first so scalar varyings fill remaining components
+    for (int size = 2; size >= 1; size--)
+    {
+        if (texCoord && (size == 2))
+        {
+            varyings[varyingsCount] = TEXCOORD_VARYING;
+            sizes[varyingsCount++] = size;
+        }
+
+        for (int i = 0; (i < nodesCount) && (varyingsCount <= MAX_HOISTED_VARYINGS); i++)
+        {
+            if (hoistedNodes[nodes[i]->id] && (nodeStages[nodes[i]->id] == STAGE_VERTEX) && (nodes[i]->output.dataCount == size))
+            {
+                varyings[varyingsCount] = nodes[i]->id;
+                sizes[varyingsCount++] = size;
+            }
+        }
+    }
+
+    for (int i = 0; i < varyingsCount; i++)
+    {
+        int pack = -1;
+        for (int k = count - 1; k >= 0; k--)
+        {
+            if (freeComponents[k] >= sizes[i]) pack = k;
+        }
+
+        if (pack == -1)
+        {
+            pack = count++;
+            freeComponents[pack] = 4;
+        }
+
+        varyingPacks[varyings[i]] = pack;
+        varyingOffsets[varyings[i]] = 4 - freeComponents[pack];
+        freeComponents[pack] -= sizes[i];
+        members[pack]++;
+    }
+
+    // Varyings alone in their packed varying are kept unpacked
+    packsCount = 0;
+    for (int i = 0; i < count; i++) packIndices[i] = ((members[i] > 1) ? packsCount++ : -1);
+    for (int i = 0; i < varyingsCount; i++) varyingPacks[varyings[i]] = packIndices[varyingPacks[varyings[i]]];
+}
+
+// Returns a fragment graph hoisted node (or texture coordinates) varying name or packed varying components expression
+void GetVaryingName(int varying, char *name)
+{
+    const char *components = "xyzw";
+
+    if (varyingPacks[varying] == -1)
+    {
+        if (varying == TEXCOORD_VARYING) strcpy(name, "fragTexCoord");
+        else sprintf(name, "fragNode_%02i", varying);
+    }
+    else if ((varying == TEXCOORD_VARYING) || (nodes[GetNodeIndex(varying)]->output.dataCount == 2)) sprintf(name, "fragPack%i.%.2s", varyingPacks[varying], components + varyingOffsets[varying]);
+    else sprintf(name, "fragPack%i.%c", varyingPacks[varying], components[varyingOffsets[varying]]);
+}
+
+// Returns GLSL 100 and GLSL ES 300 precision qualifier of a packed varying (highest precision of its members)
+const char *GetPackPrecision(int pack)
+{
+    const char *qualifier = "";
+
+    if (((version == GLSL_100) || (version == GLSL_300ES)) && (precisionMode == PRECISION_AUTO))
+    {
+        Precision precision = ((varyingPacks[TEXCOORD_VARYING] == pack) ? PRECISION_MEDIUMP : PRECISION_LOWP);
+
+        for (int i = 0; i < nodesCount; i++)
+        {
+            if ((varyingPacks[nodes[i]->id] == pack) && (GetNodePrecision(nodes[i]) > precision)) precision = GetNodePrecision(nodes[i]);
+        }
+
+        switch (precision)
+        {
+            case PRECISION_LOWP: qualifier = "lowp "; break;
+            case PRECISION_MEDIUMP: qualifier = "mediump "; break;
+            case PRECISION_HIGHP: qualifier = "HIGHP "; break;
+            default: break;
+        }
+    }
+
+    return qualifier;
+}
+
+// Writes levels of detail and depth only shader files selecting used permutations cached code with preprocessor conditions
+void WriteShaderFiles()
+{
+    for (int lod = 0; lod < (depthVariant ? MAX_VARIANTS : MAX_LODS); lod++)
+    {
+        char paths[2][64] = { { '\0' }, { '\0' } };
+        GetLodPaths(lod, paths[0], paths[1]);
+
+        for (int k = 0; k < 2; k++)
+        {
+            FILE *file = fopen(paths[k], "w");
+            if (file != NULL)
+            {
+                // GLSL 100 fragment shaders enable texture level of detail extension only when any permutation uses it
+                bool textureLod = false;
+                for (int p = 0; (p < permutationsCount) && (version == GLSL_100) && (k == 1); p++)
+                {
+                    textureLod = (textureLod || IsNameUsed(permutationSources[p][lod][k], "TEXTURE_LOD") || IsNameUsed(permutationSources[p][lod][k], "TEXTURE_GRAD"));
+                }
+
+                // Vertex shaders define high precision qualifier only when any permutation declares a uniform shared with fragment shader using it
+                bool highp = false;
+                for (int p = 0; (p < permutationsCount) && (k == 0); p++) highp = (highp || IsNameUsed(permutationSources[p][lod][k], "HIGHP"));
+
+                WriteShaderHeader(file, (k == 1), textureLod, highp);
+
+                if (staticNodesCount > 0)
+                {
+                    // Static properties default to current permutation values, engines select other permutations defining them before compiling
+                    fprintf(file, "// Static properties\n");
+                    for (int i = 0; i < staticNodesCount; i++)
+                    {
+                        int value = (int)nodes[GetNodeIndex(staticNodes[i])]->output.data[0].value;
+                        fprintf(file, "#ifndef STATIC_NODE_%02i\n#define STATIC_NODE_%02i %i\n#endif\n", staticNodes[i], staticNodes[i], value);
+                    }
+
+                    for (int p = 0; p < permutationsCount; p++)
+                    {
+                        fprintf(file, ((p == 0) ? "\n#if " : "\n#elif "));
+                        for (int i = 0; i < staticNodesCount; i++) fprintf(file, "%s(STATIC_NODE_%02i == %i)", ((i > 0) ? " && " : ""), staticNodes[i], permutationValues[p][i]);
+                        fprintf(file, "\n\n%s\n", permutationSources[p][lod][k]);
+                    }
+
+                    fprintf(file, "\n#else\n#error static properties values combination is not compiled in shader permutations\n#endif\n");
+                }
+                else fprintf(file, "%s", permutationSources[0][lod][k]);
+
+                fclose(file);
+            }
+            else TraceLogFNode(true, "error when trying to open and write in shader file %s", paths[k]);
+        }
+    }
+}
+
+// Collects static property nodes and returns their current values permutation index adding it to used permutations
+int GetPermutation()
+{
+    int ids[MAX_STATIC_NODES] = { 0 };
+    int values[MAX_STATIC_NODES] = { 0 };
+    int count = 0;
+    int permutation = -1;
+
+    // Static property nodes are sorted by id and their values are rounded to be compared by preprocessor conditions
+    for (int i = 0; i < MAX_NODES; i++)
+    {
+        for (int k = 0; k < nodesCount; k++)
+        {
+            if ((nodes[k]->id == i) && nodes[k]->staticProperty && reachableNodes[i])
+            {
+                nodes[k]->output.data[0].value = roundf(nodes[k]->output.data[0].value);
+                FFloatToString(nodes[k]->output.data[0].valueText, nodes[k]->output.data[0].value);
+
+                if (count < MAX_STATIC_NODES)
+                {
+                    ids[count] = i;
+                    values[count] = (int)nodes[k]->output.data[0].value;
+                    count++;
+                }
+                else TraceLogFNode(false, "static property node %i exceeds max static properties and is compiled with its current value", i);
+
+                break;
+            }
+        }
+    }
+
+    // Used permutations are reloaded when static property nodes change
+    bool changed = (count != staticNodesCount);
+    for (int i = 0; (i < count) && !changed; i++) changed = (ids[i] != staticNodes[i]);
+
+    if (changed)
+    {
+        for (int i = 0; i < permutationsCount; i++) ClearPermutation(i);
+        permutationsCount = 0;
+
+        staticNodesCount = count;
+        for (int i = 0; i < count; i++) staticNodes[i] = ids[i];
+
+        LoadPermutations();
+    }
+
+    for (int i = 0; (i < permutationsCount) && (permutation == -1); i++)
+    {
+        bool equal = true;
+        for (int k = 0; (k < staticNodesCount) && equal; k++) equal = (permutationValues[i][k] == values[k]);
+
+        if (equal) permutation = i;
+    }
+
+    if (permutation == -1)
+    {
+        // Oldest used permutation is discarded when permutation cache is full
+        if (permutationsCount == MAX_PERMUTATIONS)
+        {
+            ClearPermutation(0);
+
+            for (int i = 1; i < permutationsCount; i++)
+            {
+                permutationHashes[i - 1] = permutationHashes[i];
+                for (int k = 0; k < staticNodesCount; k++) permutationValues[i - 1][k] = permutationValues[i][k];
+
+                for (int k = 0; k < MAX_VARIANTS; k++)
+                {
+                    permutationSources[i - 1][k][0] = permutationSources[i][k][0];
+                    permutationSources[i - 1][k][1] = permutationSources[i][k][1];
+                }
+            }
+
+            permutationsCount--;
+            for (int k = 0; k < MAX_VARIANTS; k++)
+            {
+                permutationSources[permutationsCount][k][0] = NULL;
+                permutationSources[permutationsCount][k][1] = NULL;
+            }
+        }
+
+        permutation = permutationsCount;
+        permutationHashes[permutation] = 0;
+        for (int k = 0; k < staticNodesCount; k++) permutationValues[permutation][k] = values[k];
+        permutationsCount++;
+    }
+
+    return permutation;
+}
+
+// Compiles all levels of detail code of a permutation into permutation cache
+void CompilePermutation(int permutation, unsigned int hash)
+{
+    for (int i = 0; i < staticNodesCount; i++) nodes[GetNodeIndex(staticNodes[i])]->output.data[0].value = (float)permutationValues[permutation][i];
+
+    // Restore merged nodes inputs from previous permutation and estimate nodes average values to approximate them in lower level of detail variants
+    CalculateValues();
+    MarkReachableNodes();
+    CalculateAverageValues();
+
+    ClearPermutation(permutation);
+
+    // Compile depth only and level of detail variants with visor variant last to keep its compile state
+    for (int i = (depthVariant ? 0 : 1); i <= MAX_LODS; i++)
+    {
+        int lod = ((i == 0) ? DEPTH_VARIANT : (previewLod + i)%MAX_LODS);
+        FILE *vertexFile = tmpfile();
+        FILE *fragmentFile = tmpfile();
+
+        if ((vertexFile != NULL) && (fragmentFile != NULL))
+        {
+            CompileShaderVariant(lod, vertexFile, fragmentFile);
+            permutationSources[permutation][lod][0] = ReadShaderSource(vertexFile);
+            permutationSources[permutation][lod][1] = ReadShaderSource(fragmentFile);
+        }
+        else TraceLogFNode(true, "error when trying to create shader permutation temporary files");
+
+        fclose(vertexFile);
+        fclose(fragmentFile);
+    }
+
+    permutationHashes[permutation] = hash;
+}
+
+// Loads used permutations from permutations file if they match current static property nodes
+void LoadPermutations()
+{
+    FILE *file = fopen(PERMUTATIONS_PATH, "r");
+    if (file != NULL)
+    {
+        int count = 0;
+        bool matching = ((staticNodesCount > 0) && (fscanf(file, "%i", &count) == 1) && (count == staticNodesCount));
+
+        for (int i = 0; (i < count) && matching; i++)
+        {
+            int id = -1;
+            matching = ((fscanf(file, "%i", &id) == 1) && (id == staticNodes[i]));
+        }
+
+        while (matching && (permutationsCount < MAX_PERMUTATIONS))
+        {
+            for (int i = 0; (i < staticNodesCount) && matching; i++) matching = (fscanf(file, "%i", &permutationValues[permutationsCount][i]) == 1);
+
+            if (matching)
+            {
+                permutationHashes[permutationsCount] = 0;
+                permutationsCount++;
+            }
+        }
+
+        fclose(file);
+    }
+}
+
+// Saves used permutations static property values in permutations file
+void SavePermutations()
+{
+    remove(PERMUTATIONS_PATH);
+
+    if (staticNodesCount > 0)
+    {
+        FILE *file = fopen(PERMUTATIONS_PATH, "w");
+        if (file != NULL)
+        {
+            fprintf(file, "%i", staticNodesCount);
+            for (int i = 0; i < staticNodesCount; i++) fprintf(file, " %i", staticNodes[i]);
+            fprintf(file, "\n");
+
+            for (int i = 0; i < permutationsCount; i++)
+            {
+                for (int k = 0; k < staticNodesCount; k++) fprintf(file, ((k == 0) ? "%i" : " %i"), permutationValues[i][k]);
+                fprintf(file, "\n");
+            }
+
+            fclose(file);
+        }
+        else TraceLogFNode(false, "error when trying to open and write in permutations file");
+    }
+}
+
+// Writes reflection metadata and C header of current permutation levels of detail shaders
+void WriteReflectionFiles(int permutation)
+{
+    for (int lod = 0; lod < MAX_VARIANTS; lod++)
+    {
+        if ((permutationSources[permutation][lod][0] != NULL) && (permutationSources[permutation][lod][1] != NULL))
+        {
+            ShaderVariable variables[MAX_SHADER_VARIABLES] = { 0 };
+            int count = ParseShaderVariables(permutationSources[permutation][lod][0], false, variables, 0);
+            count = ParseShaderVariables(permutationSources[permutation][lod][1], true, variables, count);
+
+            char paths[2][64] = { { '\0' }, { '\0' } };
+            GetReflectionPaths(lod, paths[0], paths[1]);
+
+            FILE *file = fopen(paths[0], "w");
+            if (file != NULL)
+            {
+                WriteReflectionJson(file, lod, variables, count);
+                fclose(file);
+            }
+            else TraceLogFNode(false, "error when trying to open and write in reflection file %s", paths[0]);
+
+            // Shared program headers are written with their own names so engines can include several programs headers
+            if (programHash != 0)
+            {
+                char programPath[64] = { '\0' };
+                sprintf(programPath, PROGRAM_PATH, programHash, paths[1] + strlen("output/shader"));
+                strcpy(paths[1], programPath);
+            }
+
+            file = fopen(paths[1], "w");
+            if (file != NULL)
+            {
+                WriteReflectionHeader(file, lod, variables, count);
+                fclose(file);
+            }
+            else TraceLogFNode(false, "error when trying to open and write in reflection header %s", paths[1]);
+        }
+    }
+}
+
+// Adds shader code declared variables to a variables list and returns its new length
+int ParseShaderVariables(const char *source, bool fragment, ShaderVariable *variables, int count)
+{
+    const char *line = source;
+    char block[16] = { '\0' };
+
+    while ((line != NULL) && (*line != '\0'))
+    {
+        char text[256] = { '\0' };
+        int length = (int)strcspn(line, "\n");
+        strncpy(text, line, ((length < 255) ? length : 255));
+
+        ShaderVariable variable = { 0 };
+        bool declared = false;
+        variable.binding = -1;
+
+        if (block[0] != '\0')
+        {
+            // Uniform block members are written with their std140 offsets
+            if (text[0] == '}') block[0] = '\0';
+            else if ((sscanf(text, " highp %15s %31[^;]; // offset %i", variable.type, variable.name, &variable.binding) == 3) || (sscanf(text, " %15s %31[^;]; // offset %i", variable.type, variable.name, &variable.binding) == 3))
+            {
+                variable.kind = VARIABLE_UNIFORM;
+                strcpy(variable.block, block);
+                declared = true;
+            }
+        }
+        else if ((strncmp(text, "layout(std140", 13) == 0) && (strstr(text, ") uniform ") != NULL)) sscanf(strstr(text, ") uniform ") + 10, "%15s", block);
+        else if ((text[0] != '\0') && (text[0] != ' ') && (text[0] != '#') && (text[0] != '/') && (text[0] != '{') && (text[0] != '}'))
+        {
+            char *declaration = text;
+            int location = -1;
+
+            if ((sscanf(text, "layout(location = %i)", &location) == 1) || (sscanf(text, "layout(binding = %i)", &location) == 1)) declaration = strchr(text, ')') + 1;
+
+            // Declarations end with type and name after storage, interpolation and precision qualifiers
+            char *tokens[8] = { NULL };
+            int tokensCount = 0;
+            char *semicolon = strchr(declaration, ';');
+
+            if (semicolon != NULL)
+            {
+                *semicolon = '\0';
+
+                for (char *token = strtok(declaration, " "); (token != NULL) && (tokensCount < 8); token = strtok(NULL, " "))
+                {
+                    if ((strcmp(token, "lowp") != 0) && (strcmp(token, "mediump") != 0) && (strcmp(token, "highp") != 0) && (strcmp(token, "HIGHP") != 0)) tokens[tokensCount++] = token;
+                }
+            }
+
+            if (tokensCount >= 3)
+            {
+                const char *storage = tokens[tokensCount - 3];
+                strncpy(variable.type, tokens[tokensCount - 2], 15);
+                strncpy(variable.name, tokens[tokensCount - 1], 31);
+                variable.flat = (strcmp(tokens[0], "flat") == 0);
+                declared = true;
+
+                if (strcmp(storage, "uniform") == 0)
+                {
+                    if (strncmp(variable.type, "sampler2D", 9) == 0)
+                    {
+                        variable.kind = VARIABLE_SAMPLER;
+                        sscanf(variable.name, "texture%i", &variable.binding);
+                    }
+                    else
+                    {
+                        variable.kind = VARIABLE_UNIFORM;
+                        variable.binding = location;
+                    }
+                }
+                else if (!fragment && ((strcmp(storage, "in") == 0) || (strcmp(storage, "attribute") == 0)))
+                {
+                    // Default vertex attributes are bound by raylib to fixed locations before linking
+                    const char *defaultAttributes[4] = { "vertexPosition", "vertexTexCoord", "vertexNormal", "vertexColor" };
+
+                    variable.kind = VARIABLE_ATTRIBUTE;
+                    variable.binding = location;
+                    for (int i = 0; i < 4; i++)
+                    {
+                        if (strcmp(variable.name, defaultAttributes[i]) == 0) variable.binding = i;
+                    }
+                }
+                else if ((strcmp(storage, "varying") == 0) || ((strcmp(storage, (fragment ? "in" : "out")) == 0))) variable.kind = VARIABLE_VARYING;
+                else declared = false;
+            }
+        }
+
+        if (declared)
+        {
+            int index = -1;
+            for (int i = 0; i < count; i++)
+            {
+                if ((variables[i].kind == variable.kind) && (strcmp(variables[i].name, variable.name) == 0)) index = i;
+            }
+
+            if ((index == -1) && (count < MAX_SHADER_VARIABLES))
+            {
+                index = count;
+                variables[count++] = variable;
+            }
+
+            if (index != -1)
+            {
+                if (fragment) variables[index].fragment = true;
+                else variables[index].vertex = true;
+            }
+            else TraceLogFNode(false, "shader variable %s exceeds max reflection variables", variable.name);
+        }
+
+        line = strchr(line, '\n');
+        if (line != NULL) line++;
+    }
+
+    return count;
+}
+
+// Returns the node id compiled to a shader variable (-1 if it is not a node variable)
+int GetVariableNode(const char *name)
+{
+    int id = -1;
+    const char *prefixes[3] = { "node_", "fragNode_", "instanceNode_" };
+
+    for (int i = 0; i < 3; i++)
+    {
+        if (strncmp(name, prefixes[i], strlen(prefixes[i])) == 0) sscanf(name + strlen(prefixes[i]), "%d", &id);
+    }
+
+    return id;
+}
+
+// Returns the float components of a GLSL data type name (0 for samplers)
+int GetTypeComponents(const char *type)
+{
+    int components = 0;
+
+    if (strcmp(type, "float") == 0) components = 1;
+    else if (strcmp(type, "vec2") == 0) components = 2;
+    else if (strcmp(type, "vec3") == 0) components = 3;
+    else if (strcmp(type, "vec4") == 0) components = 4;
+    else if (strcmp(type, "mat4") == 0) components = 16;
+
+    return components;
+}
+
+// Converts a shader variable name to an upper case C define name
+void GetUpperName(const char *name, char *output)
+{
+    int length = (int)strlen(name);
+
+    for (int i = 0; i < length; i++) output[i] = (((name[i] >= 'a') && (name[i] <= 'z')) ? (name[i] - 'a' + 'A') : name[i]);
+    output[length] = '\0';
+}
+
+// Writes shader variables reflection metadata in JSON format
+void WriteReflectionJson(FILE *file, int lod, ShaderVariable *variables, int count)
+{
+    const char *sections[4] = { "attributes", "varyings", "uniforms", "samplers" };
+
+    fprintf(file, "{\n    \"version\": %i,\n    \"es\": %s,\n    \"lod\": %i,\n    \"depth\": %s,\n", GetVersionNumber(), (((version == GLSL_100) || (version == GLSL_300ES)) ? "true" : "false"), ((lod == DEPTH_VARIANT) ? 0 : lod), ((lod == DEPTH_VARIANT) ? "true" : "false"));
+
+    // Static properties select compiled permutation when defined before compiling shader code
+    fprintf(file, "    \"staticProperties\": [");
+    for (int i = 0; i < staticNodesCount; i++)
+    {
+        FNode node = nodes[GetNodeIndex(staticNodes[i])];
+        fprintf(file, "%s\n        { \"define\": \"STATIC_NODE_%02i\", \"node\": %i, \"nodeName\": \"%s\", \"value\": %i }", ((i > 0) ? "," : ""), node->id, node->id, node->name, (int)node->output.data[0].value);
+    }
+    fprintf(file, ((staticNodesCount > 0) ? "\n    ],\n" : "],\n"));
+
+    for (int k = VARIABLE_ATTRIBUTE; k <= VARIABLE_SAMPLER; k++)
+    {
+        int written = 0;
+        fprintf(file, "    \"%s\": [", sections[k]);
+
+        for (int i = 0; i < count; i++)
+        {
+            if ((variables[i].kind == k) && (variables[i].block[0] == '\0'))
+            {
+                fprintf(file, "%s\n        { ", ((written > 0) ? "," : ""));
+                // Uniforms and samplers indices follow C header uniforms tables declaration order
+                if (k >= VARIABLE_UNIFORM)
+                {
+                    int index = 0;
+                    for (int j = 0; j < i; j++)
+                    {
+                        if ((variables[j].kind >= VARIABLE_UNIFORM) && (variables[j].block[0] == '\0')) index++;
+                    }
+
+                    fprintf(file, "\"index\": %i, ", index);
+                }
+
+                fprintf(file, "\"name\": \"%s\", \"type\": \"%s\"", variables[i].name, variables[i].type);
+
+                switch (k)
+                {
+                    case VARIABLE_ATTRIBUTE: fprintf(file, ", \"location\": %i", variables[i].binding); break;
+                    case VARIABLE_VARYING: fprintf(file, ", \"flat\": %s", (variables[i].flat ? "true" : "false")); break;
+                    case VARIABLE_UNIFORM: if (variables[i].binding != -1) fprintf(file, ", \"location\": %i", variables[i].binding); break;
+                    case VARIABLE_SAMPLER: fprintf(file, ", \"unit\": %i", variables[i].binding); break;
+                    default: break;
+                }
+
+                if (k != VARIABLE_ATTRIBUTE) fprintf(file, ", \"stages\": [%s%s%s]", (variables[i].vertex ? "\"vertex\"" : ""), ((variables[i].vertex && variables[i].fragment) ? ", " : ""), (variables[i].fragment ? "\"fragment\"" : ""));
+
+                int id = GetVariableNode(variables[i].name);
+                if (id != -1)
+                {
+                    FNode node = nodes[GetNodeIndex(id)];
+                    fprintf(file, ", \"node\": %i, \"nodeName\": \"%s\", \"property\": %s", id, node->name, (node->property ? "true" : "false"));
+                }
+
+                fprintf(file, " }");
+                written++;
+            }
+        }
+
+        fprintf(file, ((written > 0) ? "\n    ],\n" : "],\n"));
+    }
+
+    // Uniform block sizes are calculated from their last member std140 offset
+    const char *blocks[2] = { "FrameData", "MaterialData" };
+    const int bindings[2] = { FRAME_BLOCK_BINDING, MATERIAL_BLOCK_BINDING };
+    int blocksWritten = 0;
+
+    fprintf(file, "    \"blocks\": [");
+    for (int b = 0; b < 2; b++)
+    {
+        int size = 0;
+        int written = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            if (strcmp(variables[i].block, blocks[b]) == 0)
+            {
+                if (written == 0) fprintf(file, "%s\n        { \"name\": \"%s\", \"binding\": %i, \"members\": [", ((blocksWritten > 0) ? "," : ""), blocks[b], bindings[b]);
+                fprintf(file, "%s\n            { \"name\": \"%s\", \"type\": \"%s\", \"offset\": %i", ((written > 0) ? "," : ""), variables[i].name, variables[i].type, variables[i].binding);
+
+                int id = GetVariableNode(variables[i].name);
+                if (id != -1) fprintf(file, ", \"node\": %i, \"nodeName\": \"%s\"", id, nodes[GetNodeIndex(id)]->name);
+                fprintf(file, " }");
+
+                int end = variables[i].binding + GetTypeComponents(variables[i].type)*4;
+                if (end > size) size = end;
+                written++;
+            }
+        }
+
+        if (written > 0)
+        {
+            fprintf(file, "\n        ], \"size\": %i }", (size + 15)/16*16);
+            blocksWritten++;
+        }
+    }
+    fprintf(file, ((blocksWritten > 0) ? "\n    ]\n}\n" : "]\n}\n"));
+}
+
+// Writes shader variables precomputed bindings in a C header
+void WriteReflectionHeader(FILE *file, int lod, ShaderVariable *variables, int count)
+{
+    char prefix[32] = { '\0' };
+    char names[32] = { '\0' };
+    char upper[32] = { '\0' };
+
+    // Shared program headers guard, macros and tables names include program canonical hash
+    if (programHash != 0)
+    {
+        sprintf(prefix, "PROGRAM_%08X", programHash);
+        sprintf(names, "program%08x", programHash);
+    }
+    else
+    {
+        strcpy(prefix, "SHADER");
+        strcpy(names, "shader");
+    }
+
+    if (lod == DEPTH_VARIANT)
+    {
+        strcat(prefix, "_DEPTH");
+        strcat(names, "Depth");
+    }
+    else if (lod > 0)
+    {
+        sprintf(prefix + strlen(prefix), "_LOD%i", lod);
+        sprintf(names + strlen(names), "Lod%i", lod);
+    }
+
+    fprintf(file, "// Shader reflection created with FNode 1.0 - Credits: Victor Fisac\n\n#ifndef %s_REFLECTION_H\n#define %s_REFLECTION_H\n\n", prefix, prefix);
+    fprintf(file, "#define %s_GLSL_VERSION %i\n#define %s_GLSL_ES %i\n\n", prefix, GetVersionNumber(), prefix, ((version == GLSL_100) || (version == GLSL_300ES)));
+
+    fprintf(file, "// Vertex attributes locations (-1 if assigned when linking)\n");
+    for (int i = 0; i < count; i++)
+    {
+        if (variables[i].kind == VARIABLE_ATTRIBUTE)
+        {
+            GetUpperName(variables[i].name, upper);
+            fprintf(file, "#define %s_ATTRIB_%s %i\n", prefix, upper, variables[i].binding);
+        }
+    }
+
+    // Default block uniforms locations are assigned when linking (unless declared with explicit locations), so they are resolved once by index from names table
+    int uniformsCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if ((variables[i].kind >= VARIABLE_UNIFORM) && (variables[i].block[0] == '\0')) uniformsCount++;
+    }
+
+    fprintf(file, "\n// Uniforms indices in uniforms tables\n#define %s_UNIFORMS_COUNT %i\n", prefix, uniformsCount);
+    for (int i = 0, index = 0; i < count; i++)
+    {
+        if ((variables[i].kind >= VARIABLE_UNIFORM) && (variables[i].block[0] == '\0'))
+        {
+            GetUpperName(variables[i].name, upper);
+            fprintf(file, "#define %s_UNIFORM_%s %i\n", prefix, upper, index++);
+        }
+    }
+
+    if (uniformsCount > 0)
+    {
+        fprintf(file, "\nstatic const char *%sUniformNames[%s_UNIFORMS_COUNT] = {", names, prefix);
+        for (int i = 0, index = 0; i < count; i++)
+        {
+            if ((variables[i].kind >= VARIABLE_UNIFORM) && (variables[i].block[0] == '\0')) fprintf(file, "%s \"%s\"", ((index++ > 0) ? "," : ""), variables[i].name);
+        }
+
+        // Uniform sizes are float components (0 for samplers)
+        fprintf(file, " };\nstatic const int %sUniformSizes[%s_UNIFORMS_COUNT] = {", names, prefix);
+        for (int i = 0, index = 0; i < count; i++)
+        {
+            if ((variables[i].kind >= VARIABLE_UNIFORM) && (variables[i].block[0] == '\0')) fprintf(file, "%s %i", ((index++ > 0) ? "," : ""), GetTypeComponents(variables[i].type));
+        }
+        fprintf(file, " };\n");
+    }
+
+    for (int i = 0, index = 0; i < count; i++)
+    {
+        if ((variables[i].kind == VARIABLE_UNIFORM) && (variables[i].block[0] == '\0') && (variables[i].binding != -1))
+        {
+            if (index++ == 0) fprintf(file, "\n// Uniforms explicit locations\n");
+            GetUpperName(variables[i].name, upper);
+            fprintf(file, "#define %s_UNIFORM_%s_LOCATION %i\n", prefix, upper, variables[i].binding);
+        }
+    }
+
+    for (int i = 0, index = 0; i < count; i++)
+    {
+        if (variables[i].kind == VARIABLE_SAMPLER)
+        {
+            if (index++ == 0) fprintf(file, "\n// Samplers texture units\n");
+            GetUpperName(variables[i].name, upper);
+            fprintf(file, "#define %s_SAMPLER_%s %i\n", prefix, upper, variables[i].binding);
+        }
+    }
+
+    // Vertex texture fetches need GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS of at least this count (it can be 0 on OpenGL ES 2.0)
+    int vertexSamplers = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if ((variables[i].kind == VARIABLE_SAMPLER) && variables[i].vertex) vertexSamplers++;
+    }
+
+    if (vertexSamplers > 0) fprintf(file, "\n// Vertex shader texture units needed (GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS)\n#define %s_VERTEX_TEXTURE_UNITS %i\n", prefix, vertexSamplers);
+
+    // Uniform blocks binding points, sizes and std140 members offsets
+    const char *blocks[2] = { "FrameData", "MaterialData" };
+    const int bindings[2] = { FRAME_BLOCK_BINDING, MATERIAL_BLOCK_BINDING };
+
+    for (int b = 0; b < 2; b++)
+    {
+        int size = 0;
+        bool declared = false;
+        char block[16] = { '\0' };
+        GetUpperName(blocks[b], block);
+
+        for (int i = 0; i < count; i++)
+        {
+            if (strcmp(variables[i].block, blocks[b]) == 0)
+            {
+                if (!declared) fprintf(file, "\n// %s uniform block\n#define %s_%s_BINDING %i\n", blocks[b], prefix, block, bindings[b]);
+                declared = true;
+
+                GetUpperName(variables[i].name, upper);
+                fprintf(file, "#define %s_%s_%s_OFFSET %i\n", prefix, block, upper, variables[i].binding);
+
+                int end = variables[i].binding + GetTypeComponents(variables[i].type)*4;
+                if (end > size) size = end;
+            }
+        }
+
+        if (declared) fprintf(file, "#define %s_%s_SIZE %i\n", prefix, block, (size + 15)/16*16);
+    }
+
+    fprintf(file, "\n#endif // %s_REFLECTION_H\n", prefix);
+}
+
+// Frees a permutation cached shaders code
+void ClearPermutation(int permutation)
+{
+    for (int i = 0; i < MAX_VARIANTS; i++)
+    {
+        for (int k = 0; k < 2; k++)
+        {
+            if (permutationSources[permutation][i][k] != NULL) FNODE_FREE(permutationSources[permutation][i][k]);
+            permutationSources[permutation][i][k] = NULL;
+        }
+    }
+}
+
+// Returns a hash of graph nodes, lines, textures and compile settings ignoring static property values
+unsigned int GetGraphHash()
+{
+    unsigned int hash = 2166136261u;
+    int settings[6 + MAX_LODS] = { version, compileMode, precisionMode, instancing, uniformBlocks, texturePacking };
+
+    for (int i = 0; i < MAX_LODS; i++) settings[6 + i] = lodBudgets[i];
+    for (int i = 0; i < 6 + MAX_LODS; i++) hash = (hash ^ (unsigned int)settings[i])*16777619u;
+
+    // Texture units change average values used by lower levels of detail, dropped textures are hashed by path since their ids change when loaded again
+    for (int i = 0; i < MAX_TEXTURES; i++)
+    {
+        hash = (hash ^ (unsigned int)((textures[i].id != 0) && (lutOwners[i] == -1)))*16777619u;
+        for (int k = 0; texturePaths[i][k] != '\0'; k++) hash = (hash ^ (unsigned char)texturePaths[i][k])*16777619u;
+    }
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        hash = (hash ^ nodes[i]->id)*16777619u;
+        hash = (hash ^ (unsigned int)(nodes[i]->type + 2))*16777619u;
+        hash = (hash ^ (unsigned int)(nodes[i]->property + nodes[i]->staticProperty*2 + nodes[i]->instanceProperty*4))*16777619u;
+        hash = (hash ^ (unsigned int)nodes[i]->output.dataCount)*16777619u;
+        if (nodes[i]->type == FNODE_FUNCTION)
+        {
+            // Function nodes hash their library function name since its index depends on library loading order
+            for (int k = 0; functions[nodes[i]->function]->name[k] != '\0'; k++) hash = (hash ^ (unsigned char)functions[nodes[i]->function]->name[k])*16777619u;
+        }
+
+        for (int k = 0; (k < nodes[i]->output.dataCount) && (nodes[i]->type <= FNODE_VECTOR4) && !nodes[i]->staticProperty; k++)
+        {
+            unsigned int bits = 0;
+            memcpy(&bits, &nodes[i]->output.data[k].value, sizeof(float));
+            hash = (hash ^ bits)*16777619u;
+        }
+    }
+
+    for (int i = 0; i < linesCount; i++)
+    {
+        hash = (hash ^ lines[i]->from)*16777619u;
+        hash = (hash ^ lines[i]->to)*16777619u;
+    }
+
+    return hash;
+}
+
+// Destroys unreachable nodes and renumbers nodes and lines in an order independent of their ids and positions
+void CanonicalizeGraph()
+{
+    unsigned int hashes[MAX_NODES] = { 0 };
+    bool hashed[MAX_NODES] = { false };
+    int ids[MAX_NODES] = { 0 };
+
+    MarkReachableNodes();
+    for (int i = nodesCount - 1; i >= 0; i--)
+    {
+        if (!reachableNodes[nodes[i]->id]) DestroyNode(nodes[i]);
+    }
+
+    for (int i = 0; i < nodesCount; i++) GetShapeHash(nodes[i], hashes, hashed);
+    for (int i = 0; i < MAX_NODES; i++) ids[i] = -1;
+
+    // Output nodes keep first ids and their inputs subgraphs are numbered in post order
+    ids[nodes[0]->id] = 0;
+    ids[nodes[1]->id] = 1;
+    int count = OrderCanonicalNodes(nodes[0], hashes, ids, 2);
+    OrderCanonicalNodes(nodes[1], hashes, ids, count);
+
+    // Every line is a node input, so lines are rewritten sorted by consumer and canonical input order to rebuild nodes inputs in that order
+    int line = 0;
+    for (int i = 0; i < nodesCount; i++)
+    {
+        FNode node = NULL;
+        for (int k = 0; k < nodesCount; k++)
+        {
+            if (ids[nodes[k]->id] == i) node = nodes[k];
+        }
+
+        int inputs[MAX_INPUTS] = { -1, -1, -1, -1 };
+        GetCanonicalInputs(node, hashes, inputs);
+
+        for (int k = 0; k < node->inputsCount; k++)
+        {
+            lines[line]->id = line;
+            lines[line]->from = ids[inputs[k]];
+            lines[line]->to = i;
+            line++;
+        }
+    }
+
+    for (int i = 0; i < nodesCount; i++) nodes[i]->id = ids[nodes[i]->id];
+
+    for (int i = 1; i < nodesCount; i++)
+    {
+        for (int k = i; (k > 0) && (nodes[k - 1]->id > nodes[k]->id); k--)
+        {
+            FNode temp = nodes[k];
+            nodes[k] = nodes[k - 1];
+            nodes[k - 1] = temp;
+        }
+    }
+
+    CalculateValues();
+}
+
+// Returns a hash of a node subgraph operations and values independent of node ids
+unsigned int GetShapeHash(FNode node, unsigned int *hashes, bool *hashed)
+{
+    if (!hashed[node->id])
+    {
+        unsigned int hash = 2166136261u;
+        unsigned int inputs[MAX_INPUTS] = { 0 };
+
+        hash = (hash ^ (unsigned int)(node->type + 2))*16777619u;
+        hash = (hash ^ (unsigned int)(node->property + node->staticProperty*2 + node->instanceProperty*4))*16777619u;
+        hash = (hash ^ (unsigned int)node->output.dataCount)*16777619u;
+        hash = (hash ^ (unsigned int)(node->function + 1))*16777619u;
+
+        for (int i = 0; (i < node->output.dataCount) && (node->type <= FNODE_VECTOR4); i++)
+        {
+            unsigned int bits = 0;
+            memcpy(&bits, &node->output.data[i].value, sizeof(float));
+            hash = (hash ^ bits)*16777619u;
+        }
+
+        for (int i = 0; i < node->inputsCount; i++) inputs[i] = GetShapeHash(nodes[GetNodeIndex(node->inputs[i])], hashes, hashed);
+
+        if (IsNodeCommutative(node))
+        {
+            for (int i = 1; i < node->inputsCount; i++)
+            {
+                for (int k = i; (k > 0) && (inputs[k - 1] > inputs[k]); k--)
+                {
+                    unsigned int temp = inputs[k];
+                    inputs[k] = inputs[k - 1];
+                    inputs[k - 1] = temp;
+                }
+            }
+        }
+
+        for (int i = 0; i < node->inputsCount; i++) hash = (hash ^ inputs[i])*16777619u;
+
+        hashes[node->id] = hash;
+        hashed[node->id] = true;
+    }
+
+    return hashes[node->id];
+}
+
+// Returns a node inputs ids in canonical order (sorted by subgraph hash for commutative operations)
+void GetCanonicalInputs(FNode node, unsigned int *hashes, int *inputs)
+{
+    for (int i = 0; i < node->inputsCount; i++) inputs[i] = node->inputs[i];
+
+    if (IsNodeCommutative(node))
+    {
+        for (int i = 1; i < node->inputsCount; i++)
+        {
+            for (int k = i; (k > 0) && (hashes[inputs[k - 1]] > hashes[inputs[k]]); k--)
+            {
+                int temp = inputs[k];
+                inputs[k] = inputs[k - 1];
+                inputs[k - 1] = temp;
+            }
+        }
+    }
+}
+
+// Assigns canonical ids to a node inputs subgraph in post order and returns next canonical id
+int OrderCanonicalNodes(FNode node, unsigned int *hashes, int *ids, int count)
+{
+    int inputs[MAX_INPUTS] = { -1, -1, -1, -1 };
+    GetCanonicalInputs(node, hashes, inputs);
+
+    for (int i = 0; i < node->inputsCount; i++)
+    {
+        if (ids[inputs[i]] == -1)
+        {
+            count = OrderCanonicalNodes(nodes[GetNodeIndex(inputs[i])], hashes, ids, count);
+            ids[inputs[i]] = count;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+// Returns a hash of a canonicalized graph including static property values
+unsigned int GetCanonicalHash()
+{
+    unsigned int hash = GetGraphHash();
+
+    // Static property values are the shader default permutation
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (nodes[i]->staticProperty)
+        {
+            unsigned int bits = 0;
+            memcpy(&bits, &nodes[i]->output.data[0].value, sizeof(float));
+            hash = (hash ^ bits)*16777619u;
+        }
+    }
+
+    return hash;
+}
+
+// Returns an allocated text of a canonicalized graph nodes, lines, textures and compile settings to compare graphs with the same canonical hash
+char *GetCanonicalKey()
+{
+    char *key = NULL;
+    FILE *file = tmpfile();
+
+    if (file != NULL)
+    {
+        fprintf(file, "settings %i %i %i %i %i %i", version, compileMode, precisionMode, instancing, uniformBlocks, texturePacking);
+        for (int i = 0; i < MAX_LODS; i++) fprintf(file, " %i", lodBudgets[i]);
+        fprintf(file, "\n");
+
+        for (int i = 0; i < MAX_TEXTURES; i++) fprintf(file, "texture %i %i %s\n", i, ((textures[i].id != 0) && (lutOwners[i] == -1)), texturePaths[i]);
+
+        for (int i = 0; i < nodesCount; i++)
+        {
+            fprintf(file, "node %i %i %i %i %i %i %s", nodes[i]->id, nodes[i]->type, nodes[i]->property, nodes[i]->staticProperty, nodes[i]->instanceProperty,
+            nodes[i]->output.dataCount, ((nodes[i]->type == FNODE_FUNCTION) ? functions[nodes[i]->function]->name : "-"));
+
+            // Constant values are compared by their bits like they are hashed
+            for (int k = 0; (k < nodes[i]->output.dataCount) && (nodes[i]->type <= FNODE_VECTOR4); k++)
+            {
+                unsigned int bits = 0;
+                memcpy(&bits, &nodes[i]->output.data[k].value, sizeof(float));
+                fprintf(file, " %08x", bits);
+            }
+
+            fprintf(file, "\n");
+        }
+
+        for (int i = 0; i < linesCount; i++) fprintf(file, "line %i %i\n", lines[i]->from, lines[i]->to);
+
+        key = ReadShaderSource(file);
+        fclose(file);
+    }
+    else TraceLogFNode(true, "error when trying to create canonical graph key temporary file");
+
+    return key;
+}
+
+// Writes a quoted JSON string escaping its special characters
+void WriteJsonString(FILE *file, const char *text)
+{
+    fprintf(file, "\"");
+
+    for (int i = 0; text[i] != '\0'; i++)
+    {
+        if ((text[i] == '"') || (text[i] == '\\')) fprintf(file, "\\%c", text[i]);
+        else if ((unsigned char)text[i] < 0x20) fprintf(file, "\\u%04x", (unsigned char)text[i]);
+        else fputc(text[i], file);
+    }
+
+    fprintf(file, "\"");
+}
+
+// Compiles shader graphs into one shared program per canonical graph hash and writes programs manifest
+void CompileBatch(const char **paths, int count, int vertexBudget, int fragmentBudget)
+{
+    unsigned int programs[MAX_BATCH_GRAPHS] = { 0 };
+    char *programKeys[MAX_BATCH_GRAPHS] = { NULL };
+    int programMaterials[MAX_BATCH_GRAPHS] = { 0 };
+    int materialPrograms[MAX_BATCH_GRAPHS] = { 0 };
+    int programsCount = 0;
+    TexturePacking packing = texturePacking;
+
+    for (int i = 0; i < count; i++)
+    {
+        // Each graph loads its own dropped textures and packing setting (packing passed as command line argument is kept)
+        UnloadGraph();
+        texturePacking = packing;
+        if (!LoadGraph(paths[i]) || (nodesCount < 2)) TraceLogFNode(true, "error when trying to load shader graph %s", paths[i]);
+        LoadPackLayout(paths[i]);
+
+        CanonicalizeGraph();
+        unsigned int hash = GetCanonicalHash();
+        char *key = GetCanonicalKey();
+        int program = -1;
+
+        // Graphs share a program only if their canonical graphs are equal, different graphs with the same hash use the next free hash
+        for (int k = 0; k < programsCount; k++)
+        {
+            if (programs[k] == hash)
+            {
+                if (strcmp(programKeys[k], key) == 0) program = k;
+                else
+                {
+                    TraceLogFNode(false, "shader graph %s canonical hash %08x collides with a different graph", paths[i], hash);
+                    hash++;
+                    k = -1;
+                }
+            }
+        }
+
+        // Materials with an already compiled canonical graph share its program and its stages cost
+        if (program == -1)
+        {
+            programHash = hash;
+            // Editor GL context only loads GLSL 330 shaders, other targets are cross compiled without a load check
+            CompileShader();
+            if ((version == GLSL_330) && (model.material.shader.id == GetShaderDefault().id)) TraceLogFNode(true, "compiled shader %s failed to load", paths[i]);
+
+            if ((vertexBudget >= 0) && (GetCostTotal(vertexCost) > vertexBudget)) TraceLogFNode(true, "vertex shader cost %i of %s exceeds budget %i", GetCostTotal(vertexCost), paths[i], vertexBudget);
+            if ((fragmentBudget >= 0) && (GetCostTotal(fragmentCost) > fragmentBudget)) TraceLogFNode(true, "fragment shader cost %i of %s exceeds budget %i", GetCostTotal(fragmentCost), paths[i], fragmentBudget);
+
+            WriteProgramFiles(hash);
+            programHash = 0;
+
+            program = programsCount;
+            programs[programsCount] = hash;
+            programKeys[programsCount] = key;
+            programsCount++;
+        }
+        else
+        {
+            TraceLogFNode(false, "shader graph %s shares program %08x", paths[i], hash);
+            FNODE_FREE(key);
+        }
+
+        materialPrograms[i] = program;
+        programMaterials[program]++;
+    }
+
+    UnloadGraph();
+    texturePacking = packing;
+    for (int i = 0; i < programsCount; i++) FNODE_FREE(programKeys[i]);
+
+    FILE *file = fopen(MANIFEST_PATH, "w");
+    if (file != NULL)
+    {
+        char vertexPath[64] = { '\0' };
+        char fragmentPath[64] = { '\0' };
+
+        fprintf(file, "{\n    \"programs\": [");
+        for (int i = 0; i < programsCount; i++)
+        {
+            sprintf(vertexPath, PROGRAM_PATH, programs[i], ".vs");
+            sprintf(fragmentPath, PROGRAM_PATH, programs[i], ".fs");
+            fprintf(file, "%s\n        { \"hash\": \"%08x\", \"vertex\": \"%s\", \"fragment\": \"%s\", \"materials\": %i }", ((i > 0) ? "," : ""), programs[i], vertexPath, fragmentPath, programMaterials[i]);
+        }
+
+        fprintf(file, "\n    ],\n    \"materials\": [");
+        for (int i = 0; i < count; i++)
+        {
+            // Graph paths come from command line arguments so they are escaped
+            fprintf(file, "%s\n        { \"graph\": ", ((i > 0) ? "," : ""));
+            WriteJsonString(file, paths[i]);
+            fprintf(file, ", \"program\": \"%08x\" }", programs[materialPrograms[i]]);
+        }
+        fprintf(file, "\n    ]\n}\n");
+
+        fclose(file);
+    }
+    else TraceLogFNode(true, "error when trying to open and write in programs manifest file");
+
+    TraceLogFNode(false, "batch compile: %i shader graphs compiled into %i shared programs", count, programsCount);
+}
+
+// Moves compiled levels of detail shaders and reflection metadata to shared program files (reflection headers are written as program files)
+void WriteProgramFiles(unsigned int hash)
+{
+    for (int lod = 0; lod < (depthVariant ? MAX_VARIANTS : MAX_LODS); lod++)
+    {
+        char paths[4][64] = { { '\0' }, { '\0' }, { '\0' }, { '\0' } };
+        GetLodPaths(lod, paths[0], paths[1]);
+        GetReflectionPaths(lod, paths[2], paths[3]);
+
+        // Program files replace shader files output/shader prefix and keep their level of detail and extension suffixes
+        for (int i = 0; i < 3; i++)
+        {
+            char programPath[64] = { '\0' };
+            sprintf(programPath, PROGRAM_PATH, hash, paths[i] + strlen("output/shader"));
+
+            remove(programPath);
+            if (rename(paths[i], programPath) != 0) TraceLogFNode(false, "error when trying to write shared program file %s", programPath);
+        }
+    }
+}
+
+// Destroys all nodes and lines, clears used permutations and restores default textures before loading another graph
+void UnloadGraph()
+{
+    while (nodesCount > 0) DestroyNode(nodes[nodesCount - 1]);
+    while (linesCount > 0) DestroyNodeLine(lines[linesCount - 1]);
+
+    for (int i = 0; i < permutationsCount; i++) ClearPermutation(i);
+    permutationsCount = 0;
+    staticNodesCount = 0;
+    remove(PERMUTATIONS_PATH);
+
+    // Next graph lookup tables are baked again even if their node ids and subgraphs match
+    for (int i = 0; i < MAX_NODES; i++) lutHashes[i] = 0;
+
+    // Dropped textures and baked lookup tables belong to current graph, default textures are loaded again
+    for (int i = 0; i < MAX_TEXTURES; i++)
+    {
+        if ((texturePaths[i][0] != '\0') || (lutOwners[i] != -1))
+        {
+            switch (i)
+            {
+                case 0: SetTextureUnit(i, LoadTexture(MODEL_TEXTURE_WINDAMOUNT)); break;
+                case 1: SetTextureUnit(i, LoadTexture(MODEL_TEXTURE_DIFFUSE)); break;
+                default: SetTextureUnit(i, (Texture2D){ 0 }); break;
+            }
+
+            texturePaths[i][0] = '\0';
+            packChanged = true;
+        }
+    }
+
+    loadedFiles = 0;
+}
+
+// Returns an allocated copy of a shader file contents
+char *ReadShaderSource(FILE *file)
+{
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    char *source = (char *)FNODE_MALLOC(size + 1);
+
+    rewind(file);
+    size = (long)fread(source, 1, size, file);
+    source[size] = '\0';
+
+    return source;
+}
+
+// Returns vertex and fragment shader output paths of a level of detail or depth only variant (full detail variant keeps default paths)
+void GetLodPaths(int lod, char *vertexPath, char *fragmentPath)
+{
+    if (lod == 0)
+    {
+        strcpy(vertexPath, VERTEX_PATH);
+        strcpy(fragmentPath, FRAGMENT_PATH);
+    }
+    else if (lod == DEPTH_VARIANT)
+    {
+        strcpy(vertexPath, DEPTH_VERTEX_PATH);
+        strcpy(fragmentPath, DEPTH_FRAGMENT_PATH);
+    }
+    else
+    {
+        sprintf(vertexPath, LOD_VERTEX_PATH, lod);
+        sprintf(fragmentPath, LOD_FRAGMENT_PATH, lod);
+    }
+}
+
+// Returns reflection metadata and C header output paths of a level of detail or depth only variant
+void GetReflectionPaths(int lod, char *jsonPath, char *headerPath)
+{
+    if (lod == 0)
+    {
+        strcpy(jsonPath, REFLECTION_PATH);
+        strcpy(headerPath, REFLECTION_HEADER_PATH);
+    }
+    else if (lod == DEPTH_VARIANT)
+    {
+        strcpy(jsonPath, DEPTH_REFLECTION_PATH);
+        strcpy(headerPath, DEPTH_REFLECTION_HEADER_PATH);
+    }
+    else
+    {
+        sprintf(jsonPath, LOD_REFLECTION_PATH, lod);
+        sprintf(headerPath, LOD_REFLECTION_HEADER_PATH, lod);
+    }
+}
+
+// Calculates nodes average output values replacing texture samples by their texture average color
+void CalculateAverageValues()
+{
+    bool evaluated[MAX_NODES] = { false };
+    bool restored[MAX_NODES] = { false };
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (reachableNodes[nodes[i]->id]) EvaluateNodeValues(nodes[i], evaluated, true);
+    }
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        for (int k = 0; k < 4; k++) averageValues[nodes[i]->id][k] = nodes[i]->output.data[k].value;
+    }
+
+    // Restore nodes values calculated from texture samples average
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (reachableNodes[nodes[i]->id]) EvaluateNodeValues(nodes[i], restored, false);
+    }
+}
+
+// Calculates a node and its inputs output values once (optionally with texture samples replaced by their texture average color)
+void EvaluateNodeValues(FNode node, bool *evaluated, bool average)
+{
+    if (!evaluated[node->id])
+    {
+        evaluated[node->id] = true;
+
+        for (int i = 0; i < node->inputsCount; i++) EvaluateNodeValues(nodes[GetNodeIndex(node->inputs[i])], evaluated, average);
+
+        if (node->type == FNODE_TIME) node->output.data[0].value = currentTime;
+        else if (node->type > FNODE_VECTOR4) CalculateNodeValues(node);
+
+        if (average && ((node->type == FNODE_SAMPLER2D) || (node->type >= FNODE_SAMPLERLOD)) && (node->inputsCount >= 2))
+        {
+            int unit = (int)nodes[GetNodeIndex(node->inputs[0])]->output.data[0].value;
+            int channel = (int)nodes[GetNodeIndex(node->inputs[1])]->output.data[0].value;
+            Vector4 color = (((unit >= 0) && (unit < MAX_TEXTURES)) ? GetTextureAverage(textures[unit]) : (Vector4){ 0.5f, 0.5f, 0.5f, 1.0f });
+            float channels[4] = { color.x, color.y, color.z, color.w };
+
+            if (node->output.dataCount > 1)
+            {
+                for (int i = 0; i < node->output.dataCount; i++) node->output.data[i].value = channels[i];
+            }
+            else if ((channel >= 2) && (channel <= 5)) node->output.data[0].value = channels[channel - 2];
+        }
+    }
+}
+
+// Returns the average color of a texture in 0 to 1 range
+Vector4 GetTextureAverage(Texture2D texture)
+{
+    Vector4 average = { 0.5f, 0.5f, 0.5f, 1.0f };
+
+    if (texture.id != 0)
+    {
+        Image image = GetTextureData(texture);
+        Color *pixels = GetImageData(image);
+        int count = image.width*image.height;
+
+        if ((pixels != NULL) && (count > 0))
+        {
+            double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+            for (int i = 0; i < count; i++)
+            {
+                sum[0] += pixels[i].r;
+                sum[1] += pixels[i].g;
+                sum[2] += pixels[i].b;
+                sum[3] += pixels[i].a;
+            }
+
+            average = (Vector4){ sum[0]/(255.0*count), sum[1]/(255.0*count), sum[2]/(255.0*count), sum[3]/(255.0*count) };
+        }
+
+        free(pixels);
+        UnloadImage(image);
+    }
+
+    return average;
+}
+
+// Resolves optional nodes and replaces fragment subgraphs by their average values to fit a level of detail budget
+void ApproximateNodes(int lod)
+{
+    int detailCost = 0;
+
+    for (int i = 0; i < MAX_NODES; i++) approximatedNodes[i] = false;
+
+    // Full detail cost estimation only counts optional nodes detail input
+    PlaceNodes();
+
+    if (nodes[1]->inputsCount > 0)
+    {
+        bool counted[MAX_NODES] = { false };
+        detailCost = GetCostTotal(GetSubgraphCost(nodes[GetNodeIndex(nodes[1]->inputs[0])], counted));
+    }
+
+    // Optional nodes consumers read their detail input in full detail variant and their fallback input in lower ones
+    for (int i = 0; i < nodesCount; i++)
+    {
+        for (int k = 0; (k < nodes[i]->inputsCount) && reachableNodes[nodes[i]->id]; k++)
+        {
+            FNode input = nodes[GetNodeIndex(nodes[i]->inputs[k])];
+
+            while ((input->type == FNODE_OPTIONAL) && (input->inputsCount > ((lod == 0) ? 0 : 1))) input = nodes[GetNodeIndex(input->inputs[((lod == 0) ? 0 : 1)])];
+
+            // Optional nodes without fallback input are declared with their detail input average values
+            if ((input->type == FNODE_OPTIONAL) && (input->inputsCount > 0))
+            {
+                bool visited[MAX_NODES] = { false };
+
+                if ((input->output.dataCount <= 4) && IsAverageFinite(input) && !IsNodeVarying(input, visited))
+                {
+                    if (!approximatedNodes[input->id]) ApproximateNode(input);
+                }
+                else input = nodes[GetNodeIndex(input->inputs[0])];
+            }
+
+            nodes[i]->inputs[k] = input->id;
+        }
+    }
+
+    MarkReachableNodes();
+    PlaceNodes();
+
+    if ((lod > 0) && (nodes[1]->inputsCount > 0))
+    {
+        FNode root = nodes[GetNodeIndex(nodes[1]->inputs[0])];
+        int budget = ((lodBudgets[lod] >= 0) ? lodBudgets[lod] : (int)(detailCost*powf(LOD_BUDGET_SCALE, lod)));
+        bool counted[MAX_NODES] = { false };
+        int cost = GetCostTotal(GetSubgraphCost(root, counted));
+        int approximatedCount = 0;
+        bool approximating = true;
+
+        // Approximate the subgraph with the smallest saving which fits the budget (or the largest one if none does) until budget is reached
+        while ((cost > budget) && approximating)
+        {
+            FNode candidate = NULL;
+            int candidateGain = 0;
+
+            for (int i = 0; i < nodesCount; i++)
+            {
+                FNode node = nodes[i];
+
+                bool visited[MAX_NODES] = { false };
+
+                // Built-in values are evaluated once in CPU so subgraphs reading them have no average value
+                if (counted[node->id] && (node->output.dataCount > 0) && (node->output.dataCount <= 4) && (node->type >= FNODE_ADD) && IsAverageFinite(node) && !IsNodeVarying(node, visited))
+                {
+                    bool subgraph[MAX_NODES] = { false };
+                    bool approximated[MAX_NODES] = { false };
+                    ShaderCost subgraphCost = GetSubgraphCost(node, subgraph);
+
+                    // Saving is measured on the whole fragment cost, nodes shared with other consumers are still paid
+                    foldedNodes[node->id] = true;
+                    int gain = cost - GetCostTotal(GetSubgraphCost(root, approximated));
+                    foldedNodes[node->id] = false;
+
+                    bool fits = (gain >= (cost - budget));
+                    bool candidateFits = (candidateGain >= (cost - budget));
+
+                    // Subgraphs which discard fragments keep their shape in all variants
+                    if ((gain > 0) && (subgraphCost.discard == 0) && ((candidate == NULL) || (fits && (!candidateFits || (gain < candidateGain))) || (!fits && !candidateFits && (gain > candidateGain))))
+                    {
+                        candidate = node;
+                        candidateGain = gain;
+                    }
+                }
+            }
+
+            approximating = (candidate != NULL);
+
+            if (approximating)
+            {
+                ApproximateNode(candidate);
+                approximatedCount++;
+                PlaceNodes();
+
+                for (int i = 0; i < MAX_NODES; i++) counted[i] = false;
+                cost = GetCostTotal(GetSubgraphCost(root, counted));
+            }
+        }
+
+        TraceLogFNode(false, "LOD%i fragment cost estimation: %i of %i budget (%i subgraphs approximated by their average value)", lod, cost, budget, approximatedCount);
+        if (cost > budget) TraceLogFNode(false, "LOD%i fragment cost %i exceeds budget %i, no other subgraph approximation reduces it", lod, cost, budget);
+    }
+}
+
+// Declares a node as a constant with its average values
+void ApproximateNode(FNode node)
+{
+    approximatedNodes[node->id] = true;
+    foldedNodes[node->id] = true;
+
+    for (int i = 0; i < node->output.dataCount; i++) node->output.data[i].value = averageValues[node->id][i];
+}
+
+// Returns true if all node average output values can be declared as a constant
+bool IsAverageFinite(FNode node)
+{
+    bool finite = true;
+
+    for (int i = 0; (i < node->output.dataCount) && finite; i++) finite = isfinite(averageValues[node->id][i]);
+
+    return finite;
+}
+
+// Check if a node output depends on per vertex or per frame built-in values which have no average value
+bool IsNodeVarying(FNode node, bool *visited)
+{
+    bool varying = false;
+
+    if (!visited[node->id])
+    {
+        visited[node->id] = true;
+
+        switch (node->type)
+        {
+            case FNODE_TIME:
+            case FNODE_VERTEXPOSITION:
+            case FNODE_VERTEXNORMAL:
+            case FNODE_FRESNEL:
+            case FNODE_VIEWDIRECTION:
+            case FNODE_VERTEXCOLOR: varying = true; break;
+            default:
+            {
+                for (int i = 0; (i < node->inputsCount) && !varying; i++) varying = IsNodeVarying(nodes[GetNodeIndex(node->inputs[i])], visited);
+            } break;
+        }
+    }
+
+    return varying;
+}
+
+// Returns fragment shader cost estimation of a node and its inputs
+ShaderCost GetSubgraphCost(FNode node, bool *counted)
+{
+    ShaderCost cost = { 0 };
+
+    if (!counted[node->id] && !foldedNodes[node->id] && !hoistedNodes[node->id])
+    {
+        counted[node->id] = true;
+        cost = GetNodeCost(node);
+
+        // Samplers of an already counted texture unit only read its shared texel
+        if ((node->type == FNODE_SAMPLER2D) && (node->inputsCount > 0))
+        {
+            int unit = (int)nodes[GetNodeIndex(node->inputs[0])]->output.data[0].value;
+
+            for (int i = 0; i < nodesCount; i++)
+            {
+                if ((nodes[i] != node) && counted[nodes[i]->id] && (nodes[i]->type == FNODE_SAMPLER2D) && (nodes[i]->inputsCount > 0) && ((int)nodes[GetNodeIndex(nodes[i]->inputs[0])]->output.data[0].value == unit))
+                {
+                    cost.alu = 0;
+                    cost.texture = 0;
+                }
+            }
+        }
+
+        for (int i = 0; i < node->inputsCount; i++)
+        {
+            // Baked lookup tables only evaluate their coordinates and optional nodes their detail input
+            if (((node->type != FNODE_LUT) || (i % 2 == 1) || !IsLutNodeBakeable(node)) && ((node->type != FNODE_OPTIONAL) || (i == 0)))
+            {
+                ShaderCost input = GetSubgraphCost(nodes[GetNodeIndex(node->inputs[i])], counted);
+
+                cost.alu += input.alu;
+                cost.transcendental += input.transcendental;
+                cost.texture += input.texture;
+                cost.discard += input.discard;
+            }
+        }
+    }
+
+    return cost;
+}
+
+// Check nodes searching for constant values to define them in shaders
+void CheckConstant(FNode node, FILE *file, bool fragment)
+{
+    bool hoistedUniform = (hoistedNodes[node->id] && (nodeStages[node->id] == STAGE_UNIFORM));
+    bool hoistedVarying = (hoistedNodes[node->id] && (nodeStages[node->id] == STAGE_VERTEX) && fragment);
+
+    if (!declaredConstants[node->id])
+    {
+        declaredConstants[node->id] = true;
+
+        // Constant subgraphs are declared with their CPU calculated values and their inputs are not needed
+        if (foldedNodes[node->id])
+        {
+            char literal[256] = { '\0' };
+            FormatConstant(node, 1.0f, false, literal);
+            fprintf(file, "const %s node_%02i = %s;\n", GetDataTypeName(node->output.dataCount), node->id, literal);
+        }
+        // Per frame nodes are calculated in CPU, vertex shader hoisted nodes and per instance properties are declared with input attributes (uniform block members in their block)
+        else if (hoistedUniform && !blockNodes[node->id])
+        {
+            WriteUniformLayout(file, VALUE_UNIFORM_LOCATION + node->id, false);
+            fprintf(file, "uniform %s%s node_%02i;\n", GetUniformPrecision(node, fragment), GetDataTypeName(node->output.dataCount), node->id);
+        }
+        else if (!hoistedVarying && (GetInstanceAttribute(node) == -1) && !blockNodes[node->id])
+        {
+            switch (node->type)
+            {
+                case FNODE_PI: fprintf(file, "const float node_%02i = 3.14159265358979323846;\n", node->id); break;
+                case FNODE_E: fprintf(file, "const float node_%02i = 2.71828182845904523536;\n", node->id); break;
+                case FNODE_MATRIX:
+                {
+                    if (compileMode == COMPILE_AUTHORING)
+                    {
+                        WriteUniformLayout(file, VALUE_UNIFORM_LOCATION + node->id, false);
+                        const char fConstantMatrix[] = "uniform %smat4 node_%02i;\n";
+                        fprintf(file, fConstantMatrix, GetUniformPrecision(node, fragment), node->id);
+                    }
+                    else
+                    {
+                        fprintf(file, "const mat4 node_%02i = mat4(", node->id);
+                        for (int i = 0; i < 16; i++) fprintf(file, ((i < 15) ? "%.3f, " : "%.3f);\n"), node->output.data[i].value);
+                    }
+                } break;
+                case FNODE_VALUE:
+                {
+                    if (!node->staticProperty && (node->property || (compileMode == COMPILE_AUTHORING)))
+                    {
+                        WriteUniformLayout(file, VALUE_UNIFORM_LOCATION + node->id, false);
+                        const char fConstantVector4[] = "uniform %sfloat node_%02i;\n";
+                        fprintf(file, fConstantVector4, GetUniformPrecision(node, fragment), node->id);
+                    }
+                    else
+                    {
+                        const char fConstantValue[] = "const float node_%02i = %.3f;\n";
+                        fprintf(file, fConstantValue, node->id, node->output.data[0].value);
+                    }
+                } break;
+                case FNODE_VECTOR2:
+                {
+                    if (compileMode == COMPILE_AUTHORING)
+                    {
+                        WriteUniformLayout(file, VALUE_UNIFORM_LOCATION + node->id, false);
+                        const char fConstantVector2[] = "uniform %svec2 node_%02i;\n";
+                        fprintf(file, fConstantVector2, GetUniformPrecision(node, fragment), node->id);
+                    }
+                    else
+                    {
+                        const char fConstantVector2[] = "const vec2 node_%02i = vec2(%.3f, %.3f);\n";
+                        fprintf(file, fConstantVector2, node->id, node->output.data[0].value, node->output.data[1].value);
+                    }
+                } break;
+                case FNODE_VECTOR3:
+                {
+                    if (compileMode == COMPILE_AUTHORING)
+                    {
+                        WriteUniformLayout(file, VALUE_UNIFORM_LOCATION + node->id, false);
+                        const char fConstantVector3[] = "uniform %svec3 node_%02i;\n";
+                        fprintf(file, fConstantVector3, GetUniformPrecision(node, fragment), node->id);
+                    }
+                    else
+                    {
+                        const char fConstantVector3[] = "const vec3 node_%02i = vec3(%.3f, %.3f, %.3f);\n";
+                        fprintf(file, fConstantVector3, node->id, node->output.data[0].value, node->output.data[1].value, node->output.data[2].value);
+                    }
+                } break;
+                case FNODE_VECTOR4:
+                {
+                    if (node->property || (compileMode == COMPILE_AUTHORING))
+                    {
+                        WriteUniformLayout(file, VALUE_UNIFORM_LOCATION + node->id, false);
+                        const char fConstantVector4[] = "uniform %svec4 node_%02i;\n";
+                        fprintf(file, fConstantVector4, GetUniformPrecision(node, fragment), node->id);
+                    }
+                    else
+                    {
+                        const char fConstantVector4[] = "const vec4 node_%02i = vec4(%.3f, %.3f, %.3f, %.3f);\n";
+                        fprintf(file, fConstantVector4, node->id, node->output.data[0].value, node->output.data[1].value, node->output.data[2].value, node->output.data[3].value);
+                    }
+                } break;
+                case FNODE_SAMPLER2D:
+                case FNODE_SAMPLERLOD:
+                case FNODE_SAMPLERBIAS:
+                case FNODE_SAMPLERGRAD:
+                {
+                    int index = GetNodeIndex(node->inputs[0]);
+                    DeclareSampler(file, (int)nodes[index]->output.data[0].value);
+
+                    // Level of detail, bias and gradients inputs are shader values
+                    for (int i = 2; i < node->inputsCount; i++)
+                    {
+                        index = GetNodeIndex(node->inputs[i]);
+                        CheckConstant(nodes[index], file, fragment);
+                    }
+                } break;
+                case FNODE_LUT:
+                {
+                    // Baked lookup tables only need their coordinates inputs, their input subgraph is sampled from a texture
+                    if ((lutDomains[node->id].z == 0) && IsLutNodeBakeable(node)) lutDomains[node->id] = GetLutDomain(node);
+                    if (lutDomains[node->id].z > 0) DeclareSampler(file, (int)lutDomains[node->id].w);
+
+                    for (int i = 0; i < node->inputsCount; i++)
+                    {
+                        int index = GetNodeIndex(node->inputs[i]);
+                        if ((i % 2 == 1) || (lutDomains[node->id].z <= 0)) CheckConstant(nodes[index], file, fragment);
+                    }
+                } break;
+                case FNODE_FUNCTION:
+                {
+                    for (int i = 0; i < node->inputsCount; i++)
+                    {
+                        int index = GetNodeIndex(node->inputs[i]);
+                        CheckConstant(nodes[index], file, fragment);
+                    }
+
+                    // Library functions are written once in each shader file before their first call
+                    if (!writtenFunctions[node->function])
+                    {
+                        fprintf(file, "\n%s\n", functions[node->function]->source);
+                        writtenFunctions[node->function] = true;
+                    }
+                } break;
+                default:
+                {
+                    for (int i = 0; i < node->inputsCount; i++)
+                    {
+                        int index = GetNodeIndex(node->inputs[i]);
+                        CheckConstant(nodes[index], file, fragment);
+                    }
+                } break;
+            }
+        }
+    }
+}
+
+// Compiles a specific node checking its inputs and writing current node operation in shader
+void CompileNode(FNode node, FILE *file, bool fragment)
+{
+    bool hoistedUniform = (hoistedNodes[node->id] && (nodeStages[node->id] == STAGE_UNIFORM));
+    bool hoistedVarying = (hoistedNodes[node->id] && (nodeStages[node->id] == STAGE_VERTEX) && fragment);
+    bool folded = foldedNodes[node->id];
+    char expression[512] = { '\0' };
+    int operands[MAX_INPUTS] = { -1, -1, -1, -1 };
+    ShaderCost cost = { 0 };
+
+    // Check if current node is calculated in vertex shader to read it from its input attribute
+    if (hoistedVarying)
+    {
+        if (!declaredNodes[node->id])
+        {
+            declaredNodes[node->id] = true;
+            fprintf(file, "    %s%s node_%02i = fragNode_%02i;\n", GetPrecisionQualifier(node, fragment), GetDataTypeName(node->output.dataCount), node->id, node->id);
+        }
+    }
+    // Check if current node merges isomorphic scalar operations which can be calculated as a vector operation
+    else if (!hoistedUniform && !folded && (node->type == FNODE_APPEND) && IsAppendVectorizable(node))
+    {
+        if (!declaredNodes[node->id])
+        {
+            declaredNodes[node->id] = true;
+            CompileVectorizedAppend(node, file, fragment);
+        }
+    }
+    // Check if current node input subgraph is baked into a lookup table texture
+    else if (!hoistedUniform && !folded && (node->type == FNODE_LUT) && (lutDomains[node->id].z > 0))
+    {
+        if (!declaredNodes[node->id])
+        {
+            declaredNodes[node->id] = true;
+            CompileLutNode(node, file, fragment);
+        }
+    }
+    // Check if current node operation can be rewritten as a cheaper equivalent expression
+    else if (!hoistedUniform && !folded && !declaredNodes[node->id] && (node->inputsCount > 0) && SimplifyNode(node, expression, operands, &cost))
+    {
+        declaredNodes[node->id] = true;
+
+        // Compile only operator nodes referenced by simplified expression
+        for (int i = 0; (i < MAX_INPUTS) && (operands[i] != -1); i++)
+        {
+            int index = GetNodeIndex(operands[i]);
+            if (nodes[index]->type > FNODE_VECTOR4 || ((nodes[index]->type < FNODE_MATRIX) && (nodes[index]->type > FNODE_E))) CompileNode(nodes[index], file, fragment);
+        }
+
+        AddNodeCost(node, cost, fragment);
+
+        char body[1024] = { '\0' };
+        sprintf(body, "    %s%s node_%02i = %s;\n", GetPrecisionQualifier(node, fragment), GetDataTypeName(node->output.dataCount), node->id, expression);
+        WriteNodeBody(node, body, file, fragment);
+    }
+    // Check if current node is an operator (per frame nodes are declared as uniforms and constant subgraphs as constants)
+    else if (!hoistedUniform && !folded && ((node->inputsCount > 0) || ((node->type < FNODE_MATRIX) && (node->type > FNODE_E)) || (node->type == FNODE_SAMPLER2D)))
+    {
+        // Check for operator nodes in inputs to compile them first (declared nodes already compiled the inputs they need)
+        for (int i = 0; (i < node->inputsCount) && !declaredNodes[node->id]; i++)
+        {
+            int index = GetNodeIndex(node->inputs[i]);
+            if (nodes[index]->type > FNODE_VECTOR4 || ((nodes[index]->type < FNODE_MATRIX) && (nodes[index]->type > FNODE_E))) CompileNode(nodes[index], file, fragment);
+        }
+
+        // Check if current node is previously defined and declared in current shader file
+        if (!declaredNodes[node->id])
+        {
+            declaredNodes[node->id] = true;
+            AddNodeCost(node, GetNodeCost(node), fragment);
+
+            // Variable definition based on current node output data count
+            char body[4096] = { '\0' };
+            char definition[32] = { '\0' };
+            switch (node->output.dataCount)
+            {
+                case 1: sprintf(definition, "    %sfloat node_%02i = ", GetPrecisionQualifier(node, fragment), node->id); break;
+                case 2: sprintf(definition, "    %svec2 node_%02i = ", GetPrecisionQualifier(node, fragment), node->id); break;
+                case 3: sprintf(definition, "    %svec3 node_%02i = ", GetPrecisionQualifier(node, fragment), node->id); break;
+                case 4: sprintf(definition, "    %svec4 node_%02i = ", GetPrecisionQualifier(node, fragment), node->id); break;
+                case 16: sprintf(definition, "    %smat4 node_%02i = ", GetPrecisionQualifier(node, fragment), node->id); break;
+                default: break;
+            }
+            strcat(body, definition);
+
+            WriteNodeExpression(node, body, file, fragment);
+
+            // Write current node string to shader file (single use expressions are inlined into their consumer)
+            WriteNodeBody(node, body, file, fragment);
+        }
+    }
+}
+
+// Writes a node operation GLSL expression after its declaration
+void WriteNodeExpression(FNode node, char *body, FILE *file, bool fragment)
+{
+    if (((node->type < FNODE_MATRIX) && (node->type > FNODE_E)) || (node->type == FNODE_SAMPLER2D))
+    {
+        switch (node->type)
+        {
+            case FNODE_TIME:
+            {
+                if (fragment) strcat(body, "fragCurrentTime;\n");
+                else strcat(body, "vertCurrentTime;\n");
+            } break;
+            case FNODE_VERTEXPOSITION:
+            {
+                if (fragment) strcat(body, "fragPosition;\n");
+                else strcat(body, "vertexPosition;\n");
+            } break;
+            case FNODE_VERTEXNORMAL:
+            {
+                if (fragment) strcat(body, "fragNormal;\n");
+                else strcat(body, "vertexNormal;\n");
+            } break;
+            case FNODE_FRESNEL: strcat(body, "1.0 - dot(fragNormal, viewDirection);\n"); break;
+            case FNODE_VIEWDIRECTION: strcat(body, "viewDirection;\n"); break;
+            case FNODE_MVP: strcat(body, ((!fragment && instancing) ? "mvp*instanceTransform;\n" : "mvp;\n")); break;
+            case FNODE_SAMPLER2D:
+            {
+                char test[128] = { '\0' };
+
+                int indexA = GetNodeIndex(node->inputs[0]);
+                int indexB = GetNodeIndex(node->inputs[1]);
+                int unit = (int)nodes[indexA]->output.data[0].value;
+
+                // Samplers of the same texture unit read channels from a single shared fetch
+                CompileTextureFetch(node, unit, file, fragment);
+
+                int channel = (int)nodes[indexB]->output.data[0].value;
+
+                switch (channel)
+                {
+                    case 1: sprintf(test, "texel%i.rgb;\n", unit); break;
+                    case 2: sprintf(test, "texel%i.r;\n", unit); break;
+                    case 3: sprintf(test, "texel%i.g;\n", unit); break;
+                    case 4: sprintf(test, "texel%i.b;\n", unit); break;
+                    case 5: sprintf(test, "texel%i.a;\n", unit); break;
+                    default: sprintf(test, "texel%i;\n", unit); break;
+                }
+
+                // Full color and alpha channel samples discard transparent fragments (vertex shader can not discard)
+                if (fragment && (channel == 0)) sprintf(test + strlen(test), "    if (node_%02i.a == 0.0) discard;\n", node->id);
+                else if (fragment && (channel == 5)) sprintf(test + strlen(test), "    if (node_%02i == 0.0) discard;\n", node->id);
+
+                strcat(body, test);
+                break;
+            }
+            default: break;
+        }
+    }
+    else if ((node->type >= FNODE_ADD && node->type <= FNODE_DIVIDE) || node->type == FNODE_MULTIPLYMATRIX)
+    {
+        // Operate with each input node
+        for (int i = 0; i < node->inputsCount; i++)
+        {
+            char temp[32] = { '\0' };
+            if ((i+1) == node->inputsCount) sprintf(temp, "node_%02i;\n", node->inputs[i]);
+            else
+            {
+                int nextIndex = GetNodeIndex(node->inputs[i+1]);
+                if ((nodes[nextIndex]->output.dataCount - 1) == node->output.dataCount)
+                {
+                    switch (node->output.dataCount)
+                    {
+                        case 1: sprintf(temp, "vec2(node_%02i, 0.0);\n", node->inputs[i]);
+                        case 2: sprintf(temp, "vec3(node_%02i, 0.0);\n", node->inputs[i]);
+                        case 3: sprintf(temp, "vec4(node_%02i, 0.0);\n", node->inputs[i]);
+                        default: break;
+                    }
+                }
+                else sprintf(temp, "node_%02i", node->inputs[i]);
+                switch (node->type)
+                {
+                    case FNODE_ADD: strcat(temp, " + "); break;
+                    case FNODE_SUBTRACT: strcat(temp, " - "); break;
+                    case FNODE_MULTIPLYMATRIX:
+                    case FNODE_MULTIPLY: strcat(temp, "*"); break;
+                    case FNODE_DIVIDE: strcat(temp, "/"); break;
+                    default: break;
+                }
+            }
+
+            strcat(body, temp);
+        }
+    }
+    else if (node->type >= FNODE_APPEND)
+    {
+        char temp[512] = { '\0' };
+        switch (node->type)
+        {
+            case FNODE_APPEND:
+            {
+                switch (node->output.dataCount)
+                {
+                    case 2: strcat(temp, "vec2("); break;
+                    case 3: strcat(temp, "vec3("); break;
+                    case 4: strcat(temp, "vec4("); break;
+                    default: break;
+                }
+
+                for (int i = 0; i < node->inputsCount; i++)
+                {
+                    char append[32] = { '\0' };
+                    if ((i + 1) == node->inputsCount) sprintf(append, "node_%02i);\n", node->inputs[i]);
+                    else sprintf(append, "node_%02i, ", node->inputs[i]);
+                    
+                    strcat(temp, append);
+                }
+            } break;
+            case FNODE_ONEMINUS: sprintf(temp, "(1.0 - node_%02i);\n", node->inputs[0]); break;
+            case FNODE_ABS: sprintf(temp, "abs(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_COS: sprintf(temp, "cos(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_SIN: sprintf(temp, "sin(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_TAN: sprintf(temp, "tan(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_DEG2RAD: sprintf(temp, "node_%02i*(3.14159265358979323846/180.0);\n", node->inputs[0]); break;
+            case FNODE_RAD2DEG: sprintf(temp, "node_%02i*(180.0/3.14159265358979323846);\n", node->inputs[0]); break;
+            case FNODE_NORMALIZE: sprintf(temp, "normalize(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_NEGATE: sprintf(temp, "node_%02i*-1;\n", node->inputs[0]); break;
+            case FNODE_RECIPROCAL: sprintf(temp, "1.0/node_%02i;\n", node->inputs[0]); break;
+            case FNODE_SQRT: sprintf(temp, "sqrt(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_TRUNC: sprintf(temp, "trunc(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_ROUND: sprintf(temp, "round(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_VERTEXCOLOR:
+            {
+                int index = GetNodeIndex(node->inputs[0]);
+                switch ((int)nodes[index]->output.data[0].value)
+                {
+                    case 0: sprintf(temp, (fragment ? "fragColor;\n" : "vertexColor;\n")); break;
+                    case 1: sprintf(temp, (fragment ? "fragColor.rgb;\n" : "vertexColor.rgb;\n")); break;
+                    case 2: sprintf(temp, (fragment ? "fragColor.r;\n" : "vertexColor.r;\n")); break;
+                    case 3: sprintf(temp, (fragment ? "fragColor.g;\n" : "vertexColor.g;\n")); break;
+                    case 4: sprintf(temp, (fragment ? "fragColor.b;\n" : "vertexColor.b;\n")); break;
+                    case 5: sprintf(temp, (fragment ? "fragColor.a;\n" : "vertexColor.a;\n")); break;
+                    default: break;
+                }
+            } break;
+            case FNODE_CEIL: sprintf(temp, "ceil(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_CLAMP01: sprintf(temp, "clamp(node_%02i, 0.0, 1.0);\n", node->inputs[0]); break;
+            case FNODE_EXP2: sprintf(temp, "exp2(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_POWER: sprintf(temp, "pow(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1]); break;
+            case FNODE_STEP: sprintf(temp, "((node_%02i <= node_%02i) ? 1.0 : 0.0);\n", node->inputs[0], node->inputs[1]); break;
+            case FNODE_POSTERIZE: sprintf(temp, "floor(node_%02i*node_%02i)/node_%02i;\n", node->inputs[0], node->inputs[1], node->inputs[1]); break;
+            case FNODE_MAX: sprintf(temp, "max(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1], node->inputs[1]); break;
+            case FNODE_MIN: sprintf(temp, "min(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1], node->inputs[1]); break;
+            case FNODE_LERP: sprintf(temp, "mix(node_%02i, node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1], node->inputs[2]); break;
+            case FNODE_SMOOTHSTEP: sprintf(temp, "smoothstep(node_%02i, node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1], node->inputs[2]); break;
+            case FNODE_CROSSPRODUCT: sprintf(temp, "cross(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1]); break;
+            case FNODE_DESATURATE:
+            {
+                switch (node->output.dataCount)
+                {
+                    case 1: sprintf(temp, "mix(node_%02i, 0.3, node_%02i);\n", node->inputs[0], node->inputs[1]); break;
+                    case 2: sprintf(temp, "vec2(mix(node_%02i.x, vec2(0.3, 0.59), node_%02i));\n", node->inputs[0], node->inputs[1]); break;
+                    case 3: sprintf(temp, "vec3(mix(node_%02i.xyz, vec3(0.3, 0.59, 0.11), node_%02i));\n", node->inputs[0], node->inputs[1]); break;
+                    case 4: sprintf(temp, "vec4(mix(node_%02i.xyz, vec3(0.3, 0.59, 0.11), node_%02i), 1.0);\n", node->inputs[0], node->inputs[1]); break;
+                    default: break;
+                }
+            } break;
+            case FNODE_DISTANCE: sprintf(temp, "distance(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1]); break;
+            case FNODE_DOTPRODUCT: sprintf(temp, "dot(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1]); break;
+            case FNODE_LENGTH: sprintf(temp, "length(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_TRANSPOSE: sprintf(temp, "transpose(node_%02i);\n", node->inputs[0]); break;
+            case FNODE_PROJECTION:
+            {
+                switch (node->output.dataCount)
+                {
+                    case 2: sprintf(temp, "vec2(dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y);\n", 
+                    node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
+                    case 3: sprintf(temp, "vec3(dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.z);\n", 
+                    node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
+                    case 4: sprintf(temp, "vec4(dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.z, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.w);\n", 
+                    node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
+                    default: break;
+                }
+            }
+            case FNODE_REJECTION:
+            {
+                switch (node->output.dataCount)
+                {
+                    case 2: sprintf(temp, "vec2(node_%02i.x - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, node_%02i.y - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y);\n", 
+                    node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
+                    case 3: sprintf(temp, "vec3(node_%02i.x - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, node_%02i.y - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y, node_%02i.z - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.z);\n", 
+                    node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
+                    case 4: sprintf(temp, "vec4(node_%02i.x - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, node_%02i.y - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y, node_%02i.z - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.z, node_%02i.w - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.w);\n", 
+                    node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
+                    default: break;
+                }
+            } break;
+            case FNODE_HALFDIRECTION: sprintf(temp, "normalize(node_%02i + node_%02i);\n", node->inputs[0], node->inputs[1]); break;
+            case FNODE_LUT:
+            case FNODE_OPTIONAL: sprintf(temp, "node_%02i;\n", node->inputs[0]); break;
+            case FNODE_SAMPLERLOD:
+            case FNODE_SAMPLERBIAS:
+            case FNODE_SAMPLERGRAD: WriteSamplerLevelFetch(node, temp, fragment); break;
+            case FNODE_FUNCTION:
+            {
+                sprintf(temp, "fn_%s(", functions[node->function]->name);
+
+                for (int i = 0; i < functions[node->function]->inputsCount; i++)
+                {
+                    char argument[64] = { '\0' };
+                    WriteFunctionArgument(node, i, argument);
+                    strcat(temp, argument);
+                    strcat(temp, (((i + 1) == functions[node->function]->inputsCount) ? ");\n" : ", "));
+                }
+            } break;
+            default: break;
+        }
+
+        strcat(body, temp);
+    }
+}
+
+// Writes a function node input converted to its library function input type (missing values are zero as in CPU calculations)
+void WriteFunctionArgument(FNode node, int input, char *text)
+{
+    int count = functions[node->function]->nodes[input]->output.dataCount;
+    const char *type = GetDataTypeName(count);
+
+    if (input < node->inputsCount)
+    {
+        FNode argument = nodes[GetNodeIndex(node->inputs[input])];
+        int argumentCount = argument->output.dataCount;
+
+        if (argumentCount == count) sprintf(text, "node_%02i", argument->id);
+        else if ((argumentCount == 16) || (count == 16)) sprintf(text, "%s(0.0)", type);
+        else if (argumentCount > count) sprintf(text, "%s(node_%02i)", type, argument->id);
+        else
+        {
+            sprintf(text, "%s(node_%02i", type, argument->id);
+            for (int i = argumentCount; i < count; i++) strcat(text, ", 0.0");
+            strcat(text, ")");
+        }
+    }
+    else sprintf(text, "%s(0.0)", type);
+}
+
+// Compiles a texture unit fetch shared by all its sampler nodes
+void CompileTextureFetch(FNode node, int unit, FILE *file, bool fragment)
+{
+    if (!fetchedUnits[unit])
+    {
+        fetchedUnits[unit] = true;
+
+        char coordinates[256] = { '\0' };
+        GetPackedCoordinates(unit, (fragment ? "fragTexCoord" : "vertexTexCoord"), false, coordinates);
+
+        // Vertex shader has no implicit derivatives, so it samples base level of texture coordinates attribute
+        if (fragment) fprintf(file, "    %svec4 texel%i = %s(texture%i, %s);\n", GetPrecisionQualifier(node, fragment), unit, ((version != GLSL_100) ? "texture" : "texture2D"), GetPackedUnit(unit), coordinates);
+        else fprintf(file, "    vec4 texel%i = %s(texture%i, %s, 0.0);\n", unit, ((version != GLSL_100) ? "textureLod" : "texture2DLod"), GetPackedUnit(unit), coordinates);
+    }
+}
+
+// Declares a texture unit sampler uniform once per shader file (packed units share their atlas or texture array sampler)
+void DeclareSampler(FILE *file, int unit)
+{
+    int binding = GetPackedUnit(unit);
+
+    if (!usedUnits[binding])
+    {
+        // GLSL ES 300 has no default precision for texture array samplers
+        bool array = (packedUnits[unit] && (packedMode == PACKING_ARRAY));
+
+        WriteUniformLayout(file, binding, true);
+        fprintf(file, "uniform %s%s texture%i;\n", ((array && (version == GLSL_300ES)) ? "lowp " : ""), (array ? "sampler2DArray" : "sampler2D"), binding);
+        usedUnits[binding] = true;
+    }
+}
+
+// Returns the texture unit a texture unit is sampled from (atlas or texture array unit if it is packed)
+int GetPackedUnit(int unit)
+{
+    return (packedUnits[unit] ? packUnit : unit);
+}
+
+// Returns a texture unit coordinates (or gradient) expression remapped to its atlas rectangle or texture array layer
+void GetPackedCoordinates(int unit, const char *coordinates, bool gradient, char *text)
+{
+    if (packedUnits[unit] && (packedMode == PACKING_ATLAS))
+    {
+        Rectangle rec = packRects[unit];
+        char values[8][32] = { 0 };
+
+        FormatFloat((float)rec.width/packTexture.width, values[0]);
+        FormatFloat((float)rec.height/packTexture.height, values[1]);
+        FormatFloat((float)rec.x/packTexture.width, values[2]);
+        FormatFloat((float)rec.y/packTexture.height, values[3]);
+        FormatFloat(0.5f/rec.width, values[4]);
+        FormatFloat(0.5f/rec.height, values[5]);
+        FormatFloat(1.0f - 0.5f/rec.width, values[6]);
+        FormatFloat(1.0f - 0.5f/rec.height, values[7]);
+
+        // Gradients are only scaled, coordinates are clamped half a texel inside the rectangle so bilinear filtering never reads its neighbours
+        if (gradient) sprintf(text, "%s*vec2(%s, %s)", coordinates, values[0], values[1]);
+        else sprintf(text, "clamp(%s, vec2(%s, %s), vec2(%s, %s))*vec2(%s, %s) + vec2(%s, %s)", coordinates, values[4], values[5], values[6], values[7], values[0], values[1], values[2], values[3]);
+    }
+    else if (packedUnits[unit] && !gradient) sprintf(text, "vec3(%s, %i.0)", coordinates, packLayers[unit]);
+    else strcpy(text, coordinates);
+}
+
+// Writes an explicit level of detail, bias or gradients sampler node texture fetch expression
+void WriteSamplerLevelFetch(FNode node, char *text, bool fragment)
+{
+    const char *swizzles[6] = { "", ".rgb", ".r", ".g", ".b", ".a" };
+    char coordinates[256] = { '\0' };
+    char level[16] = "0.0";
+    char gradients[2][64] = { "vec2(0.0)", "vec2(0.0)" };
+
+    int channel = (int)nodes[GetNodeIndex(node->inputs[1])]->output.data[0].value;
+    if ((channel < 0) || (channel > 5)) channel = 0;
+
+    // Packed textures sample their atlas rectangle or texture array layer
+    int unit = (int)nodes[GetNodeIndex(node->inputs[0])]->output.data[0].value;
+    GetPackedCoordinates(unit, (fragment ? "fragTexCoord" : "vertexTexCoord"), false, coordinates);
+
+    // Missing level of detail, bias and gradients inputs sample the base level
+    if (node->inputsCount > 2) sprintf(level, "node_%02i", node->inputs[2]);
+    for (int i = 2; i < node->inputsCount; i++)
+    {
+        char gradient[16] = { '\0' };
+        sprintf(gradient, "node_%02i", node->inputs[i]);
+        GetPackedCoordinates(unit, gradient, true, gradients[i - 2]);
+    }
+
+    unit = GetPackedUnit(unit);
+
+    switch (node->type)
+    {
+        case FNODE_SAMPLERLOD:
+        {
+            // GLSL 100 fragment shaders only have explicit levels with GL_EXT_shader_texture_lod (TEXTURE_LOD macro in shader header)
+            if (version != GLSL_100) sprintf(text, "textureLod(texture%i, %s, %s)%s;\n", unit, coordinates, level, swizzles[channel]);
+            else sprintf(text, "%s(texture%i, %s, %s)%s;\n", (fragment ? "TEXTURE_LOD" : "texture2DLod"), unit, coordinates, level, swizzles[channel]);
+        } break;
+        case FNODE_SAMPLERBIAS:
+        {
+            // Vertex shader has no implicit level of detail to bias, so bias is used as level
+            if (fragment) sprintf(text, "%s(texture%i, %s, %s)%s;\n", ((version != GLSL_100) ? "texture" : "texture2D"), unit, coordinates, level, swizzles[channel]);
+            else sprintf(text, "%s(texture%i, %s, %s)%s;\n", ((version != GLSL_100) ? "textureLod" : "texture2DLod"), unit, coordinates, level, swizzles[channel]);
+        } break;
+        case FNODE_SAMPLERGRAD:
+        {
+            // GLSL 100 vertex shaders have no gradients fetch, so they sample base level
+            if (version != GLSL_100) sprintf(text, "textureGrad(texture%i, %s, %s, %s)%s;\n", unit, coordinates, gradients[0], gradients[1], swizzles[channel]);
+            else if (fragment) sprintf(text, "TEXTURE_GRAD(texture%i, %s, %s, %s)%s;\n", unit, coordinates, gradients[0], gradients[1], swizzles[channel]);
+            else sprintf(text, "texture2DLod(texture%i, %s, 0.0)%s;\n", unit, coordinates, swizzles[channel]);
+        } break;
+        default: break;
+    }
+}
+
+// Compiles a lookup table node as a single texture fetch of its baked input subgraph
+void CompileLutNode(FNode node, FILE *file, bool fragment)
+{
+    Vector4 domain = lutDomains[node->id];
+    char coordinates[128] = { '\0' };
+    char body[256] = { '\0' };
+    char scaleText[32] = { '\0' };
+    char offsetText[32] = { '\0' };
+
+    // Map domain range to texels centers so bilinear filtering interpolates between baked samples
+    float scale = (domain.z - 1.0f)/(domain.z*(domain.y - domain.x));
+    float offset = 0.5f/domain.z - domain.x*scale;
+    FormatFloat(scale, scaleText);
+    FormatFloat(offset, offsetText);
+
+    for (int i = 1; i < node->inputsCount; i += 2)
+    {
+        int index = GetNodeIndex(node->inputs[i]);
+        if (nodes[index]->type > FNODE_VECTOR4 || ((nodes[index]->type < FNODE_MATRIX) && (nodes[index]->type > FNODE_E))) CompileNode(nodes[index], file, fragment);
+    }
+
+    if (node->inputsCount > 3) sprintf(coordinates, "node_%02i*%s + %s, node_%02i*%s + %s", node->inputs[1], scaleText, offsetText, node->inputs[3], scaleText, offsetText);
+    else sprintf(coordinates, "node_%02i*%s + %s, 0.5", node->inputs[1], scaleText, offsetText);
+
+    // Vertex shader has no derivatives to select a mipmap so base level is sampled explicitly
+    if (fragment) sprintf(body, "    %sfloat node_%02i = %s(texture%i, vec2(%s)).r;\n", GetPrecisionQualifier(node, fragment), node->id, ((version != GLSL_100) ? "texture" : "texture2D"), (int)domain.w, coordinates);
+    else sprintf(body, "    %sfloat node_%02i = %s(texture%i, vec2(%s), 0.0).r;\n", GetPrecisionQualifier(node, fragment), node->id, ((version != GLSL_100) ? "textureLod" : "texture2DLod"), (int)domain.w, coordinates);
+
+    AddNodeCost(node, GetNodeCost(node), fragment);
+    WriteNodeBody(node, body, file, fragment);
+}
+
+// Check if a lookup table node input subgraph only depends on its coordinates and constant values
+bool IsLutNodeBakeable(FNode node)
+{
+    bool bakeable = ((node->type == FNODE_LUT) && (node->inputsCount >= 3));
+
+    // Value, coordinates and domain inputs expect single values except domain which is a vector 4
+    for (int i = 0; (i < node->inputsCount) && bakeable; i++)
+    {
+        int index = GetNodeIndex(node->inputs[i]);
+        bakeable = (nodes[index]->output.dataCount == ((i == 2) ? 4 : 1));
+    }
+
+    if (bakeable) bakeable = IsLutInputStatic(nodes[GetNodeIndex(node->inputs[0])], node);
+
+    return bakeable;
+}
+
+// Check if a lookup table input subgraph node only depends on the table coordinates and constant values
+bool IsLutInputStatic(FNode node, FNode lut)
+{
+    bool isStatic = true;
+
+    if ((node->id != lut->inputs[1]) && ((lut->inputsCount < 4) || (node->id != lut->inputs[3])))
+    {
+        switch (node->type)
+        {
+            case FNODE_PI:
+            case FNODE_E: break;
+            case FNODE_MATRIX:
+            case FNODE_VALUE:
+            case FNODE_VECTOR2:
+            case FNODE_VECTOR3:
+            case FNODE_VECTOR4: isStatic = (!node->property || node->staticProperty); break;
+            case FNODE_TIME:
+            case FNODE_VERTEXPOSITION:
+            case FNODE_VERTEXNORMAL:
+            case FNODE_FRESNEL:
+            case FNODE_VIEWDIRECTION:
+            case FNODE_MVP:
+            case FNODE_VERTEXCOLOR:
+            case FNODE_SAMPLER2D:
+            case FNODE_VERTEX:
+            case FNODE_FRAGMENT:
+            case FNODE_LUT:
+            case FNODE_SAMPLERLOD:
+            case FNODE_SAMPLERBIAS:
+            case FNODE_SAMPLERGRAD: isStatic = false; break;
+            default:
+            {
+                isStatic = (node->inputsCount > 0);
+                for (int i = 0; (i < node->inputsCount) && isStatic; i++) isStatic = IsLutInputStatic(nodes[GetNodeIndex(node->inputs[i])], lut);
+            } break;
+        }
+    }
+
+    return isStatic;
+}
+
+// Returns a lookup table node domain (min, max, resolution, unit) clamped to valid values (negative resolution if no texture unit is free)
+Vector4 GetLutDomain(FNode node)
+{
+    FNode input = nodes[GetNodeIndex(node->inputs[2])];
+    Vector4 domain = { input->output.data[0].value, input->output.data[1].value, (float)(int)input->output.data[2].value, (float)(int)input->output.data[3].value };
+    int maxResolution = ((node->inputsCount > 3) ? MAX_LUT_RESOLUTION_2D : MAX_LUT_RESOLUTION);
+
+    if (domain.y == domain.x) domain.y = domain.x + 1.0f;
+    if (domain.z < 2) domain.z = 2;
+    else if (domain.z > maxResolution) domain.z = maxResolution;
+    if (domain.w < 0) domain.w = 0;
+    else if (domain.w > (MAX_TEXTURES - 1)) domain.w = MAX_TEXTURES - 1;
+
+    int unit = GetLutUnit(node, (int)domain.w);
+
+    if (unit == -1)
+    {
+        TraceLogFNode(false, "no free texture unit to bake node %i lookup table, its input subgraph is compiled instead", node->id);
+        domain.z = -1;
+    }
+    else if (unit != (int)domain.w)
+    {
+        TraceLogFNode(false, "texture unit %i is already used, node %i lookup table is baked into texture unit %i", (int)domain.w, node->id, unit);
+        domain.w = unit;
+    }
+
+    return domain;
+}
+
+// Returns the first free texture unit from a requested unit to bake a lookup table node (-1 if all units are used)
+int GetLutUnit(FNode node, int unit)
+{
+    int free = -1;
+
+    for (int i = 0; (i < MAX_TEXTURES) && (free == -1); i++)
+    {
+        int candidate = (unit + i) % MAX_TEXTURES;
+
+        // Loaded and dropped textures are kept, textures baked by other lookup tables only if they are still compiled
+        bool used = ((textures[candidate].id != 0) && (lutOwners[candidate] == -1));
+
+        for (int k = 0; (k < nodesCount) && !used; k++)
+        {
+            FNode other = nodes[k];
+
+            if ((other->type == FNODE_LUT) && (other->id != node->id)) used = ((lutDomains[other->id].z > 0) && ((int)lutDomains[other->id].w == candidate));
+            else if (((other->type == FNODE_SAMPLER2D) || (other->type >= FNODE_SAMPLERLOD)) && (other->inputsCount > 0) && reachableNodes[other->id])
+            {
+                used = ((int)nodes[GetNodeIndex(other->inputs[0])]->output.data[0].value == candidate);
+            }
+        }
+
+        if (!used) free = candidate;
+    }
+
+    return free;
+}
+
+// Adds a lookup table input subgraph node indices in evaluation order and returns their count
+int GetLutSubgraph(FNode node, FNode lut, int *order, int count, bool *visited)
+{
+    if (!visited[node->id] && (node->id != lut->inputs[1]) && ((lut->inputsCount < 4) || (node->id != lut->inputs[3])))
+    {
+        visited[node->id] = true;
+
+        for (int i = 0; i < node->inputsCount; i++) count = GetLutSubgraph(nodes[GetNodeIndex(node->inputs[i])], lut, order, count, visited);
+
+        order[count] = GetNodeIndex(node->id);
+        count++;
+    }
+
+    return count;
+}
+
+// Returns a lookup table node input subgraph value calculated in CPU at specific coordinates
+float SampleLutNode(FNode node, int *order, int count, float x, float y)
+{
+    nodes[GetNodeIndex(node->inputs[1])]->output.data[0].value = x;
+    if (node->inputsCount > 3) nodes[GetNodeIndex(node->inputs[3])]->output.data[0].value = y;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (nodes[order[i]]->type > FNODE_VECTOR4) CalculateNodeValues(nodes[order[i]]);
+    }
+
+    return nodes[GetNodeIndex(node->inputs[0])]->output.data[0].value;
+}
+
+// Bakes a lookup table node input subgraph into a float texture if it changed since last bake
+void BakeLutNode(FNode node)
+{
+    int order[MAX_NODES] = { 0 };
+    bool visited[MAX_NODES] = { false };
+    int count = GetLutSubgraph(nodes[GetNodeIndex(node->inputs[0])], node, order, 0, visited);
+    Vector4 domain = lutDomains[node->id];
+    float bounds[4] = { domain.x, domain.y, domain.z, domain.w };
+    unsigned int hash = 2166136261u;
+
+    // Input subgraph is identified by its domain, operations, links and constant values
+    for (int i = 0; i < 4; i++)
+    {
+        unsigned int bits = 0;
+        memcpy(&bits, &bounds[i], sizeof(float));
+        hash = (hash ^ bits)*16777619u;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        FNode input = nodes[order[i]];
+
+        hash = (hash ^ (unsigned int)(input->type + 2))*16777619u;
+        for (int k = 0; k < input->inputsCount; k++) hash = (hash ^ (unsigned int)input->inputs[k])*16777619u;
+
+        for (int k = 0; (k < input->output.dataCount) && (input->type <= FNODE_VECTOR4); k++)
+        {
+            unsigned int bits = 0;
+            memcpy(&bits, &input->output.data[k].value, sizeof(float));
+            hash = (hash ^ bits)*16777619u;
+        }
+    }
+
+    // Texture unit texture is replaced by dropped textures or another lookup table
+    if ((hash != lutHashes[node->id]) || (lutOwners[(int)domain.w] != node->id))
+    {
+        lutHashes[node->id] = hash;
+
+        int width = (int)domain.z;
+        int height = ((node->inputsCount > 3) ? width : 1);
+        float step = (domain.y - domain.x)/(width - 1);
+        float x = nodes[GetNodeIndex(node->inputs[1])]->output.data[0].value;
+        float y = ((node->inputsCount > 3) ? nodes[GetNodeIndex(node->inputs[3])]->output.data[0].value : 0.0f);
+        float maxError = 0.0f;
+        float *data = (float *)FNODE_MALLOC(width*height*sizeof(float));
+
+        for (int j = 0; j < height; j++)
+        {
+            for (int i = 0; i < width; i++) data[j*width + i] = SampleLutNode(node, order, count, domain.x + step*i, domain.x + step*j);
+        }
+
+        // Measure texture linear interpolation error against analytic values between texels centers
+        int samplesX = (width - 1)*LUT_ERROR_SAMPLES + 1;
+        int samplesY = ((height > 1) ? (height - 1)*LUT_ERROR_SAMPLES + 1 : 1);
+
+        for (int j = 0; j < samplesY; j++)
+        {
+            for (int i = 0; i < samplesX; i++)
+            {
+                float u = (float)i/LUT_ERROR_SAMPLES;
+                float v = (float)j/LUT_ERROR_SAMPLES;
+                int u0 = ((int)u < (width - 1)) ? (int)u : (width - 2);
+                int v0 = ((height > 1) ? (((int)v < (height - 1)) ? (int)v : (height - 2)) : 0);
+                int v1 = ((height > 1) ? v0 + 1 : 0);
+                float fu = u - u0;
+                float fv = v - v0;
+
+                float bottom = data[v0*width + u0] + (data[v0*width + u0 + 1] - data[v0*width + u0])*fu;
+                float top = data[v1*width + u0] + (data[v1*width + u0 + 1] - data[v1*width + u0])*fu;
+                float error = fabs(bottom + (top - bottom)*fv - SampleLutNode(node, order, count, domain.x + step*u, domain.x + step*v));
+
+                if (error > maxError) maxError = error;
+            }
+        }
+
+        // Restore coordinates and input subgraph values
+        SampleLutNode(node, order, count, x, y);
+
+        Image image = LoadImagePro(data, width, height, UNCOMPRESSED_R32);
+        Texture2D texture = LoadTextureFromImage(image);
+        SetTextureFilter(texture, FILTER_BILINEAR);
+        SetTextureWrap(texture, WRAP_CLAMP);
+        UnloadImage(image);
+        FNODE_FREE(data);
+
+        SetTextureUnit((int)domain.w, texture);
+        lutOwners[(int)domain.w] = node->id;
+
+        TraceLogFNode(false, "node %i baked into %ix%i lookup table in texture unit %i (max error: %f)", node->id, width, height, (int)domain.w, maxError);
+    }
+}
+
+// Bakes all current shader compiled lookup table nodes
+void BakeLutNodes()
+{
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if ((lutDomains[nodes[i]->id].z > 0) && IsLutNodeBakeable(nodes[i])) BakeLutNode(nodes[i]);
+    }
+}
+
+// Sets a shader texture unit texture unloading its previous texture
+void SetTextureUnit(int unit, Texture2D texture)
+{
+    if ((textures[unit].id != 0) && (textures[unit].id != texture.id)) UnloadTexture(textures[unit]);
+    textures[unit] = texture;
+    lutOwners[unit] = -1;
+
+    // Packed texture unit keeps its atlas or texture array in visor model material
+    if (unit != packUnit) SetModelMap(unit, textures[unit]);
+}
+
+// Sets visor model material map of a texture unit
+void SetModelMap(int unit, Texture2D texture)
+{
+    switch (unit)
+    {
+        case 0: model.material.maps[MAP_ALBEDO].texture = texture; break;
+        case 1: model.material.maps[MAP_NORMAL].texture = texture; break;
+        case 2: model.material.maps[MAP_SPECULAR].texture = texture; break;
+        default: break;
+    }
+}
+
+// Packs dropped textures into an atlas or a texture array depending on texture packing setting and shader version
+void PackTextures()
+{
+    TexturePacking mode = texturePacking;
+
+    // Texture arrays are not supported by GLSL 100 shader version
+    if ((mode == PACKING_ARRAY) && (version == GLSL_100))
+    {
+        TraceLogFNode(false, "texture arrays are not supported by GLSL 100 shader version, dropped textures packed into an atlas");
+        mode = PACKING_ATLAS;
+    }
+
+    if (packChanged || (mode != packedMode))
+    {
+        // Restore previous packed texture unit texture
+        if (packTexture.id != 0)
+        {
+            UnloadTexture(packTexture);
+            packTexture = (Texture2D){ 0 };
+            SetModelMap(packUnit, textures[packUnit]);
+        }
+
+        int units[MAX_TEXTURES] = { 0 };
+        int count = 0;
+
+        for (int i = 0; i < MAX_TEXTURES; i++)
+        {
+            packedUnits[i] = false;
+            if ((texturePaths[i][0] != '\0') && (textures[i].id != 0)) units[count++] = i;
+        }
+
+        packUnit = -1;
+        packedMode = mode;
+        packChanged = false;
+
+        // A single dropped texture has no bindings to save
+        if ((mode != PACKING_NONE) && (count > 1))
+        {
+            packTexture = ((mode == PACKING_ATLAS) ? LoadTextureAtlas(units, count) : LoadTextureArray(units, count));
+
+            if (packTexture.id != 0)
+            {
+                packUnit = units[0];
+                for (int i = 0; i < count; i++) packedUnits[units[i]] = true;
+
+                // Texture arrays can't be bound by model material maps, they are bound before drawing visor model
+                SetModelMap(packUnit, ((mode == PACKING_ATLAS) ? packTexture : (Texture2D){ 0 }));
+
+                TraceLogFNode(false, "%i dropped textures packed into a %ix%i %s in texture unit %i", count, packTexture.width, packTexture.height, ((mode == PACKING_ATLAS) ? "atlas" : "texture array"), packUnit);
+            }
+        }
+    }
+}
+
+// Loads dropped textures into an atlas shelf packed by height (empty texture if they don't fit in max atlas size)
+Texture2D LoadTextureAtlas(int *units, int count)
+{
+    Texture2D atlas = { 0 };
+    int order[MAX_TEXTURES] = { 0 };
+    int size = 1;
+
+    // Taller textures are packed first so each shelf wastes less height
+    for (int i = 0; i < count; i++)
+    {
+        int k = i;
+        while ((k > 0) && (textures[units[i]].height > textures[order[k - 1]].height))
+        {
+            order[k] = order[k - 1];
+            k--;
+        }
+
+        order[k] = units[i];
+        while (size < (textures[units[i]].width + PACK_PADDING*2)) size *= 2;
+    }
+
+    // Power of two atlas size grows until all shelves fit
+    bool packed = false;
+    while (!packed && (size <= MAX_PACK_SIZE))
+    {
+        int x = 0;
+        int y = 0;
+        int shelf = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            int width = textures[order[i]].width + PACK_PADDING*2;
+            int height = textures[order[i]].height + PACK_PADDING*2;
+
+            if ((x + width) > size)
+            {
+                x = 0;
+                y += shelf;
+                shelf = 0;
+            }
+
+            packRects[order[i]] = (Rectangle){ x + PACK_PADDING, y + PACK_PADDING, textures[order[i]].width, textures[order[i]].height };
+            packLayers[order[i]] = i;
+            x += width;
+            if (height > shelf) shelf = height;
+        }
+
+        packed = ((y + shelf) <= size);
+        if (!packed) size *= 2;
+    }
+
+    if (packed)
+    {
+        Color *pixels = (Color *)FNODE_MALLOC(size*size*sizeof(Color));
+        memset(pixels, 0, size*size*sizeof(Color));
+
+        for (int i = 0; i < count; i++)
+        {
+            Rectangle rec = packRects[units[i]];
+            Image image = LoadImage(texturePaths[units[i]]);
+            Color *data = GetImageData(image);
+
+            if ((data != NULL) && (image.width > 0) && (image.height > 0))
+            {
+                // Border texels are replicated into padding so bilinear filtering doesn't blend neighbour textures
+                for (int y = -PACK_PADDING; y < (rec.height + PACK_PADDING); y++)
+                {
+                    for (int x = -PACK_PADDING; x < (rec.width + PACK_PADDING); x++)
+                    {
+                        int u = FClamp(x, 0, image.width - 1);
+                        int v = FClamp(y, 0, image.height - 1);
+                        pixels[((int)rec.y + y)*size + (int)rec.x + x] = data[v*image.width + u];
+                    }
+                }
+            }
+
+            free(data);
+            UnloadImage(image);
+        }
+
+        Image image = LoadImageEx(pixels, size, size);
+        atlas = LoadTextureFromImage(image);
+        SetTextureFilter(atlas, FILTER_BILINEAR);
+        SetTextureWrap(atlas, WRAP_CLAMP);
+        UnloadImage(image);
+        FNODE_FREE(pixels);
+    }
+    else TraceLogFNode(false, "dropped textures don't fit in a %ix%i atlas, textures are not packed", MAX_PACK_SIZE, MAX_PACK_SIZE);
+
+    return atlas;
+}
+
+// Loads dropped textures into a texture array resized to the largest texture size
+Texture2D LoadTextureArray(int *units, int count)
+{
+    Texture2D array = { 0 };
+    int width = 0;
+    int height = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (textures[units[i]].width > width) width = textures[units[i]].width;
+        if (textures[units[i]].height > height) height = textures[units[i]].height;
+    }
+
+    glGenTextures(1, &array.id);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, array.id);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, count, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+    for (int i = 0; i < count; i++)
+    {
+        packRects[units[i]] = (Rectangle){ 0, 0, width, height };
+        packLayers[units[i]] = i;
+
+        Image image = LoadImage(texturePaths[units[i]]);
+        if ((image.width > 0) && ((image.width != width) || (image.height != height))) ImageResize(&image, width, height);
+
+        Color *data = GetImageData(image);
+        if ((data != NULL) && (image.width == width) && (image.height == height)) glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, data);
+
+        free(data);
+        UnloadImage(image);
+    }
+
+    // Texture array layers keep texture coordinates wrapping unlike atlas rectangles
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    array.width = width;
+    array.height = height;
+    array.mipmaps = 1;
+    array.format = UNCOMPRESSED_R8G8B8A8;
+
+    return array;
+}
+
+// Saves packed textures layout alongside shader data file (mode, size and unit, then each texture unit layer, atlas rectangle and file path)
+void SavePackLayout()
+{
+    remove(PACK_PATH);
+
+    if (packUnit != -1)
+    {
+        FILE *file = fopen(PACK_PATH, "w");
+        if (file != NULL)
+        {
+            fprintf(file, "%s %i %i %i\n", ((packedMode == PACKING_ATLAS) ? "atlas" : "array"), packTexture.width, packTexture.height, packUnit);
+
+            for (int i = 0; i < MAX_TEXTURES; i++)
+            {
+                if (packedUnits[i]) fprintf(file, "%i %i %i %i %i %i %s\n", i, packLayers[i], (int)packRects[i].x, (int)packRects[i].y, (int)packRects[i].width, (int)packRects[i].height, texturePaths[i]);
+            }
+
+            fclose(file);
+        }
+        else TraceLogFNode(false, "error when trying to open and write in pack layout file");
+    }
+}
+
+// Loads dropped textures and texture packing setting from the pack layout file saved alongside a shader data file
+void LoadPackLayout(const char *path)
+{
+    char packPath[256] = { '\0' };
+    strncpy(packPath, path, 240);
+
+    char *extension = strrchr(packPath, '.');
+    if ((extension != NULL) && (strchr(extension, '/') == NULL)) *extension = '\0';
+    strcat(packPath, ".pack");
+
+    FILE *file = fopen(packPath, "r");
+    if (file != NULL)
+    {
+        char mode[16] = { '\0' };
+        int size[2] = { 0, 0 };
+        int unit = -1;
+
+        if (fscanf(file, "%15s %i %i %i\n", mode, &size[0], &size[1], &unit) == 4)
+        {
+            // Packing setting passed as command line argument is kept
+            if (texturePacking == PACKING_NONE) texturePacking = ((strcmp(mode, "array") == 0) ? PACKING_ARRAY : PACKING_ATLAS);
+
+            int layer = 0;
+            int rec[4] = { 0, 0, 0, 0 };
+            char texturePath[256] = { '\0' };
+
+            while (fscanf(file, "%i %i %i %i %i %i %255[^\n]\n", &unit, &layer, &rec[0], &rec[1], &rec[2], &rec[3], texturePath) == 7)
+            {
+                Texture2D texture = (((unit >= 0) && (unit < MAX_TEXTURES)) ? LoadTexture(texturePath) : (Texture2D){ 0 });
+
+                if (texture.id != 0)
+                {
+                    SetTextureUnit(unit, texture);
+                    strcpy(texturePaths[unit], texturePath);
+                    packChanged = true;
+                }
+                else TraceLogFNode(false, "error when trying to load packed texture %s", texturePath);
+            }
+        }
+
+        fclose(file);
+    }
+}
+
+// Binds packed texture array to its texture unit before drawing visor model
+void BindPackTexture()
+{
+    SetShaderValuei(shader, packUniform, &packUnit, 1);
+    glActiveTexture(GL_TEXTURE0 + packUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, packTexture.id);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+// Check if a node is compiled as a constant value which can not be edited from shader uniforms
+bool IsNodeConstant(FNode node)
+{
+    bool constant = ((node->type == FNODE_PI) || (node->type == FNODE_E) || node->staticProperty || foldedNodes[node->id]);
+
+    if (compileMode == COMPILE_SHIP)
+    {
+        if (node->type == FNODE_MATRIX) constant = true;
+        else if ((node->type >= FNODE_VALUE) && (node->type <= FNODE_VECTOR4)) constant = (!node->property || node->staticProperty);
+    }
+
+    return constant;
+}
+
+// Check if all components of a constant node are equal to a specific value
+bool IsConstantEqual(FNode node, float value)
+{
+    bool equal = (IsNodeConstant(node) && (node->output.dataCount <= 4));
+
+    for (int i = 0; (i < node->output.dataCount) && equal; i++) equal = (node->output.data[i].value == value);
+
+    return equal;
+}
+
+// Check if a node output values are known to be in 0 to 1 range
+bool IsNodeNormalized(FNode node)
+{
+    bool normalized = false;
+
+    switch (node->type)
+    {
+        case FNODE_SAMPLER2D:
+        case FNODE_SAMPLERLOD:
+        case FNODE_SAMPLERBIAS:
+        case FNODE_SAMPLERGRAD:
+        case FNODE_VERTEXCOLOR:
+        case FNODE_CLAMP01:
+        case FNODE_STEP:
+        case FNODE_SMOOTHSTEP: normalized = true; break;
+        case FNODE_ONEMINUS:
+        case FNODE_MULTIPLY:
+        case FNODE_MAX:
+        case FNODE_MIN:
+        case FNODE_LERP:
+        {
+            normalized = (node->inputsCount > 0);
+            for (int i = 0; (i < node->inputsCount) && normalized; i++) normalized = IsNodeNormalized(nodes[GetNodeIndex(node->inputs[i])]);
+        } break;
+        default:
+        {
+            normalized = (IsNodeConstant(node) && (node->output.dataCount <= 4));
+            for (int i = 0; (i < node->output.dataCount) && normalized; i++) normalized = ((node->output.data[i].value >= 0.0f) && (node->output.data[i].value <= 1.0f));
+        } break;
+    }
+
+    return normalized;
+}
+
+// Writes shortest GLSL float literal which reads back the same value
+void FormatFloat(float value, char *text)
+{
+    // Nine significant digits round trip any float, integral values need a decimal point to be float literals
+    sprintf(text, "%.9g", value);
+    if (strpbrk(text, ".eni") == NULL) strcat(text, ".0");
+}
+
+// Writes GLSL literal of a constant node values multiplied by a scale (or their reciprocal)
+void FormatConstant(FNode node, float scale, bool reciprocal, char *text)
+{
+    char value[32] = { '\0' };
+
+    if (node->output.dataCount > 1) sprintf(text, "%s(", GetDataTypeName(node->output.dataCount));
+    else text[0] = '\0';
 
-        // Vertex shader definition to embed, no external file required
-        switch (version)
+    for (int i = 0; i < node->output.dataCount; i++)
+    {
+        FormatFloat((reciprocal ? 1.0f/node->output.data[i].value : node->output.data[i].value)*scale, value);
+        strcat(text, value);
+        if ((i + 1) < node->output.dataCount) strcat(text, ", ");
+    }
+
+    if (node->output.dataCount > 1) strcat(text, ")");
+}
+
+// Returns the number of references to a node from other nodes inputs
+int GetNodeConsumers(FNode node)
+{
+    int consumers = 0;
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        for (int k = 0; (k < nodes[i]->inputsCount) && reachableNodes[nodes[i]->id]; k++)
         {
-            case GLSL_330:
-            {
-                const char vHeader[] = "#version 330\n\n";
-                fprintf(vertexFile, vHeader);
-            } break;
-            case GLSL_100:
-            {
-                const char vHeader[] = "#version 100\n\n";
-                fprintf(vertexFile, vHeader);
-            } break;
-            default: break;
+            if (nodes[i]->inputs[k] == node->id) consumers++;
         }
+    }
 
-        switch (version)
+    return consumers;
+}
+
+// Rewrites a node operation as a cheaper equivalent expression and returns its referenced nodes and cost
+bool SimplifyNode(FNode node, char *expression, int *operands, ShaderCost *cost)
+{
+    bool simplified = false;
+    bool uniformTypes = (node->inputsCount > 0);
+    const char *rewrite = NULL;
+    FNode inputs[MAX_INPUTS] = { NULL, NULL, NULL, NULL };
+    int count = node->output.dataCount;
+
+    // Only operations without mixed vector sizes are rewritten (matrix operations are kept)
+    for (int i = 0; i < node->inputsCount; i++)
+    {
+        inputs[i] = nodes[GetNodeIndex(node->inputs[i])];
+        uniformTypes = (uniformTypes && ((inputs[i]->output.dataCount == 1) || (inputs[i]->output.dataCount == count)) && (inputs[i]->output.dataCount <= 4));
+    }
+
+    *cost = (ShaderCost){ 0 };
+
+    if (uniformTypes && (count <= 4))
+    {
+        switch (node->type)
         {
-            case GLSL_330:
+            case FNODE_POWER:
             {
-                const char vIn[] = 
-                "in vec3 vertexPosition;\n"
-                "in vec3 vertexNormal;\n"
-                "in vec2 vertexTexCoord;\n"
-                "in vec4 vertexColor;\n\n";
-                fprintf(vertexFile, vIn);
-
-                const char vOut[] = 
-                "out vec3 fragPosition;\n"
-                "out vec3 fragNormal;\n"
-                "out vec2 fragTexCoord;\n"
-                "out vec4 fragColor;\n\n";
-                fprintf(vertexFile, vOut);
+                if ((inputs[1]->output.dataCount == 1) && IsNodeConstant(inputs[1]) && (inputs[0]->output.dataCount == count))
+                {
+                    float exponent = inputs[1]->output.data[0].value;
+                    operands[0] = inputs[0]->id;
+
+                    if (exponent == 1.0f)
+                    {
+                        sprintf(expression, "node_%02i", inputs[0]->id);
+                        rewrite = "pow(x, 1.0) -> x";
+                    }
+                    else if (exponent == 2.0f)
+                    {
+                        sprintf(expression, "node_%02i*node_%02i", inputs[0]->id, inputs[0]->id);
+                        cost->alu = count;
+                        rewrite = "pow(x, 2.0) -> x*x";
+                    }
+                    else if (exponent == 0.5f)
+                    {
+                        sprintf(expression, "sqrt(node_%02i)", inputs[0]->id);
+                        cost->transcendental = count;
+                        rewrite = "pow(x, 0.5) -> sqrt(x)";
+                    }
+                    else if (exponent == -1.0f)
+                    {
+                        sprintf(expression, "1.0/node_%02i", inputs[0]->id);
+                        cost->transcendental = count;
+                        rewrite = "pow(x, -1.0) -> 1.0/x";
+                    }
+                }
             } break;
-            case GLSL_100:
+            case FNODE_DIVIDE:
             {
-                const char vIn[] = 
-                "attribute vec3 vertexPosition;\n"
-                "attribute vec3 vertexNormal;\n"
-                "attribute vec2 vertexTexCoord;\n"
-                "attribute vec4 vertexColor;\n\n";
-                fprintf(vertexFile, vIn);
-
-                const char vOut[] = 
-                "varying vec3 fragPosition;\n"
-                "varying vec3 fragNormal;\n"
-                "varying vec2 fragTexCoord;\n"
-                "varying vec4 fragColor;\n\n";
-                fprintf(vertexFile, vOut);
+                int operandsCount = 0;
+                bool divisors = false;
+
+                sprintf(expression, "node_%02i", inputs[0]->id);
+                operands[operandsCount++] = inputs[0]->id;
+
+                for (int i = 1; i < node->inputsCount; i++)
+                {
+                    bool constant = IsNodeConstant(inputs[i]);
+                    for (int k = 0; (k < inputs[i]->output.dataCount) && constant; k++) constant = (inputs[i]->output.data[k].value != 0.0f);
+
+                    if (constant)
+                    {
+                        char literal[128] = { '\0' };
+                        FormatConstant(inputs[i], 1.0f, true, literal);
+                        sprintf(expression + strlen(expression), "*%s", literal);
+                        cost->alu += count;
+                        divisors = true;
+                    }
+                    else
+                    {
+                        sprintf(expression + strlen(expression), "/node_%02i", inputs[i]->id);
+                        operands[operandsCount++] = inputs[i]->id;
+                        cost->alu += count;
+                        cost->transcendental += count;
+                    }
+                }
+
+                if (divisors) rewrite = "x/constant -> x*(1.0/constant)";
             } break;
-            default: break;
-        }
+            case FNODE_MULTIPLY:
+            case FNODE_ADD:
+            case FNODE_SUBTRACT:
+            {
+                int other = -1;
+                int factor = -1;
 
-        const char vUniforms[] = 
-        "uniform mat4 mvp;\n"
-        "uniform float vertCurrentTime;\n\n";
-        fprintf(vertexFile, vUniforms);
-        
-        fprintf(vertexFile, "// Constant and uniform values\n");
-        int index = GetNodeIndex(nodes[0]->inputs[0]);
-        CheckConstant(nodes[index], vertexFile);
-
-        const char vMain[] = 
-        "\nvoid main()\n"
-        "{\n"
-        "    fragPosition = vertexPosition;\n"
-        "    fragNormal = vertexNormal;\n"
-        "    fragTexCoord = vertexTexCoord;\n"
-        "    fragColor = vertexColor;\n\n";
-        fprintf(vertexFile, vMain);
-
-        CompileNode(nodes[index], vertexFile, false);
-
-        switch (nodes[index]->output.dataCount)
-        {
-            case 1: fprintf(vertexFile, "\n    gl_Position = vec4(node_%02i, node_%02i, node_%02i, 1.0);\n}", nodes[0]->inputs[0], nodes[0]->inputs[0], nodes[0]->inputs[0]); break;
-            case 2: fprintf(vertexFile, "\n    gl_Position = vec4(node_%02i.xy, 0.0, 1.0);\n}", nodes[0]->inputs[0]); break;
-            case 3: fprintf(vertexFile, "\n    gl_Position = vec4(node_%02i.xyz, 1.0);\n}", nodes[0]->inputs[0]); break;
-            case 4: fprintf(vertexFile, "\n    gl_Position = node_%02i;\n}", nodes[0]->inputs[0]); break;
-            case 16: fprintf(vertexFile, "\n    gl_Position = node_%02i;\n}", nodes[0]->inputs[0]); break;
-            default: break;
-        }
+                // Fold angle units conversion into the constant it is multiplied by (conversion node is skipped so it must not be used elsewhere)
+                if ((node->type == FNODE_MULTIPLY) && (node->inputsCount == 2))
+                {
+                    for (int i = 0; i < 2; i++)
+                    {
+                        if (((inputs[i]->type == FNODE_DEG2RAD) || (inputs[i]->type == FNODE_RAD2DEG)) && (inputs[i]->inputsCount > 0) && (inputs[i]->output.dataCount == count) && 
+                        (GetNodeConsumers(inputs[i]) == 1) && !hoistedNodes[inputs[i]->id] && IsNodeConstant(inputs[1 - i]) && (inputs[1 - i]->output.dataCount == 1))
+                        {
+                            factor = i;
+                            other = 1 - i;
+                        }
+                    }
+                }
 
-        fclose(vertexFile);
-    }
-    else TraceLogFNode(true, "error when trying to open and write in vertex shader file");
+                if (factor != -1)
+                {
+                    char literal[128] = { '\0' };
+                    FNode angle = nodes[GetNodeIndex(inputs[factor]->inputs[0])];
+                    float scale = ((inputs[factor]->type == FNODE_DEG2RAD) ? (PI/180.0f) : (180.0f/PI));
+
+                    FormatConstant(inputs[other], scale, false, literal);
+                    sprintf(expression, "node_%02i*%s", angle->id, literal);
+                    operands[0] = angle->id;
+                    cost->alu = count;
+                    rewrite = ((inputs[factor]->type == FNODE_DEG2RAD) ? "constant*radians(x) -> x*(constant*PI/180.0)" : "constant*degrees(x) -> x*(constant*180.0/PI)");
+                }
+                else
+                {
+                    // Remove identity operands (multiply by one, add or subtract zero)
+                    float identity = ((node->type == FNODE_MULTIPLY) ? 1.0f : 0.0f);
+                    int operandsCount = 0;
+                    bool sized = (count == 1);
 
-    // Open fragment shader file to write data
-    FILE *fragmentFile = fopen(FRAGMENT_PATH, "w");
-    if (fragmentFile != NULL)
-    {
-        const char vCredits[] = "// Shader created with FNode 1.0 - Credits: Victor Fisac\n\n";
-        fprintf(vertexFile, vCredits);
+                    for (int i = 0; i < node->inputsCount; i++)
+                    {
+                        if ((i > 0 || (node->type != FNODE_SUBTRACT)) && IsConstantEqual(inputs[i], identity)) continue;
 
-        // Fragment shader definition to embed, no external file required
-        switch (version)
-        {
-            case GLSL_330:
+                        operands[operandsCount++] = inputs[i]->id;
+                        sized = (sized || (inputs[i]->output.dataCount == count));
+                    }
+
+                    if ((operandsCount > 0) && (operandsCount < node->inputsCount) && sized)
+                    {
+                        expression[0] = '\0';
+
+                        for (int i = 0; i < operandsCount; i++)
+                        {
+                            if (i > 0)
+                            {
+                                switch (node->type)
+                                {
+                                    case FNODE_MULTIPLY: strcat(expression, "*"); break;
+                                    case FNODE_ADD: strcat(expression, " + "); break;
+                                    case FNODE_SUBTRACT: strcat(expression, " - "); break;
+                                    default: break;
+                                }
+                            }
+
+                            sprintf(expression + strlen(expression), "node_%02i", operands[i]);
+                        }
+
+                        cost->alu = count*(operandsCount - 1);
+                        rewrite = ((node->type == FNODE_MULTIPLY) ? "x*1.0 -> x" : "x + 0.0 -> x");
+                    }
+                    else for (int i = 0; i < MAX_INPUTS; i++) operands[i] = -1;
+                }
+            } break;
+            case FNODE_NEGATE:
             {
-                const char fHeader[] = "#version 330\n\n";
-                fprintf(vertexFile, fHeader);
+                if ((inputs[0]->type == FNODE_NEGATE) && (inputs[0]->inputsCount > 0) && (GetNodeConsumers(inputs[0]) == 1) && !hoistedNodes[inputs[0]->id])
+                {
+                    operands[0] = inputs[0]->inputs[0];
+                    sprintf(expression, "node_%02i", operands[0]);
+                    rewrite = "-(-x) -> x";
+                }
             } break;
-            case GLSL_100:
+            case FNODE_NORMALIZE:
+            {
+                if (inputs[0]->type == FNODE_NORMALIZE)
+                {
+                    operands[0] = inputs[0]->id;
+                    sprintf(expression, "node_%02i", operands[0]);
+                    rewrite = "normalize(normalize(x)) -> normalize(x)";
+                }
+            } break;
+            case FNODE_CLAMP01:
             {
-                const char fHeader[] = "#version 100\n"
-                "precision mediump float;\n\n";
-                fprintf(vertexFile, fHeader);
+                if (IsNodeNormalized(inputs[0]))
+                {
+                    operands[0] = inputs[0]->id;
+                    sprintf(expression, "node_%02i", operands[0]);
+                    rewrite = "clamp(x, 0.0, 1.0) of x in 0 to 1 range -> x";
+                }
             } break;
             default: break;
         }
+    }
 
-        fprintf(fragmentFile, "// Input attributes\n");
-        
-        switch (version)
+    if (rewrite != NULL)
+    {
+        simplified = true;
+        TraceLogFNode(false, "node %i simplified: %s", node->id, rewrite);
+    }
+    else for (int i = 0; i < MAX_INPUTS; i++) operands[i] = -1;
+
+    return simplified;
+}
+
+// Check if a node expression can be substituted into its only consumer expression
+bool IsNodeInlineable(FNode node, bool fragment)
+{
+    bool inlineable = !hoistedNodes[node->id];
+    int consumers = 0;
+
+    // Samples which discard fragments and highp intermediates keep their own declaration
+    if (node->type == FNODE_SAMPLER2D) inlineable = (inlineable && (GetNodeCost(node).discard == 0));
+    if (strcmp(GetPrecisionQualifier(node, fragment), "HIGHP ") == 0) inlineable = false;
+
+    for (int i = 0; (i < nodesCount) && inlineable; i++)
+    {
+        for (int k = 0; k < nodes[i]->inputsCount; k++)
         {
-            case GLSL_330:
-            {
-                const char fIn[] = 
-                "in vec3 fragPosition;\n"
-                "in vec3 fragNormal;\n"
-                "in vec2 fragTexCoord;\n"
-                "in vec4 fragColor;\n\n";
-                fprintf(fragmentFile, fIn);
-            } break;
-            case GLSL_100:
+            if (nodes[i]->inputs[k] == node->id)
             {
-                const char fIn[] = 
-                "varying vec3 fragPosition;\n"
-                "varying vec3 fragNormal;\n"
-                "varying vec2 fragTexCoord;\n"
-                "varying vec4 fragColor;\n\n";
-                fprintf(fragmentFile, fIn);
-            } break;
-            default: break;
+                consumers++;
+
+                // Output nodes reference their input directly from shader main function
+                if ((nodes[i]->type == FNODE_VERTEX) || (nodes[i]->type == FNODE_FRAGMENT)) inlineable = false;
+            }
         }
+    }
+
+    return (inlineable && (consumers == 1));
+}
 
-        fprintf(fragmentFile, "// Uniform attributes\n");
-        const char fUniforms[] = 
-        "uniform vec3 viewDirection;\n"
-        "uniform mat4 modelMatrix;\n"
-        "uniform float fragCurrentTime;\n\n";
-        fprintf(fragmentFile, fUniforms);
+// Substitutes inlined nodes expressions in a node declaration body
+void InlineNodeExpressions(char *body, FILE *file, bool fragment)
+{
+    char result[4096] = { '\0' };
+    int references[MAX_NODES] = { 0 };
+    int length = strlen(body);
 
-        if (version == GLSL_330)
+    // Count inlined nodes references (nodes referenced more than once get their declaration back)
+    for (int i = 0; i < length; i++)
+    {
+        if ((strncmp(body + i, "node_", 5) == 0) && ((i == 0) || (strchr(" (*/-+,", body[i - 1]) != NULL)))
         {
-            fprintf(fragmentFile, "// Output attributes\n");
-            const char fOut[] = 
-            "out vec4 finalColor;\n\n";
-            fprintf(fragmentFile, fOut);
+            int id = atoi(body + i + 5);
+            if ((id >= 0) && (id < MAX_NODES)) references[id]++;
         }
+    }
 
-        fprintf(fragmentFile, "// Constant and uniform values\n");
-        int index = GetNodeIndex(nodes[1]->inputs[0]);
-        CheckConstant(nodes[index], fragmentFile);
+    for (int i = 0; i < MAX_NODES; i++)
+    {
+        if (inlinedNodes[i] && (references[i] > 1))
+        {
+            FNode node = nodes[GetNodeIndex(i)];
+            inlinedNodes[i] = false;
+            fprintf(file, "    %s%s node_%02i = %s;\n", GetPrecisionQualifier(node, fragment), GetDataTypeName(node->output.dataCount), i, inlinedExpressions[i]);
+        }
+    }
 
-        const char fMain[] = 
-        "\nvoid main()\n"
-        "{\n";
-        fprintf(fragmentFile, fMain);
+    // Replace each remaining reference by its parenthesized expression
+    for (int i = 0; i < length; i++)
+    {
+        int id = -1;
+        int digits = 0;
 
-        CompileNode(nodes[index], fragmentFile, true);
+        if ((strncmp(body + i, "node_", 5) == 0) && ((i == 0) || (strchr(" (*/-+,", body[i - 1]) != NULL)))
+        {
+            id = atoi(body + i + 5);
+            while ((body[i + 5 + digits] >= '0') && (body[i + 5 + digits] <= '9')) digits++;
+        }
 
-        switch (version)
+        if ((id >= 0) && (id < MAX_NODES) && inlinedNodes[id] && ((strlen(result) + strlen(inlinedExpressions[id]) + 3) < sizeof(result)))
         {
-            case GLSL_330:
-            {
-                switch (nodes[index]->output.dataCount)
-                {
-                    case 1: fprintf(fragmentFile, "\n    finalColor = vec4(node_%02i, node_%02i, node_%02i, 1.0);\n}", nodes[1]->inputs[0], nodes[1]->inputs[0], nodes[1]->inputs[0]); break;
-                    case 2: fprintf(fragmentFile, "\n    finalColor = vec4(node_%02i.xy, 0.0, 1.0);\n}", nodes[1]->inputs[0]); break;
-                    case 3: fprintf(fragmentFile, "\n    finalColor = vec4(node_%02i.xyz, 1.0);\n}", nodes[1]->inputs[0]); break;
-                    case 4: fprintf(fragmentFile, "\n    finalColor = node_%02i;\n}", nodes[1]->inputs[0]); break;
-                    default: break;
-                }
-            } break;
-            case GLSL_100:
+            // Identifiers and swizzles are substituted as they are, any other expression is parenthesized
+            bool identifier = (strspn(inlinedExpressions[id], "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_.") == strlen(inlinedExpressions[id]));
+
+            inlinedNodes[id] = false;
+            if (!identifier) strcat(result, "(");
+            strcat(result, inlinedExpressions[id]);
+            if (!identifier) strcat(result, ")");
+            i += (5 + digits - 1);
+        }
+        else if ((strlen(result) + 2) < sizeof(result)) strncat(result, body + i, 1);
+    }
+
+    strcpy(body, result);
+}
+
+// Writes a node declaration body in shader or keeps it to be inlined in its consumer
+void WriteNodeBody(FNode node, char *body, FILE *file, bool fragment)
+{
+    InlineNodeExpressions(body, file, fragment);
+
+    char *expression = strstr(body, " = ");
+    int length = 0;
+
+    if (expression != NULL)
+    {
+        expression += 3;
+        length = strlen(expression) - 2;
+    }
+
+    // Keep single statement expressions of single consumer nodes to substitute them in their consumer
+    if ((expression != NULL) && (length > 0) && (length < MAX_INLINE_LENGTH) && (strchr(expression, ';') == (expression + length)) && IsNodeInlineable(node, fragment))
+    {
+        strncpy(inlinedExpressions[node->id], expression, length);
+        inlinedExpressions[node->id][length] = '\0';
+        inlinedNodes[node->id] = true;
+    }
+    else fprintf(file, body);
+}
+
+// Check if an append node inputs are isomorphic scalar operations only used by it
+bool IsAppendVectorizable(FNode node)
+{
+    bool vectorizable = ((node->inputsCount >= 2) && (node->output.dataCount == node->inputsCount));
+    int firstIndex = (vectorizable ? GetNodeIndex(node->inputs[0]) : -1);
+
+    for (int i = 0; (i < node->inputsCount) && vectorizable; i++)
+    {
+        int index = GetNodeIndex(node->inputs[i]);
+
+        switch (nodes[index]->type)
+        {
+            case FNODE_ADD:
+            case FNODE_SUBTRACT:
+            case FNODE_MULTIPLY:
+            case FNODE_DIVIDE:
+            case FNODE_ONEMINUS:
+            case FNODE_ABS:
+            case FNODE_COS:
+            case FNODE_SIN:
+            case FNODE_TAN:
+            case FNODE_DEG2RAD:
+            case FNODE_RAD2DEG:
+            case FNODE_NEGATE:
+            case FNODE_RECIPROCAL:
+            case FNODE_SQRT:
+            case FNODE_TRUNC:
+            case FNODE_ROUND:
+            case FNODE_CEIL:
+            case FNODE_CLAMP01:
+            case FNODE_EXP2:
+            case FNODE_POWER:
+            case FNODE_STEP:
+            case FNODE_POSTERIZE:
+            case FNODE_MAX:
+            case FNODE_MIN:
+            case FNODE_LERP:
+            case FNODE_SMOOTHSTEP:
             {
-                switch (nodes[index]->output.dataCount)
-                {
-                    case 1: fprintf(fragmentFile, "\n    gl_FragColor = vec4(node_%02i, node_%02i, node_%02i, 1.0);\n}", nodes[1]->inputs[0], nodes[1]->inputs[0], nodes[1]->inputs[0]); break;
-                    case 2: fprintf(fragmentFile, "\n    gl_FragColor = vec4(node_%02i.xy, 0.0, 1.0);\n}", nodes[1]->inputs[0]); break;
-                    case 3: fprintf(fragmentFile, "\n    gl_FragColor = vec4(node_%02i.xyz, 1.0);\n}", nodes[1]->inputs[0]); break;
-                    case 4: fprintf(fragmentFile, "\n    gl_FragColor = node_%02i;\n}", nodes[1]->inputs[0]); break;
-                    default: break;
-                }
+                vectorizable = ((nodes[index]->type == nodes[firstIndex]->type) && (nodes[index]->inputsCount == nodes[firstIndex]->inputsCount) && 
+                (nodes[index]->inputsCount > 0) && (nodes[index]->output.dataCount == 1) && !hoistedNodes[nodes[index]->id] && !foldedNodes[nodes[index]->id]);
             } break;
-            default: break;
+            default: vectorizable = false; break;
         }
 
-        fclose(fragmentFile);
-    }
-    else TraceLogFNode(true, "error when trying to open and write in vertex shader file");
+        // Check if all operation inputs are scalar values
+        for (int k = 0; (k < nodes[index]->inputsCount) && vectorizable; k++)
+        {
+            int inputIndex = GetNodeIndex(nodes[index]->inputs[k]);
+            vectorizable = (nodes[inputIndex]->output.dataCount == 1);
+        }
 
-    compileState = 1;
-    compileFrame = framesCounter;
+        // Check if the scalar operation is not used by other nodes
+        for (int k = 0; (k < linesCount) && vectorizable; k++)
+        {
+            if ((lines[k]->from == nodes[index]->id) && (lines[k]->to != node->id)) vectorizable = false;
+        }
+    }
 
-    CheckPreviousShader(false);
+    return vectorizable;
 }
 
-// Check nodes searching for constant values to define them in shaders
-void CheckConstant(FNode node, FILE *file)
+// Compiles an append node of isomorphic scalar operations as a single vector operation
+void CompileVectorizedAppend(FNode node, FILE *file, bool fragment)
 {
-    switch (node->type)
+    char operands[MAX_INPUTS][64] = { { '\0' } };
+    const char *type = GetDataTypeName(node->output.dataCount);
+    const char channels[] = "rgba";
+    int lanes[MAX_INPUTS] = { -1, -1, -1, -1 };
+
+    for (int i = 0; i < node->inputsCount; i++) lanes[i] = GetNodeIndex(node->inputs[i]);
+
+    // Build a vector expression for each operation input from the scalar inputs of every lane
+    for (int k = 0; k < nodes[lanes[0]]->inputsCount; k++)
     {
-        case FNODE_PI: fprintf(file, "const float node_%02i = 3.14159265358979323846;\n", node->id); break;
-        case FNODE_E: fprintf(file, "const float node_%02i = 2.71828182845904523536;\n", node->id); break;
-        case FNODE_VALUE:
+        int sources[MAX_INPUTS] = { -1, -1, -1, -1 };
+        bool broadcast = true;
+        bool colorSwizzle = true;
+        bool textureSwizzle = fragment;
+
+        for (int i = 0; i < node->inputsCount; i++)
+        {
+            sources[i] = GetNodeIndex(nodes[lanes[i]]->inputs[k]);
+            broadcast = (broadcast && (sources[i] == sources[0]));
+            colorSwizzle = (colorSwizzle && (nodes[sources[i]]->type == FNODE_VERTEXCOLOR) && (nodes[sources[i]]->inputsCount == 1));
+            textureSwizzle = (textureSwizzle && (nodes[sources[i]]->type == FNODE_SAMPLER2D) && (nodes[sources[i]]->inputsCount == 2));
+        }
+
+        // Check if every lane reads a different single channel of the same vector
+        char swizzle[MAX_INPUTS + 1] = { '\0' };
+        for (int i = 0; (i < node->inputsCount) && (colorSwizzle || textureSwizzle); i++)
         {
-            if (node->property)
+            int channel = -1;
+            int unit = -1;
+
+            if (colorSwizzle) channel = (int)nodes[GetNodeIndex(nodes[sources[i]]->inputs[0])]->output.data[0].value;
+            else
             {
-                const char fConstantVector4[] = "uniform float node_%02i;\n";
-                fprintf(file, fConstantVector4, node->id);
+                unit = (int)nodes[GetNodeIndex(nodes[sources[i]]->inputs[0])]->output.data[0].value;
+                channel = (int)nodes[GetNodeIndex(nodes[sources[i]]->inputs[1])]->output.data[0].value;
+
+                // Alpha channel samples discard fragments so they are kept as scalar samples
+                if ((channel > 4) || (unit != (int)nodes[GetNodeIndex(nodes[sources[0]]->inputs[0])]->output.data[0].value)) textureSwizzle = false;
             }
+
+            if ((channel >= 2) && (channel <= 5)) swizzle[i] = channels[channel - 2];
             else
             {
-                const char fConstantValue[] = "const float node_%02i = %.3f;\n";
-                fprintf(file, fConstantValue, node->id, node->output.data[0].value);
+                colorSwizzle = false;
+                textureSwizzle = false;
             }
-        } break;
-        case FNODE_VECTOR2:
-        {
-            const char fConstantVector2[] = "const vec2 node_%02i = vec2(%.3f, %.3f);\n";
-            fprintf(file, fConstantVector2, node->id, node->output.data[0].value, node->output.data[1].value);
-        } break;
-        case FNODE_VECTOR3:
+        }
+
+        if (!broadcast && colorSwizzle) sprintf(operands[k], "%s.%s", (fragment ? "fragColor" : "vertexColor"), swizzle);
+        else if (!broadcast && textureSwizzle)
         {
-            const char fConstantVector3[] = "const vec3 node_%02i = vec3(%.3f, %.3f, %.3f);\n";
-            fprintf(file, fConstantVector3, node->id, node->output.data[0].value, node->output.data[1].value, node->output.data[2].value);
-        } break;
-        case FNODE_VECTOR4:
+            int unit = (int)nodes[GetNodeIndex(nodes[sources[0]]->inputs[0])]->output.data[0].value;
+            AddNodeCost(nodes[sources[0]], GetNodeCost(nodes[sources[0]]), fragment);
+            CompileTextureFetch(nodes[sources[0]], unit, file, fragment);
+            sprintf(operands[k], "texel%i.%s", unit, swizzle);
+        }
+        else
         {
-            if (node->property)
+            // Compile operator inputs first (constant values are already declared)
+            for (int i = 0; i < node->inputsCount; i++)
             {
-                const char fConstantVector4[] = "uniform vec4 node_%02i;\n";
-                fprintf(file, fConstantVector4, node->id);
+                if (nodes[sources[i]]->type > FNODE_VECTOR4 || ((nodes[sources[i]]->type < FNODE_MATRIX) && (nodes[sources[i]]->type > FNODE_E))) CompileNode(nodes[sources[i]], file, fragment);
             }
+
+            if (broadcast) sprintf(operands[k], "%s(node_%02i)", type, nodes[sources[0]]->id);
             else
             {
-                const char fConstantVector4[] = "const vec4 node_%02i = vec4(%.3f, %.3f, %.3f, %.3f);\n";
-                fprintf(file, fConstantVector4, node->id, node->output.data[0].value, node->output.data[1].value, node->output.data[2].value, node->output.data[3].value);
+                sprintf(operands[k], "%s(", type);
+
+                for (int i = 0; i < node->inputsCount; i++)
+                {
+                    char source[16] = { '\0' };
+                    sprintf(source, (((i + 1) == node->inputsCount) ? "node_%02i)" : "node_%02i, "), nodes[sources[i]]->id);
+                    strcat(operands[k], source);
+                }
             }
-        } break;
-        case FNODE_SAMPLER2D:
+        }
+    }
+
+    // Write lanes operation once with vector operands (cost is still counted per lane component)
+    for (int i = 0; i < node->inputsCount; i++) AddNodeCost(nodes[lanes[i]], GetNodeCost(nodes[lanes[i]]), fragment);
+
+    char body[4096] = { '\0' };
+    sprintf(body, "    %s%s node_%02i = ", GetPrecisionQualifier(node, fragment), type, node->id);
+
+    switch (nodes[lanes[0]]->type)
+    {
+        case FNODE_ADD:
+        case FNODE_SUBTRACT:
+        case FNODE_MULTIPLY:
+        case FNODE_DIVIDE:
         {
-            char fConstantSampler[32] = { '\0' };
-            int index = GetNodeIndex(node->inputs[0]);
-            sprintf(fConstantSampler, "uniform sampler2D texture%i;\n", (int)nodes[index]->output.data[0].value);
-            if (!usedUnits[(int)nodes[index]->output.data[0].value])
+            for (int k = 0; k < nodes[lanes[0]]->inputsCount; k++)
             {
-                fprintf(file, fConstantSampler);
-                usedUnits[(int)nodes[index]->output.data[0].value] = true;
+                strcat(body, operands[k]);
+
+                if ((k + 1) < nodes[lanes[0]]->inputsCount)
+                {
+                    switch (nodes[lanes[0]]->type)
+                    {
+                        case FNODE_ADD: strcat(body, " + "); break;
+                        case FNODE_SUBTRACT: strcat(body, " - "); break;
+                        case FNODE_MULTIPLY: strcat(body, "*"); break;
+                        case FNODE_DIVIDE: strcat(body, "/"); break;
+                        default: break;
+                    }
+                }
             }
+
+            strcat(body, ";\n");
         } break;
-        default:
+        case FNODE_ONEMINUS: sprintf(body + strlen(body), "(1.0 - %s);\n", operands[0]); break;
+        case FNODE_ABS: sprintf(body + strlen(body), "abs(%s);\n", operands[0]); break;
+        case FNODE_COS: sprintf(body + strlen(body), "cos(%s);\n", operands[0]); break;
+        case FNODE_SIN: sprintf(body + strlen(body), "sin(%s);\n", operands[0]); break;
+        case FNODE_TAN: sprintf(body + strlen(body), "tan(%s);\n", operands[0]); break;
+        case FNODE_DEG2RAD: sprintf(body + strlen(body), "%s*(3.14159265358979323846/180.0);\n", operands[0]); break;
+        case FNODE_RAD2DEG: sprintf(body + strlen(body), "%s*(180.0/3.14159265358979323846);\n", operands[0]); break;
+        case FNODE_NEGATE: sprintf(body + strlen(body), "%s*-1.0;\n", operands[0]); break;
+        case FNODE_RECIPROCAL: sprintf(body + strlen(body), "1.0/%s;\n", operands[0]); break;
+        case FNODE_SQRT: sprintf(body + strlen(body), "sqrt(%s);\n", operands[0]); break;
+        case FNODE_TRUNC: sprintf(body + strlen(body), "trunc(%s);\n", operands[0]); break;
+        case FNODE_ROUND: sprintf(body + strlen(body), "round(%s);\n", operands[0]); break;
+        case FNODE_CEIL: sprintf(body + strlen(body), "ceil(%s);\n", operands[0]); break;
+        case FNODE_CLAMP01: sprintf(body + strlen(body), "clamp(%s, 0.0, 1.0);\n", operands[0]); break;
+        case FNODE_EXP2: sprintf(body + strlen(body), "exp2(%s);\n", operands[0]); break;
+        case FNODE_POWER: sprintf(body + strlen(body), "pow(%s, %s);\n", operands[0], operands[1]); break;
+        case FNODE_STEP: sprintf(body + strlen(body), "step(%s, %s);\n", operands[0], operands[1]); break;
+        case FNODE_POSTERIZE: sprintf(body + strlen(body), "floor(%s*%s)/%s;\n", operands[0], operands[1], operands[1]); break;
+        case FNODE_MAX: sprintf(body + strlen(body), "max(%s, %s);\n", operands[0], operands[1]); break;
+        case FNODE_MIN: sprintf(body + strlen(body), "min(%s, %s);\n", operands[0], operands[1]); break;
+        case FNODE_LERP: sprintf(body + strlen(body), "mix(%s, %s, %s);\n", operands[0], operands[1], operands[2]); break;
+        case FNODE_SMOOTHSTEP: sprintf(body + strlen(body), "smoothstep(%s, %s, %s);\n", operands[0], operands[1], operands[2]); break;
+        default: break;
+    }
+
+    WriteNodeBody(node, body, file, fragment);
+
+    TraceLogFNode(false, "append node %i vectorized (%i scalar operations merged)", node->id, node->inputsCount);
+}
+
+// Aligns all created nodes
+void AlignAllNodes()
+{
+    for (int i = 0; i < nodesCount; i++)
+    {
+        AlignNode(nodes[i]);
+        UpdateNodeShapes(nodes[i]);
+    }
+}
+
+// Destroys all nodes unreachable from output nodes
+void ClearUnusedNodes()
+{
+    int unused[MAX_NODES] = { 0 };
+    int unusedCount = 0;
+
+    // Nodes unreachable from output nodes are unused even if they are linked to other unused nodes
+    MarkReachableNodes();
+
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (!reachableNodes[nodes[i]->id])
         {
-            for (int i = 0; i < node->inputsCount; i++)
-            {
-                int index = GetNodeIndex(node->inputs[i]);
-                CheckConstant(nodes[index], file);
-            }
-        } break;
+            unused[unusedCount] = nodes[i]->id;
+            unusedCount++;
+        }
+    }
+
+    for (int i = 0; i < unusedCount; i++) DestroyNode(nodes[GetNodeIndex(unused[i])]);
+
+    TraceLogFNode(false, "%i unused nodes have been deleted [USED RAM: %i bytes]", unusedCount, usedMemory);
+}
+
+// Destroys structurally identical nodes linking their consumers to a single node
+void MergeDuplicatedNodes()
+{
+    int duplicated[MAX_NODES] = { 0 };
+    int duplicatedCount = 0;
+
+    // Update constant subgraphs with current graph values before comparing nodes
+    MarkReachableNodes();
+    FoldNodes();
+
+    for (int i = 0; i < MAX_NODES; i++) mergedNodes[i] = -1;
+    for (int i = 0; i < nodesCount; i++)
+    {
+        if (GetMergedNode(nodes[i]) != nodes[i]->id)
+        {
+            duplicated[duplicatedCount] = nodes[i]->id;
+            duplicatedCount++;
+        }
     }
+
+    for (int i = 0; i < linesCount; i++) lines[i]->from = mergedNodes[lines[i]->from];
+    for (int i = 0; i < duplicatedCount; i++) DestroyNode(nodes[GetNodeIndex(duplicated[i])]);
+
+    CalculateValues();
+
+    TraceLogFNode(false, "%i duplicated nodes have been merged [USED RAM: %i bytes]", duplicatedCount, usedMemory);
 }
 
-// Compiles a specific node checking its inputs and writing current node operation in shader
-void CompileNode(FNode node, FILE *file, bool fragment)
+// Collapses last selected node and its upstream operations into a library function node
+void CollapseFunction()
 {
-    // Check if current node is an operator
-    if ((node->inputsCount > 0) || ((node->type < FNODE_MATRIX) && (node->type > FNODE_E)) || (node->type == FNODE_SAMPLER2D))
+    int index = -1;
+    for (int i = 0; i < nodesCount; i++)
     {
-        // Check for operator nodes in inputs to compile them first
-        for (int i = 0; i < node->inputsCount; i++)
+        if (nodes[i]->id == focusedNode) index = i;
+    }
+
+    if ((index != -1) && (nodes[index]->type >= FNODE_ADD) && IsNodeCollapsible(nodes[index]) && (functionsCount < MAX_FUNCTIONS))
+    {
+        FNode root = nodes[index];
+        bool body[MAX_NODES] = { false };
+        bool collapsing = true;
+
+        MarkFunctionBody(root, body, NULL);
+
+        // Body nodes used by other nodes are calculated outside the function and become function inputs
+        while (collapsing)
         {
-            int index = GetNodeIndex(node->inputs[i]);
-            if (nodes[index]->type > FNODE_VECTOR4 || ((nodes[index]->type < FNODE_MATRIX) && (nodes[index]->type > FNODE_E))) CompileNode(nodes[index], file, fragment);
+            collapsing = false;
+
+            for (int i = 0; i < nodesCount; i++)
+            {
+                for (int k = 0; (k < nodes[i]->inputsCount) && !body[nodes[i]->id]; k++)
+                {
+                    if (body[nodes[i]->inputs[k]] && (nodes[i]->inputs[k] != root->id))
+                    {
+                        body[nodes[i]->inputs[k]] = false;
+                        collapsing = true;
+                    }
+                }
+            }
+
+            bool reached[MAX_NODES] = { false };
+            MarkFunctionBody(root, reached, body);
+
+            for (int i = 0; i < MAX_NODES; i++)
+            {
+                if (body[i] != reached[i]) collapsing = true;
+                body[i] = reached[i];
+            }
         }
 
-        // Store variable declaration into a string
-        char check[16] = { '\0' };
-        switch (node->output.dataCount)
+        bool visited[MAX_NODES] = { false };
+        int order[MAX_FUNCTION_NODES] = { 0 };
+        int params[MAX_INPUTS] = { -1, -1, -1, -1 };
+        int paramsCount = 0;
+        int count = GetFunctionOrder(root, body, visited, order, 0, params, &paramsCount);
+        bool valid = ((paramsCount > 0) && (paramsCount <= MAX_INPUTS) && ((count + paramsCount) <= MAX_FUNCTION_NODES));
+
+        for (int i = 0; (i < paramsCount) && valid; i++)
         {
-            case 1: sprintf(check, "float node_%02i", node->id); break;
-            case 2: sprintf(check, "vec2 node_%02i", node->id); break;
-            case 3: sprintf(check, "vec3 node_%02i", node->id); break;
-            case 4: sprintf(check, "vec4 node_%02i", node->id); break;
-            case 16: sprintf(check, "mat4 node_%02i", node->id); break;
-            default: break;
+            int dataCount = nodes[GetNodeIndex(params[i])]->output.dataCount;
+            valid = (((dataCount > 0) && (dataCount <= 4)) || (dataCount == 16));
         }
 
-        // Check if current node is previously defined and declared
-        if (!FSearch(FRAGMENT_PATH, check))
+        if (valid)
         {
-            // Variable definition based on current node output data count
-            char body[4096] = { '\0' };
-            char definition[32] = { '\0' };
-            switch (node->output.dataCount)
-            {
-                case 1: sprintf(definition, "    float node_%02i = ", node->id); break;
-                case 2: sprintf(definition, "    vec2 node_%02i = ", node->id); break;
-                case 3: sprintf(definition, "    vec3 node_%02i = ", node->id); break;
-                case 4: sprintf(definition, "    vec4 node_%02i = ", node->id); break;
-                case 16: sprintf(definition, "    mat4 node_%02i = ", node->id); break;
-                default: break;
-            }
-            strcat(body, definition);
+            FNode paramNodes[MAX_INPUTS] = { NULL, NULL, NULL, NULL };
+            FNode bodyNodes[MAX_FUNCTION_NODES] = { NULL };
+            int ids[MAX_NODES] = { 0 };
 
-            if (((node->type < FNODE_MATRIX) && (node->type > FNODE_E)) || (node->type == FNODE_SAMPLER2D))
-            {
-                switch (node->type)
-                {
-                    case FNODE_TIME:
-                    {
-                        if (fragment) strcat(body, "fragCurrentTime;\n");
-                        else strcat(body, "vertCurrentTime;\n");
-                    } break;
-                    case FNODE_VERTEXPOSITION:
-                    {
-                        if (fragment) strcat(body, "fragPosition;\n");
-                        else strcat(body, "vertexPosition;\n");
-                    } break;
-                    case FNODE_VERTEXNORMAL:
-                    {
-                        if (fragment) strcat(body, "fragNormal;\n");
-                        else strcat(body, "vertexNormal;\n");
-                    } break;
-                    case FNODE_FRESNEL: strcat(body, "1.0 - dot(fragNormal, viewDirection);\n"); break;
-                    case FNODE_VIEWDIRECTION: strcat(body, "viewDirection;\n"); break;
-                    case FNODE_MVP: strcat(body, "mvp;\n"); break;
-                    case FNODE_SAMPLER2D:
-                    {
-                        char test[128] = { '\0' };
+            for (int i = 0; i < paramsCount; i++) paramNodes[i] = nodes[GetNodeIndex(params[i])];
+            for (int i = 0; i < count; i++) bodyNodes[i] = nodes[GetNodeIndex(order[i])];
 
-                        int indexA = GetNodeIndex(node->inputs[0]);
-                        int indexB = GetNodeIndex(node->inputs[1]);
-                        
-                        switch (version)
-                        {
-                            case GLSL_330:
-                            {
-                                switch ((int)nodes[indexB]->output.data[0].value)
-                                {
-                                    case 0: sprintf(test, "texture(texture%i, fragTexCoord);\n    if (node_%02i.a == 0.0) discard;\n", (int)nodes[indexA]->output.data[0].value, node->id); break;
-                                    case 1: sprintf(test, "texture(texture%i, fragTexCoord).rgb;\n", (int)nodes[indexA]->output.data[0].value); break;
-                                    case 2: sprintf(test, "texture(texture%i, fragTexCoord).r;\n", (int)nodes[indexA]->output.data[0].value); break;
-                                    case 3: sprintf(test, "texture(texture%i, fragTexCoord).g;\n", (int)nodes[indexA]->output.data[0].value); break;
-                                    case 4: sprintf(test, "texture(texture%i, fragTexCoord).b;\n", (int)nodes[indexA]->output.data[0].value); break;
-                                    case 5: sprintf(test, "texture(texture%i, fragTexCoord).a;\n    if (node_%02i == 0.0) discard;\n", (int)nodes[indexA]->output.data[0].value, node->id); break;
-                                    default: sprintf(test, "texture(texture%i, fragTexCoord);\n", (int)nodes[indexA]->output.data[0].value); break;
-                                }
-                            } break;
-                            case GLSL_100:
-                            {
-                                switch ((int)nodes[indexB]->output.data[0].value)
-                                {
-                                    case 0: sprintf(test, "texture2D(texture%i, fragTexCoord);\n    if (node_%02i.a == 0.0) discard;\n", (int)nodes[indexA]->output.data[0].value, node->id); break;
-                                    case 1: sprintf(test, "texture2D(texture%i, fragTexCoord).rgb;\n", (int)nodes[indexA]->output.data[0].value); break;
-                                    case 2: sprintf(test, "texture2D(texture%i, fragTexCoord).r;\n", (int)nodes[indexA]->output.data[0].value); break;
-                                    case 3: sprintf(test, "texture2D(texture%i, fragTexCoord).g;\n", (int)nodes[indexA]->output.data[0].value); break;
-                                    case 4: sprintf(test, "texture2D(texture%i, fragTexCoord).b;\n", (int)nodes[indexA]->output.data[0].value); break;
-                                    case 5: sprintf(test, "texture2D(texture%i, fragTexCoord).a;\n    if (node_%02i == 0.0) discard;\n", (int)nodes[indexA]->output.data[0].value, node->id); break;
-                                    default: sprintf(test, "texture2D(texture%i, fragTexCoord);\n", (int)nodes[indexA]->output.data[0].value); break;
-                                }
-                            } break;
-                            default: break;
-                        }
+            // Generated names skip names of library functions loaded or renamed by hand
+            int suffix = functionsCount;
+            while (GetFunctionIndex(FormatText("function_%02i", suffix)) != -1) suffix++;
 
-                        strcat(body, test);
-                        break;
-                    }
+            FFunction function = AddFunction(FormatText("function_%02i", suffix), paramsCount);
+
+            // Function body is created in an empty pool with its inputs first and its nodes in evaluation order
+            BeginFunctionBody(function);
+
+            for (int i = 0; i < paramsCount; i++)
+            {
+                FNode input = InitializeNode(false);
+                switch (paramNodes[i]->output.dataCount)
+                {
+                    case 1: input->type = FNODE_VALUE; break;
+                    case 2: input->type = FNODE_VECTOR2; break;
+                    case 3: input->type = FNODE_VECTOR3; break;
+                    case 4: input->type = FNODE_VECTOR4; break;
+                    case 16: input->type = FNODE_MATRIX; break;
                     default: break;
                 }
+
+                input->name = "Input";
+                input->output.dataCount = paramNodes[i]->output.dataCount;
+                for (int k = 0; k < MAX_VALUES; k++) input->output.data[k].value = paramNodes[i]->output.data[k].value;
+                ids[paramNodes[i]->id] = input->id;
             }
-            else if ((node->type >= FNODE_ADD && node->type <= FNODE_DIVIDE) || node->type == FNODE_MULTIPLYMATRIX)
+
+            for (int i = 0; i < count; i++)
             {
-                // Operate with each input node
-                for (int i = 0; i < node->inputsCount; i++)
+                FNode copy = InitializeNode(bodyNodes[i]->type >= FNODE_ADD);
+                copy->type = bodyNodes[i]->type;
+                copy->name = bodyNodes[i]->name;
+                copy->inputsLimit = bodyNodes[i]->inputsLimit;
+                copy->output.dataCount = bodyNodes[i]->output.dataCount;
+                for (int k = 0; k < MAX_VALUES; k++) copy->output.data[k].value = bodyNodes[i]->output.data[k].value;
+                ids[bodyNodes[i]->id] = copy->id;
+
+                // Lines are created in inputs order so calculated inputs keep their order
+                for (int k = 0; k < bodyNodes[i]->inputsCount; k++)
                 {
-                    char temp[32] = { '\0' };
-                    if ((i+1) == node->inputsCount) sprintf(temp, "node_%02i;\n", node->inputs[i]);
-                    else
-                    {
-                        int nextIndex = GetNodeIndex(node->inputs[i+1]);
-                        if ((nodes[nextIndex]->output.dataCount - 1) == node->output.dataCount)
-                        {
-                            switch (node->output.dataCount)
-                            {
-                                case 1: sprintf(temp, "vec2(node_%02i, 0.0);\n", node->inputs[i]);
-                                case 2: sprintf(temp, "vec3(node_%02i, 0.0);\n", node->inputs[i]);
-                                case 3: sprintf(temp, "vec4(node_%02i, 0.0);\n", node->inputs[i]);
-                                default: break;
-                            }
-                        }
-                        else sprintf(temp, "node_%02i", node->inputs[i]);
-                        switch (node->type)
-                        {
-                            case FNODE_ADD: strcat(temp, " + "); break;
-                            case FNODE_SUBTRACT: strcat(temp, " - "); break;
-                            case FNODE_MULTIPLYMATRIX:
-                            case FNODE_MULTIPLY: strcat(temp, "*"); break;
-                            case FNODE_DIVIDE: strcat(temp, "/"); break;
-                            default: break;
-                        }
-                    }
-
-                    strcat(body, temp);
+                    FLine line = CreateNodeLine(ids[bodyNodes[i]->inputs[k]]);
+                    line->to = copy->id;
                 }
             }
-            else if (node->type >= FNODE_APPEND)
-            {
-                char temp[128] = { '\0' };
-                switch (node->type)
-                {
-                    case FNODE_APPEND:
-                    {
-                        switch (node->output.dataCount)
-                        {
-                            case 2: strcat(temp, "vec2("); break;
-                            case 3: strcat(temp, "vec3("); break;
-                            case 4: strcat(temp, "vec4("); break;
-                            default: break;
-                        }
 
-                        for (int i = 0; i < node->inputsCount; i++)
-                        {
-                            char append[32] = { '\0' };
-                            if ((i + 1) == node->inputsCount) sprintf(append, "node_%02i);\n", node->inputs[i]);
-                            else sprintf(append, "node_%02i, ", node->inputs[i]);
-                            
-                            strcat(temp, append);
-                        }
-                    } break;
-                    case FNODE_ONEMINUS: sprintf(temp, "(1.0 - node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_ABS: sprintf(temp, "abs(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_COS: sprintf(temp, "cos(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_SIN: sprintf(temp, "sin(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_TAN: sprintf(temp, "tan(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_DEG2RAD: sprintf(temp, "node_%02i*(3.14159265358979323846/180.0);\n", node->inputs[0]); break;
-                    case FNODE_RAD2DEG: sprintf(temp, "node_%02i*(180.0/3.14159265358979323846);\n", node->inputs[0]); break;
-                    case FNODE_NORMALIZE: sprintf(temp, "normalize(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_NEGATE: sprintf(temp, "node_%02i*-1;\n", node->inputs[0]); break;
-                    case FNODE_RECIPROCAL: sprintf(temp, "1.0/node_%02i;\n", node->inputs[0]); break;
-                    case FNODE_SQRT: sprintf(temp, "sqrt(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_TRUNC: sprintf(temp, "trunc(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_ROUND: sprintf(temp, "round(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_VERTEXCOLOR:
-                    {
-                        int index = GetNodeIndex(node->inputs[0]);
-                        switch ((int)nodes[index]->output.data[0].value)
-                        {
-                            case 0: sprintf(temp, (fragment ? "fragColor;\n" : "vertexColor;\n")); break;
-                            case 1: sprintf(temp, (fragment ? "fragColor.rgb;\n" : "vertexColor.rgb;\n")); break;
-                            case 2: sprintf(temp, (fragment ? "fragColor.r;\n" : "vertexColor.r;\n")); break;
-                            case 3: sprintf(temp, (fragment ? "fragColor.g;\n" : "vertexColor.g;\n")); break;
-                            case 4: sprintf(temp, (fragment ? "fragColor.b;\n" : "vertexColor.b;\n")); break;
-                            case 5: sprintf(temp, (fragment ? "fragColor.a;\n" : "vertexColor.a;\n")); break;
-                            default: break;
-                        }
-                    } break;
-                    case FNODE_CEIL: sprintf(temp, "ceil(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_CLAMP01: sprintf(temp, "clamp(node_%02i, 0.0, 1.0);\n", node->inputs[0]); break;
-                    case FNODE_EXP2: sprintf(temp, "exp2(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_POWER: sprintf(temp, "pow(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1]); break;
-                    case FNODE_STEP: sprintf(temp, "((node_%02i <= node_%02i) ? 1.0 : 0.0);\n", node->inputs[0], node->inputs[1]); break;
-                    case FNODE_POSTERIZE: sprintf(temp, "floor(node_%02i*node_%02i)/node_%02i;\n", node->inputs[0], node->inputs[1], node->inputs[1]); break;
-                    case FNODE_MAX: sprintf(temp, "max(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1], node->inputs[1]); break;
-                    case FNODE_MIN: sprintf(temp, "min(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1], node->inputs[1]); break;
-                    case FNODE_LERP: sprintf(temp, "mix(node_%02i, node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1], node->inputs[2]); break;
-                    case FNODE_SMOOTHSTEP: sprintf(temp, "smoothstep(node_%02i, node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1], node->inputs[2]); break;
-                    case FNODE_CROSSPRODUCT: sprintf(temp, "cross(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1]); break;
-                    case FNODE_DESATURATE:
-                    {
-                        switch (node->output.dataCount)
-                        {
-                            case 1: sprintf(temp, "mix(node_%02i, 0.3, node_%02i);\n", node->inputs[0], node->inputs[1]); break;
-                            case 2: sprintf(temp, "vec2(mix(node_%02i.x, vec2(0.3, 0.59), node_%02i));\n", node->inputs[0], node->inputs[1]); break;
-                            case 3: sprintf(temp, "vec3(mix(node_%02i.xyz, vec3(0.3, 0.59, 0.11), node_%02i));\n", node->inputs[0], node->inputs[1]); break;
-                            case 4: sprintf(temp, "vec4(mix(node_%02i.xyz, vec3(0.3, 0.59, 0.11), node_%02i), 1.0);\n", node->inputs[0], node->inputs[1]); break;
-                            default: break;
-                        }
-                    } break;
-                    case FNODE_DISTANCE: sprintf(temp, "distance(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1]); break;
-                    case FNODE_DOTPRODUCT: sprintf(temp, "dot(node_%02i, node_%02i);\n", node->inputs[0], node->inputs[1]); break;
-                    case FNODE_LENGTH: sprintf(temp, "length(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_TRANSPOSE: sprintf(temp, "transpose(node_%02i);\n", node->inputs[0]); break;
-                    case FNODE_PROJECTION:
-                    {
-                        switch (node->output.dataCount)
-                        {
-                            case 2: sprintf(temp, "vec2(dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y);\n", 
-                            node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
-                            case 3: sprintf(temp, "vec3(dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.z);\n", 
-                            node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
-                            case 4: sprintf(temp, "vec4(dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.z, dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.w);\n", 
-                            node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
-                            default: break;
-                        }
-                    }
-                    case FNODE_REJECTION:
-                    {
-                        switch (node->output.dataCount)
-                        {
-                            case 2: sprintf(temp, "vec2(node_%02i.x - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, node_%02i.y - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y);\n", 
-                            node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
-                            case 3: sprintf(temp, "vec3(node_%02i.x - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, node_%02i.y - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y, node_%02i.z - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.z);\n", 
-                            node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
-                            case 4: sprintf(temp, "vec4(node_%02i.x - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.x, node_%02i.y - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.y, node_%02i.z - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.z, node_%02i.w - dot(node_%02i, node_%02i)/dot(node_%02i, node_%02i)*node_%02i.w);\n", 
-                            node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[0], node->inputs[0], node->inputs[1], node->inputs[1], node->inputs[1], node->inputs[1]); break;
-                            default: break;
-                        }
-                    } break;
-                    case FNODE_HALFDIRECTION: sprintf(temp, "normalize(node_%02i + node_%02i);\n", node->inputs[0], node->inputs[1]); break;
-                    default: break;
-                }
+            CalculateValues();
+            EndFunctionBody();
+
+            CompileFunction(function);
+            SaveFunction(function);
 
-                strcat(body, temp);
+            // Replace collapsed nodes by a function node linked to their inputs and consumers
+            FNode functionNode = CreateNodeFunction(functionsCount - 1);
+            functionNode->shape.x = root->shape.x;
+            functionNode->shape.y = root->shape.y;
+
+            for (int i = 0; i < paramsCount; i++)
+            {
+                FLine line = CreateNodeLine(params[i]);
+                line->to = functionNode->id;
+            }
+
+            for (int i = 0; i < linesCount; i++)
+            {
+                if (lines[i]->from == root->id) lines[i]->from = functionNode->id;
             }
 
-            // Write current node string to shader file
-            fprintf(file, body);
+            for (int i = 0; i < count; i++) DestroyNode(nodes[GetNodeIndex(order[i])]);
+
+            CalculateValues();
+            focusedNode = functionNode->id;
+
+            TraceLogFNode(false, "%i nodes collapsed into library function %s (%i inputs, cost %i) [USED RAM: %i bytes]", count, function->name, paramsCount, GetCostTotal(function->cost), usedMemory);
         }
+        else TraceLogFNode(false, "error trying to collapse node %i into a function with %i inputs and %i nodes", root->id, paramsCount, count);
     }
+    else TraceLogFNode(false, "error trying to collapse into a function: select an operation node first");
 }
 
-// Aligns all created nodes
-void AlignAllNodes()
+// Check if a node can be part of a library function body (non property constants and operations without shader inputs)
+bool IsNodeCollapsible(FNode node)
 {
-    for (int i = 0; i < nodesCount; i++)
+    bool collapsible = false;
+
+    if ((node->type >= FNODE_ADD) && (node->type <= FNODE_HALFDIRECTION)) collapsible = ((node->type != FNODE_VERTEXCOLOR) && (node->inputsCount > 0));
+    else if ((node->type == FNODE_PI) || (node->type == FNODE_E) || ((node->type >= FNODE_MATRIX) && (node->type <= FNODE_VECTOR4))) collapsible = !node->property;
+
+    return (collapsible && (((node->output.dataCount > 0) && (node->output.dataCount <= 4)) || (node->output.dataCount == 16)));
+}
+
+// Marks a node and its upstream collapsible nodes (only allowed nodes if any) as function body
+void MarkFunctionBody(FNode node, bool *body, bool *allowed)
+{
+    if (!body[node->id] && IsNodeCollapsible(node) && ((allowed == NULL) || allowed[node->id]))
     {
-        AlignNode(nodes[i]);
-        UpdateNodeShapes(nodes[i]);
+        body[node->id] = true;
+
+        for (int i = 0; i < node->inputsCount; i++) MarkFunctionBody(nodes[GetNodeIndex(node->inputs[i])], body, allowed);
     }
 }
 
-// Destroys all unused nodes
-void ClearUnusedNodes()
+// Adds function body node ids in evaluation order and its external inputs, returns body count
+int GetFunctionOrder(FNode node, bool *body, bool *visited, int *order, int count, int *params, int *paramsCount)
 {
-    for (int i = nodesCount - 1; i >= 0; i--)
-    {
-        bool used = (nodes[i]->type >= FNODE_VERTEX);
+    visited[node->id] = true;
 
-        if (!used)
+    for (int i = 0; i < node->inputsCount; i++)
+    {
+        if (body[node->inputs[i]])
+        {
+            if (!visited[node->inputs[i]]) count = GetFunctionOrder(nodes[GetNodeIndex(node->inputs[i])], body, visited, order, count, params, paramsCount);
+        }
+        else
         {
-            for (int k = 0; k < linesCount; k++)
+            bool found = false;
+            for (int k = 0; (k < *paramsCount) && (k < MAX_INPUTS); k++)
             {
-                if ((nodes[i]->id == lines[k]->from) || (nodes[i]->id == lines[k]->to))
-                {
-                    used = true;
-                    break;
-                }
+                if (params[k] == node->inputs[i]) found = true;
             }
-        }
 
-        if (!used) DestroyNode(nodes[i]);
+            if (!found)
+            {
+                if (*paramsCount < MAX_INPUTS) params[*paramsCount] = node->inputs[i];
+                (*paramsCount)++;
+            }
+        }
     }
 
-    TraceLogFNode(false, "all unused nodes have been deleted [USED RAM: %i bytes]", usedMemory);
+    if (count < MAX_FUNCTION_NODES) order[count] = node->id;
+
+    return (count + 1);
 }
 
 // Destroys all created nodes and its linked lines
@@ -1671,7 +7279,7 @@ void ClearGraph()
 {
     for (int i = nodesCount - 1; i >= 0; i--)
     {
-        if (nodes[i]->type < FNODE_VERTEX) DestroyNode(nodes[i]);
+        if ((nodes[i]->type != FNODE_VERTEX) && (nodes[i]->type != FNODE_FRAGMENT)) DestroyNode(nodes[i]);
     }
     for (int i = commentsCount - 1; i >= 0; i--) DestroyComment(comments[i]);
 
@@ -1696,6 +7304,33 @@ void DrawCanvas()
         for (int i = 0; i < nodesCount; i++) DrawNode(nodes[i]);
         for (int i = 0; i < linesCount; i++) DrawNodeLine(lines[i]);
 
+        // Tint nodes by their share of current fragment shader cost
+        if (costHeatmap && (GetCostTotal(fragmentCost) > 0))
+        {
+            for (int i = 0; i < nodesCount; i++)
+            {
+                int cost = GetCostTotal(nodeCosts[nodes[i]->id]);
+
+                if (cost > 0)
+                {
+                    float share = (float)cost/GetCostTotal(fragmentCost);
+                    DrawRectangleRec(nodes[i]->shape, Fade(RED, 0.15f + share*0.6f));
+                    DrawText(FormatText("%i%%", (int)(share*100.0f)), nodes[i]->shape.x, nodes[i]->shape.y - 12, 10, RED);
+                }
+            }
+        }
+
+        // Highlight nodes unreachable from output nodes
+        if (unusedHighlight)
+        {
+            MarkReachableNodes();
+
+            for (int i = 0; i < nodesCount; i++)
+            {
+                if (!reachableNodes[nodes[i]->id]) DrawRectangleRec(nodes[i]->shape, Fade(BLACK, 0.4f));
+            }
+        }
+
     End2dMode();
     
     EndShaderMode();
@@ -1740,7 +7375,14 @@ void DrawVisor()
 
         Begin3dMode(camera3d);
 
-            DrawModelEx(model, (Vector3){ 0.0f, -1.0f, 0.0f }, (Vector3){ 0, 1, 0 }, modelRotation, (Vector3){ VISOR_MODEL_SCALE, VISOR_MODEL_SCALE, VISOR_MODEL_SCALE }, RED);
+            // Instanced shaders are previewed with a stress scene of default model instances
+            if (instancedShader && (model.mesh.vaoId > 0)) DrawInstances();
+            else
+            {
+                // Model material maps only bind 2D textures
+                if (packUniform != -1) BindPackTexture();
+                DrawModelEx(model, (Vector3){ 0.0f, -1.0f, 0.0f }, (Vector3){ 0, 1, 0 }, modelRotation, (Vector3){ VISOR_MODEL_SCALE, VISOR_MODEL_SCALE, VISOR_MODEL_SCALE }, RED);
+            }
 
         End3dMode();
         
@@ -1767,6 +7409,59 @@ void DrawVisor()
     EndShaderMode();
 }
 
+// Draws visor stress scene default model instances with current instanced shader
+void DrawInstances()
+{
+    // Instanced vertex shader transforms vertices by the camera view projection matrix and its instance transform
+    double top = 0.01*tan(camera3d.fovy*0.5*DEG2RAD);
+    double right = top*GetScreenWidth()/GetScreenHeight();
+    Matrix viewProjection = FMatrixMultiply(GetCameraMatrix(camera3d), FMatrixFrustum(-right, right, -top, top, 0.01, 1000.0));
+
+    SetShaderValueMatrix(shader, mvpUniform, viewProjection);
+    glUseProgram(shader.id);
+
+    for (int i = 0; i < MAX_TEXTURES; i++)
+    {
+        if (samplerUniforms[i] != -1)
+        {
+            // Packed textures unit samples their atlas or texture array
+            glActiveTexture(GL_TEXTURE0 + i);
+            if (i == packUnit) glBindTexture(((packedMode == PACKING_ARRAY) ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D), packTexture.id);
+            else glBindTexture(GL_TEXTURE_2D, textures[i].id);
+            glUniform1i(samplerUniforms[i], i);
+        }
+    }
+
+    // Meshes without vertex colors are drawn white like raylib models drawing
+    if (model.mesh.colors == NULL) glVertexAttrib4f(3, 1.0f, 1.0f, 1.0f, 1.0f);
+
+    glBindVertexArray(model.mesh.vaoId);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+    // Instance transform columns, color tint and properties attributes advance once per instance
+    for (int i = 0; i < 5 + instanceNodesCount; i++)
+    {
+        int size = ((i < 5) ? 4 : nodes[GetNodeIndex(instanceNodes[i - 5])]->output.dataCount);
+
+        glEnableVertexAttribArray(INSTANCE_LOCATION + i);
+        glVertexAttribPointer(INSTANCE_LOCATION + i, size, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE*sizeof(float), (void *)(i*4*sizeof(float)));
+        glVertexAttribDivisor(INSTANCE_LOCATION + i, 1);
+    }
+
+    if (model.mesh.indices != NULL) glDrawElementsInstanced(GL_TRIANGLES, model.mesh.triangleCount*3, GL_UNSIGNED_SHORT, 0, INSTANCE_GRID*INSTANCE_GRID);
+    else glDrawArraysInstanced(GL_TRIANGLES, 0, model.mesh.vertexCount, INSTANCE_GRID*INSTANCE_GRID);
+
+    for (int i = 0; i < 5 + instanceNodesCount; i++)
+    {
+        glVertexAttribDivisor(INSTANCE_LOCATION + i, 0);
+        glDisableVertexAttribArray(INSTANCE_LOCATION + i);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
 // Draw interface to create nodes
 void DrawInterface()
 {
@@ -1798,6 +7493,7 @@ void DrawInterface()
     if (FButton((Rectangle){ UI_PADDING + ((screenSize.x - canvasSize.x - UI_PADDING*2)/2 + UI_PADDING)*menuOffset, screenSize.y - (UI_BUTTON_HEIGHT + UI_PADDING), (screenSize.x - canvasSize.x - UI_PADDING*2)/2, UI_BUTTON_HEIGHT }, "Clear Graph")) ClearGraph();
     if (FButton((Rectangle){ UI_PADDING + ((screenSize.x - canvasSize.x - UI_PADDING*2)/2 + UI_PADDING)*menuOffset, screenSize.y - (UI_BUTTON_HEIGHT + UI_PADDING), (screenSize.x - canvasSize.x - UI_PADDING*2)/2, UI_BUTTON_HEIGHT }, "Align Nodes")) AlignAllNodes();
     if (FButton((Rectangle){ UI_PADDING + ((screenSize.x - canvasSize.x - UI_PADDING*2)/2 + UI_PADDING)*menuOffset, screenSize.y - (UI_BUTTON_HEIGHT + UI_PADDING), (screenSize.x - canvasSize.x - UI_PADDING*2)/2, UI_BUTTON_HEIGHT }, "Clear Unused")) ClearUnusedNodes();
+    if (FButton((Rectangle){ UI_PADDING + ((screenSize.x - canvasSize.x - UI_PADDING*2)/2 + UI_PADDING)*menuOffset, screenSize.y - (UI_BUTTON_HEIGHT + UI_PADDING), (screenSize.x - canvasSize.x - UI_PADDING*2)/2, UI_BUTTON_HEIGHT }, "Merge Duplicates")) MergeDuplicatedNodes();
     if (FButton((Rectangle){ UI_PADDING + ((screenSize.x - canvasSize.x - UI_PADDING*2)/2 + UI_PADDING)*menuOffset, screenSize.y - (UI_BUTTON_HEIGHT + UI_PADDING), (screenSize.x - canvasSize.x - UI_PADDING*2)/2, UI_BUTTON_HEIGHT }, "Settings"))
     {
         settings = true;
@@ -1814,8 +7510,26 @@ void DrawInterface()
 
     DrawText("Properties", canvasSize.x + ((screenSize.x - canvasSize.x) - MeasureText("Properties", 10))/2 - UI_PADDING_SCROLL/2, UI_PADDING*4 + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, 10, WHITE); menuOffset++;
     if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Value")) CreateNodeProperty(FNODE_VALUE, "Value", 1, 0);
+    if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Static Value"))
+    {
+        FNode node = CreateNodeProperty(FNODE_VALUE, "Static Value", 1, 0);
+        node->staticProperty = true;
+    }
     if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Color")) CreateNodeProperty(FNODE_VECTOR4, "Color", 4, 0);
+    if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Instance Value"))
+    {
+        FNode node = CreateNodeProperty(FNODE_VALUE, "Instance Value", 1, 0);
+        node->instanceProperty = true;
+    }
+    if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Instance Color"))
+    {
+        FNode node = CreateNodeProperty(FNODE_VECTOR4, "Instance Color", 4, 0);
+        node->instanceProperty = true;
+    }
     if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Sampler 2D")) CreateNodeProperty(FNODE_SAMPLER2D, "Sampler 2D", 4, 2);
+    if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Sampler 2D LOD")) CreateNodeProperty(FNODE_SAMPLERLOD, "Sampler 2D LOD", 4, 3);
+    if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Sampler 2D Bias")) CreateNodeProperty(FNODE_SAMPLERBIAS, "Sampler 2D Bias", 4, 3);
+    if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Sampler 2D Grad")) CreateNodeProperty(FNODE_SAMPLERGRAD, "Sampler 2D Grad", 4, 4);
     
     DrawText("Arithmetic", canvasSize.x + ((screenSize.x - canvasSize.x) - MeasureText("Arithmetic", 10))/2 - UI_PADDING_SCROLL/2, UI_PADDING*4 + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, 10, WHITE); menuOffset++;
     if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Add")) CreateNodeOperator(FNODE_ADD, "Add", MAX_INPUTS);
@@ -1874,6 +7588,17 @@ void DrawInterface()
     if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Deg to Rad")) CreateNodeOperator(FNODE_DEG2RAD, "Deg to Rad", 1);
     if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Rad to Deg")) CreateNodeOperator(FNODE_RAD2DEG, "Rad to Deg", 1);
 
+    DrawText("Optimization", canvasSize.x + ((screenSize.x - canvasSize.x) - MeasureText("Optimization", 10))/2 - UI_PADDING_SCROLL/2, UI_PADDING*4 + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, 10, WHITE); menuOffset++;
+    if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Bake to LUT")) CreateNodeOperator(FNODE_LUT, "Bake to LUT", 4);
+    if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "LOD Optional")) CreateNodeOperator(FNODE_OPTIONAL, "LOD Optional", 2);
+
+    DrawText("Functions", canvasSize.x + ((screenSize.x - canvasSize.x) - MeasureText("Functions", 10))/2 - UI_PADDING_SCROLL/2, UI_PADDING*4 + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, 10, WHITE); menuOffset++;
+    if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, "Collapse Selected")) CollapseFunction();
+    for (int i = 0; i < functionsCount; i++)
+    {
+        if (FButton((Rectangle){ canvasSize.x + UI_PADDING, UI_PADDING + (UI_BUTTON_HEIGHT + UI_PADDING)*menuOffset - menuScroll, screenSize.x - canvasSize.x - UI_PADDING*2 - UI_PADDING_SCROLL, UI_BUTTON_HEIGHT }, functions[i]->name)) CreateNodeFunction(i);
+    }
+
     DrawRectangle(menuScrollRec.x - 3, 2, menuScrollRec.width + 6, screenSize.y - 4, (Color){ UI_BORDER_DEFAULT_COLOR, UI_BORDER_DEFAULT_COLOR, UI_BORDER_DEFAULT_COLOR, 255 });
     DrawRectangle(menuScrollRec.x - 2, menuScrollRec.y - 2, menuScrollRec.width + 4, menuScrollRec.height + 4, DARKGRAY);
     DrawRectangleRec(menuScrollRec, ((scrollState == 1) ? LIGHTGRAY : RAYWHITE));
@@ -1883,36 +7608,136 @@ void DrawInterface()
         DrawRectangle(0, 0, screenSize.x, screenSize.y, (Color){ 0, 0, 0, 100 });
 
         #define     SETTINGS_WIDTH      300
-        #define     SETTINGS_HEIGHT     175
+        #define     SETTINGS_HEIGHT     455
 
         DrawRectangle((canvasSize.x - SETTINGS_WIDTH)/2, (canvasSize.y - SETTINGS_HEIGHT)/2, SETTINGS_WIDTH, SETTINGS_HEIGHT, LIGHTGRAY);
         DrawRectangleLines((canvasSize.x - SETTINGS_WIDTH)/2, (canvasSize.y - SETTINGS_HEIGHT)/2, SETTINGS_WIDTH, SETTINGS_HEIGHT, BLACK);
 
         DrawText("Settings", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 15, 20, BLACK);
         DrawText("Shader version", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 50, 10, BLACK);
-        DrawText(((version == 0) ? "GLSL 330" : "GLSL 100"), (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/1.9f + MeasureText(((version == 0) ? "GLSL 330" : "GLSL 100"), 10)/2, (canvasSize.y - SETTINGS_HEIGHT)/2 + 50, 10, BLACK);
+        const char *versionNames[4] = { "GLSL 330", "GLSL 100", "GLSL 430", "GLSL ES 300" };
+        DrawText(versionNames[version], (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/1.9f + MeasureText(versionNames[version], 10)/2, (canvasSize.y - SETTINGS_HEIGHT)/2 + 50, 10, BLACK);
 
         if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/2 - 20, (canvasSize.y - SETTINGS_HEIGHT)/2 + 45, 20, 20 }, "<"))
         {
-            version--; 
-            if (version < 0) version = 1;
+            if (version == GLSL_330) version = GLSL_300ES;
+            else version--;
         }
 
         if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH - 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + 45, 20, 20 }, ">"))
         {
             version++; 
-            if (version > 1) version = 0;
+            if (version > 3) version = 0;
+        }
+
+        DrawText("Compile mode", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 85, 10, BLACK);
+        DrawText(((compileMode == COMPILE_AUTHORING) ? "Authoring" : "Ship"), (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/1.9f + MeasureText(((compileMode == COMPILE_AUTHORING) ? "Authoring" : "Ship"), 10)/2, (canvasSize.y - SETTINGS_HEIGHT)/2 + 85, 10, BLACK);
+
+        if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/2 - 20, (canvasSize.y - SETTINGS_HEIGHT)/2 + 80, 20, 20 }, "<"))
+        {
+            compileMode = ((compileMode == COMPILE_AUTHORING) ? COMPILE_SHIP : COMPILE_AUTHORING);
+        }
+
+        if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH - 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + 80, 20, 20 }, ">"))
+        {
+            compileMode = ((compileMode == COMPILE_AUTHORING) ? COMPILE_SHIP : COMPILE_AUTHORING);
+        }
+
+        const char *precisionNames[4] = { "Auto", "Force lowp", "Force mediump", "Force highp" };
+        DrawText("Precision (GLSL ES)", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 120, 10, BLACK);
+        DrawText(precisionNames[precisionMode], (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/1.9f + MeasureText(precisionNames[precisionMode], 10)/2, (canvasSize.y - SETTINGS_HEIGHT)/2 + 120, 10, BLACK);
+
+        if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/2 - 20, (canvasSize.y - SETTINGS_HEIGHT)/2 + 115, 20, 20 }, "<"))
+        {
+            if (precisionMode == PRECISION_AUTO) precisionMode = PRECISION_HIGHP;
+            else precisionMode--;
+        }
+
+        if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH - 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + 115, 20, 20 }, ">"))
+        {
+            precisionMode++; 
+            if (precisionMode > 3) precisionMode = 0;
         }
 
-        if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/2 - 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + SETTINGS_HEIGHT/2 + 45, 80, 25 }, "Close"))
+        if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/2 - 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + SETTINGS_HEIGHT - 40, 80, 25 }, "Close"))
         {
             settings = false;
             interact = true;
         }
         
-        DrawText("Backface Culling", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 85, 10, BLACK);
+        DrawText("Backface Culling", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 155, 10, BLACK);
         
-        backfaceCulling = FToggle((Rectangle){ canvasSize.x/2 + 40, canvasSize.y/2 - 7, 20, 20 }, backfaceCulling);
+        bool culling = FToggle((Rectangle){ canvasSize.x/2 + 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + 150, 20, 20 }, backfaceCulling);
+        if (culling != backfaceCulling)
+        {
+            backfaceCulling = culling;
+            if (backfaceCulling) glEnable(GL_CULL_FACE);
+            else glDisable(GL_CULL_FACE);
+        }
+
+        DrawText("Cost heatmap", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 190, 10, BLACK);
+
+        costHeatmap = FToggle((Rectangle){ canvasSize.x/2 + 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + 185, 20, 20 }, costHeatmap);
+
+        DrawText("Highlight unused", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 225, 10, BLACK);
+
+        unusedHighlight = FToggle((Rectangle){ canvasSize.x/2 + 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + 220, 20, 20 }, unusedHighlight);
+
+        DrawText("Visor LOD", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 260, 10, BLACK);
+        DrawText(FormatText("LOD%i", previewLod), (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/1.9f + MeasureText(FormatText("LOD%i", previewLod), 10)/2, (canvasSize.y - SETTINGS_HEIGHT)/2 + 260, 10, BLACK);
+
+        // Visor variant is compiled last so its compile state is kept for uniforms update
+        if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/2 - 20, (canvasSize.y - SETTINGS_HEIGHT)/2 + 255, 20, 20 }, "<"))
+        {
+            previewLod--; 
+            if (previewLod < 0) previewLod = MAX_LODS - 1;
+            CompileShader();
+        }
+
+        if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH - 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + 255, 20, 20 }, ">"))
+        {
+            previewLod++; 
+            if (previewLod > (MAX_LODS - 1)) previewLod = 0;
+            CompileShader();
+        }
+
+        DrawText("Instancing (not GLSL 100)", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 295, 10, BLACK);
+
+        // Visor previews instanced shaders with a stress scene so the shader is compiled when instancing changes
+        bool instanced = FToggle((Rectangle){ canvasSize.x/2 + 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + 290, 20, 20 }, instancing);
+        if (instanced != instancing)
+        {
+            instancing = instanced;
+            CompileShader();
+        }
+
+        DrawText("Uniform blocks (not GLSL 100)", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 330, 10, BLACK);
+
+        bool blocks = FToggle((Rectangle){ canvasSize.x/2 + 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + 325, 20, 20 }, uniformBlocks);
+        if (blocks != uniformBlocks)
+        {
+            uniformBlocks = blocks;
+            CompileShader();
+        }
+
+        const char *packingNames[3] = { "None", "Atlas", "Texture array" };
+        DrawText("Pack dropped textures", (canvasSize.x - SETTINGS_WIDTH)/2 + 15, (canvasSize.y - SETTINGS_HEIGHT)/2 + 365, 10, BLACK);
+        DrawText(packingNames[texturePacking], (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/1.9f + MeasureText(packingNames[texturePacking], 10)/2, (canvasSize.y - SETTINGS_HEIGHT)/2 + 365, 10, BLACK);
+
+        // Packed textures change samplers code so the shader is compiled when packing changes
+        if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH/2 - 20, (canvasSize.y - SETTINGS_HEIGHT)/2 + 360, 20, 20 }, "<"))
+        {
+            if (texturePacking == PACKING_NONE) texturePacking = PACKING_ARRAY;
+            else texturePacking--;
+            CompileShader();
+        }
+
+        if (FButton((Rectangle){ (canvasSize.x - SETTINGS_WIDTH)/2 + SETTINGS_WIDTH - 40, (canvasSize.y - SETTINGS_HEIGHT)/2 + 360, 20, 20 }, ">"))
+        {
+            texturePacking++; 
+            if (texturePacking > PACKING_ARRAY) texturePacking = PACKING_NONE;
+            CompileShader();
+        }
     }
 
     if (compileState >= 0)
@@ -1920,6 +7745,14 @@ void DrawInterface()
         Rectangle compileRec = { UI_PADDING, screenSize.y - (UI_BUTTON_HEIGHT + UI_PADDING), (screenSize.x - canvasSize.x - UI_PADDING*2)/2, UI_BUTTON_HEIGHT };
         DrawRectangleRec(compileRec, ((compileState == 1) ? Fade(GREEN, 0.5f) : Fade(RED, 0.5f)));
     }
+
+    // Draw current shader stages cost above compile button
+    if ((GetCostTotal(vertexCost) + GetCostTotal(fragmentCost)) > 0)
+    {
+        DrawText(FormatText("LOD%i vertex cost: %i", previewLod, GetCostTotal(vertexCost)), UI_PADDING, screenSize.y - (UI_BUTTON_HEIGHT + UI_PADDING) - 30, 10, DARKGRAY);
+        DrawText(FormatText("LOD%i fragment cost: %i (%i alu, %i transcendental, %i texture, %i discard)", previewLod, GetCostTotal(fragmentCost), fragmentCost.alu, fragmentCost.transcendental, fragmentCost.texture, fragmentCost.discard),
+        UI_PADDING, screenSize.y - (UI_BUTTON_HEIGHT + UI_PADDING) - 15, 10, DARKGRAY);
+    }
 }
 
 // Returns the extension of a file
@@ -1945,12 +7778,57 @@ bool CheckTextureExtension(char *filename)
 //----------------------------------------------------------------------------------
 // Program
 //----------------------------------------------------------------------------------
-int main()
+int main(int argc, char *argv[])
 {
+    // Command line arguments: -compile [graph.fnode ...] [-target glsl330|glsl100|glsl430|glsl300es] [-ship] [-instancing] [-uniform-blocks] [-pack atlas|array] [-vertex-budget N] [-fragment-budget N] [-lod1-budget N] [-lod2-budget N]
+    //--------------------------------------------------------------------------------------
+    bool compileOnly = false;
+    const char *graphPaths[MAX_BATCH_GRAPHS] = { DATA_PATH };
+    int graphsCount = 0;
+    int vertexBudget = -1;
+    int fragmentBudget = -1;
+    const char *versionTargets[4] = { "glsl330", "glsl100", "glsl430", "glsl300es" };
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-compile") == 0) compileOnly = true;
+        else if ((strcmp(argv[i], "-target") == 0) && ((i + 1) < argc))
+        {
+            i++;
+            int target = -1;
+            for (int k = 0; k < 4; k++)
+            {
+                if (strcmp(argv[i], versionTargets[k]) == 0) target = k;
+            }
+
+            if (target != -1) version = target;
+            else TraceLogFNode(true, "unknown build target %s (glsl330, glsl100, glsl430 or glsl300es)", argv[i]);
+        }
+        else if (strcmp(argv[i], "-ship") == 0) compileMode = COMPILE_SHIP;
+        else if (strcmp(argv[i], "-instancing") == 0) instancing = true;
+        else if (strcmp(argv[i], "-uniform-blocks") == 0) uniformBlocks = true;
+        else if ((strcmp(argv[i], "-pack") == 0) && ((i + 1) < argc))
+        {
+            i++;
+            if (strcmp(argv[i], "atlas") == 0) texturePacking = PACKING_ATLAS;
+            else if (strcmp(argv[i], "array") == 0) texturePacking = PACKING_ARRAY;
+            else TraceLogFNode(true, "unknown texture packing %s (atlas or array)", argv[i]);
+        }
+        else if ((strcmp(argv[i], "-vertex-budget") == 0) && ((i + 1) < argc)) vertexBudget = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-fragment-budget") == 0) && ((i + 1) < argc)) fragmentBudget = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-lod1-budget") == 0) && ((i + 1) < argc)) lodBudgets[1] = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "-lod2-budget") == 0) && ((i + 1) < argc)) lodBudgets[2] = atoi(argv[++i]);
+        else if (argv[i][0] == '-') TraceLogFNode(true, "unknown or incomplete command line argument %s", argv[i]);
+        else if (graphsCount < MAX_BATCH_GRAPHS) graphPaths[graphsCount++] = argv[i];
+        else TraceLogFNode(true, "shader graph %s exceeds max batch compile graphs", argv[i]);
+    }
+    //--------------------------------------------------------------------------------------
+
     // Initialization
     //--------------------------------------------------------------------------------------
     SetConfigFlags(FLAG_MSAA_4X_HINT | FLAG_VSYNC_HINT);
     InitWindow(screenSize.x, screenSize.y, "FNode - Visual scripting shader editor");
+
     Image icon = LoadImage(WINDOW_ICON);
     SetWindowIcon(icon);
     iconTex = LoadTexture(WINDOW_ICON);
@@ -1970,11 +7848,39 @@ int main()
     camera3d = (Camera){{ 4.0f, 2.0f, 4.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, 45.0f };
     SetCameraMode(camera3d, CAMERA_FREE);
     menuScrollRec = (Rectangle){ screenSize.x - 17, 5, 9, 30 };
+    for (int i = 0; i < MAX_TEXTURES; i++) lutOwners[i] = -1;
 
     // Initialize shaders values
     fxaaUniform = GetShaderLocation(fxaa, FXAA_SCREENSIZE_UNIFORM);
 
     InitFNode();
+    LoadFunctions();
+
+    // Compile a shader graph without entering editor loop and check its stages cost budgets (several graphs are compiled into shared programs)
+    if (compileOnly)
+    {
+        if (graphsCount > 1) CompileBatch(graphPaths, graphsCount, vertexBudget, fragmentBudget);
+        else
+        {
+            if (!LoadGraph(graphPaths[0]) || (nodesCount < 2)) TraceLogFNode(true, "error when trying to load shader graph %s", graphPaths[0]);
+            LoadPackLayout(graphPaths[0]);
+
+            // Editor GL context only loads GLSL 330 shaders, other targets are cross compiled without a load check
+            CompileShader();
+            if ((version == GLSL_330) && (model.material.shader.id == GetShaderDefault().id)) TraceLogFNode(true, "compiled shader %s failed to load", graphPaths[0]);
+
+            if ((vertexBudget >= 0) && (GetCostTotal(vertexCost) > vertexBudget)) TraceLogFNode(true, "vertex shader cost %i exceeds budget %i", GetCostTotal(vertexCost), vertexBudget);
+            if ((fragmentBudget >= 0) && (GetCostTotal(fragmentCost) > fragmentBudget)) TraceLogFNode(true, "fragment shader cost %i exceeds budget %i", GetCostTotal(fragmentCost), fragmentBudget);
+        }
+
+        for (int i = 0; i < permutationsCount; i++) ClearPermutation(i);
+
+        CloseFNode();
+        CloseWindow();
+
+        return 0;
+    }
+
     CheckPreviousShader(true);
     UpdateCamera(&camera3d);
 
@@ -2032,6 +7938,11 @@ int main()
     UnloadShader(fxaa);
     if (loadedShader) UnloadShader(shader);
     for (int i = 0; i < MAX_TEXTURES; i++) UnloadTexture(textures[i]);
+    if (packTexture.id != 0) UnloadTexture(packTexture);
+    for (int i = 0; i < permutationsCount; i++) ClearPermutation(i);
+    if (instanceBuffer != 0) glDeleteBuffers(1, &instanceBuffer);
+    if (frameBuffer != 0) glDeleteBuffers(1, &frameBuffer);
+    if (materialBuffer != 0) glDeleteBuffers(1, &materialBuffer);
 
     CloseFNode();
     CloseWindow();        // Close window and OpenGL context